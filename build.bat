@@ -108,6 +108,20 @@ if "%MSBUILD%"=="" (
 echo Found MSBuild: %MSBUILD%
 echo.
 
+REM Recompile shaders from source so the checked-in SPIR-V matches its GLSL
+set "HAVE_GLSLC="
+if defined VULKAN_SDK if exist "%VULKAN_SDK%\Bin\glslc.exe" set "HAVE_GLSLC=1"
+where glslc.exe >nul 2>&1
+if !ERRORLEVEL! EQU 0 set "HAVE_GLSLC=1"
+if defined HAVE_GLSLC (
+    echo Compiling shaders...
+    call "%~dp0build_shaders.bat"
+    if !ERRORLEVEL! NEQ 0 exit /b !ERRORLEVEL!
+) else (
+    echo [NOTE] glslc.exe not found. Using checked-in SPIR-V in src\renderer\shaders\compiled.
+)
+echo.
+
 REM Build the solution
 echo Building...
 "%MSBUILD%" QUICKEN.sln /p:Configuration=%CONFIG% /p:Platform=x64 /m /v:minimal /nologo
@@ -120,6 +134,8 @@ if %ERRORLEVEL% EQU 0 (
     echo.
     echo Client:    build\bin\%CONFIG%-windows-x86_64\quicken.exe
     echo Server:    build\bin\%CONFIG%-windows-x86_64\quicken-server.exe
+    echo Relay:     build\bin\%CONFIG%-windows-x86_64\quicken-relay.exe
+    echo Query:     build\bin\%CONFIG%-windows-x86_64\quicken-query.exe
     echo.
 ) else (
     echo.
@@ -54,6 +54,14 @@ else
     exit 1
 fi
 
+# Recompile shaders from source so the checked-in SPIR-V matches its GLSL
+if command -v glslc &> /dev/null; then
+    echo "Compiling shaders..."
+    bash ./build_shaders.sh
+else
+    echo "[NOTE] glslc not found. Using checked-in SPIR-V in src/renderer/shaders/compiled."
+fi
+
 # Build the project
 echo "Building..."
 make config=$CONFIG -j$(nproc)
@@ -66,6 +74,7 @@ if [ $? -eq 0 ]; then
     echo ""
     echo "Client: build/bin/$CONFIG-linux-x86_64/quicken"
     echo "Server: build/bin/$CONFIG-linux-x86_64/quicken-server"
+    echo "Relay:  build/bin/$CONFIG-linux-x86_64/quicken-relay"
     echo ""
 else
     echo ""
@@ -0,0 +1,69 @@
+@echo off
+REM QUICKEN Engine Shader Build Script (Windows)
+REM Compiles every GLSL shader in src\renderer\shaders to SPIR-V in
+REM src\renderer\shaders\compiled. The .spv files are checked in, so
+REM commit whatever this changes.
+REM
+REM Usage: build_shaders.bat           Compile into compiled\
+REM        build_shaders.bat --check   Compile to a temp dir and fail if any
+REM                                    checked-in .spv differs from its source
+REM
+REM Needs glslc from the Vulkan SDK (VULKAN_SDK set, or glslc.exe in PATH).
+
+setlocal enabledelayedexpansion
+
+cd /d "%~dp0"
+
+set "SHADER_DIR=src\renderer\shaders"
+set "OUT_DIR=%SHADER_DIR%\compiled"
+set "GLSLC_FLAGS=-O --target-env=vulkan1.2"
+
+set "GLSLC="
+if defined VULKAN_SDK if exist "%VULKAN_SDK%\Bin\glslc.exe" set "GLSLC=%VULKAN_SDK%\Bin\glslc.exe"
+if "%GLSLC%"=="" (
+    where glslc.exe >nul 2>&1
+    if !ERRORLEVEL! EQU 0 set "GLSLC=glslc.exe"
+)
+if "%GLSLC%"=="" (
+    echo [ERROR] glslc.exe not found!
+    echo Install the Vulkan SDK and set VULKAN_SDK, or add glslc.exe to your PATH.
+    exit /b 1
+)
+
+set CHECK=0
+set "BUILD_DIR=%OUT_DIR%"
+if "%1"=="--check" (
+    set CHECK=1
+    set "BUILD_DIR=%TEMP%\quicken_shader_check"
+    if exist "!BUILD_DIR!" rmdir /s /q "!BUILD_DIR!"
+)
+if not exist "%BUILD_DIR%" mkdir "%BUILD_DIR%"
+
+set COUNT=0
+set STALE=0
+for %%F in ("%SHADER_DIR%\*.vert" "%SHADER_DIR%\*.frag" "%SHADER_DIR%\*.comp") do (
+    echo   %%~nxF
+    "%GLSLC%" %GLSLC_FLAGS% "%%F" -o "!BUILD_DIR!\%%~nxF.spv"
+    if !ERRORLEVEL! NEQ 0 exit /b !ERRORLEVEL!
+    if !CHECK! EQU 1 (
+        fc /b "!BUILD_DIR!\%%~nxF.spv" "%OUT_DIR%\%%~nxF.spv" >nul 2>&1
+        if !ERRORLEVEL! NEQ 0 (
+            echo   [STALE] %OUT_DIR%\%%~nxF.spv does not match %%F
+            set /a STALE+=1
+        )
+    )
+    set /a COUNT+=1
+)
+
+if %CHECK% EQU 1 (
+    rmdir /s /q "%BUILD_DIR%"
+    if !STALE! GTR 0 (
+        echo [ERROR] !STALE! of %COUNT% shaders differ from their source. Run build_shaders.bat and commit.
+        exit /b 1
+    )
+    echo All %COUNT% checked-in shaders match their source
+) else (
+    echo Compiled %COUNT% shaders to %OUT_DIR%
+)
+
+endlocal
@@ -0,0 +1,59 @@
+#!/bin/bash
+# QUICKEN Engine Shader Build Script (Linux)
+# Compiles every GLSL shader in src/renderer/shaders to SPIR-V in
+# src/renderer/shaders/compiled. The .spv files are checked in, so
+# commit whatever this changes.
+#
+# Usage: ./build_shaders.sh           Compile into compiled/
+#        ./build_shaders.sh --check   Compile to a temp dir and fail if any
+#                                     checked-in .spv differs from its source
+#
+# Needs glslc (Vulkan SDK, or the shaderc package).
+
+set -e
+
+cd "$(dirname "$0")"
+
+SHADER_DIR="src/renderer/shaders"
+OUT_DIR="$SHADER_DIR/compiled"
+GLSLC_FLAGS="-O --target-env=vulkan1.2"
+
+if ! command -v glslc &> /dev/null; then
+    echo "[ERROR] glslc not found!"
+    echo "Install the Vulkan SDK (or: sudo apt-get install glslc) and add it to your PATH."
+    exit 1
+fi
+
+CHECK=0
+if [ "$1" = "--check" ]; then
+    CHECK=1
+    BUILD_DIR=$(mktemp -d)
+    trap 'rm -rf "$BUILD_DIR"' EXIT
+else
+    BUILD_DIR="$OUT_DIR"
+    mkdir -p "$OUT_DIR"
+fi
+
+count=0
+stale=0
+for src in "$SHADER_DIR"/*.vert "$SHADER_DIR"/*.frag "$SHADER_DIR"/*.comp; do
+    [ -f "$src" ] || continue
+    name=$(basename "$src")
+    echo "  $name"
+    glslc $GLSLC_FLAGS "$src" -o "$BUILD_DIR/$name.spv"
+    if [ $CHECK -eq 1 ] && ! cmp -s "$BUILD_DIR/$name.spv" "$OUT_DIR/$name.spv"; then
+        echo "  [STALE] $OUT_DIR/$name.spv does not match $src"
+        stale=$((stale + 1))
+    fi
+    count=$((count + 1))
+done
+
+if [ $CHECK -eq 1 ]; then
+    if [ $stale -gt 0 ]; then
+        echo "[ERROR] $stale of $count shaders differ from their source. Run ./build_shaders.sh and commit."
+        exit 1
+    fi
+    echo "All $count checked-in shaders match their source"
+else
+    echo "Compiled $count shaders to $OUT_DIR"
+fi
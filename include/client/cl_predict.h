@@ -29,6 +29,15 @@ void cl_predict_reconcile(qk_phys_world_t *world);
 /* Predicted player state (NULL if no prediction yet). */
 const qk_player_state_t *cl_predict_get_state(void);
 
+/* Camera / player position for this frame: predicted origin extrapolated
+ * through the partial tick plus the decaying correction offset. */
+vec3_t cl_predict_get_render_origin(void);
+
+/* Correction smoothing. half_life: seconds for the offset to halve
+ * (0 = show corrections at once). Corrections longer than snap_dist
+ * units, and teleports, are never smoothed. */
+void cl_predict_set_error_smoothing(f32 half_life, f32 snap_dist);
+
 /* Mutable access (for restoring gameplay state on map load). */
 qk_player_state_t *cl_predict_get_state_mut(void);
 
@@ -0,0 +1,111 @@
+/*
+ * QUICKEN Engine - Atomics
+ *
+ * Minimal atomic integer ops over compiler intrinsics (MSVC Interlocked*,
+ * GCC/Clang __atomic builtins). MSVC's C11 <stdatomic.h> is still
+ * experimental, so everything lock-free in the engine goes through here.
+ *
+ * Loads are acquire, stores are release, read-modify-write ops are
+ * sequentially consistent. The _relaxed variants carry no ordering.
+ */
+
+#ifndef QK_ATOMIC_H
+#define QK_ATOMIC_H
+
+#include "quicken.h"
+
+typedef struct { volatile i32 value; } qk_atomic_i32_t;
+typedef struct { volatile i64 value; } qk_atomic_i64_t;
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+// x64 is TSO: plain aligned loads/stores already have acquire/release
+// semantics at the hardware level, only the compiler needs fencing.
+#define QK_COMPILER_BARRIER() _ReadWriteBarrier()
+
+static inline i32 qk_atomic_load_i32(const qk_atomic_i32_t *a) {
+    i32 v = a->value; QK_COMPILER_BARRIER(); return v;
+}
+static inline void qk_atomic_store_i32(qk_atomic_i32_t *a, i32 v) {
+    QK_COMPILER_BARRIER(); a->value = v;
+}
+static inline i32 qk_atomic_add_i32(qk_atomic_i32_t *a, i32 v) {
+    return (i32)_InterlockedExchangeAdd((volatile long *)&a->value, (long)v);
+}
+static inline bool qk_atomic_cas_i32(qk_atomic_i32_t *a, i32 expected, i32 desired) {
+    return _InterlockedCompareExchange((volatile long *)&a->value,
+                                       (long)desired, (long)expected) == (long)expected;
+}
+static inline i32 qk_atomic_exchange_i32(qk_atomic_i32_t *a, i32 v) {
+    return (i32)_InterlockedExchange((volatile long *)&a->value, (long)v);
+}
+
+static inline i64 qk_atomic_load_i64(const qk_atomic_i64_t *a) {
+    i64 v = a->value; QK_COMPILER_BARRIER(); return v;
+}
+static inline void qk_atomic_store_i64(qk_atomic_i64_t *a, i64 v) {
+    QK_COMPILER_BARRIER(); a->value = v;
+}
+static inline i64 qk_atomic_load_relaxed_i64(const qk_atomic_i64_t *a) { return a->value; }
+static inline void qk_atomic_store_relaxed_i64(qk_atomic_i64_t *a, i64 v) { a->value = v; }
+static inline i64 qk_atomic_add_i64(qk_atomic_i64_t *a, i64 v) {
+    return _InterlockedExchangeAdd64(&a->value, v);
+}
+static inline bool qk_atomic_cas_i64(qk_atomic_i64_t *a, i64 expected, i64 desired) {
+    return _InterlockedCompareExchange64(&a->value, desired, expected) == expected;
+}
+
+static inline void qk_atomic_fence(void) { __faststorefence(); }
+static inline void qk_cpu_pause(void)    { _mm_pause(); }
+
+#else // GCC / Clang
+
+#include <emmintrin.h>
+
+#define QK_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static inline i32 qk_atomic_load_i32(const qk_atomic_i32_t *a) {
+    return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+}
+static inline void qk_atomic_store_i32(qk_atomic_i32_t *a, i32 v) {
+    __atomic_store_n(&a->value, v, __ATOMIC_RELEASE);
+}
+static inline i32 qk_atomic_add_i32(qk_atomic_i32_t *a, i32 v) {
+    return __atomic_fetch_add(&a->value, v, __ATOMIC_SEQ_CST);
+}
+static inline bool qk_atomic_cas_i32(qk_atomic_i32_t *a, i32 expected, i32 desired) {
+    return __atomic_compare_exchange_n(&a->value, &expected, desired, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+static inline i32 qk_atomic_exchange_i32(qk_atomic_i32_t *a, i32 v) {
+    return __atomic_exchange_n(&a->value, v, __ATOMIC_SEQ_CST);
+}
+
+static inline i64 qk_atomic_load_i64(const qk_atomic_i64_t *a) {
+    return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+}
+static inline void qk_atomic_store_i64(qk_atomic_i64_t *a, i64 v) {
+    __atomic_store_n(&a->value, v, __ATOMIC_RELEASE);
+}
+static inline i64 qk_atomic_load_relaxed_i64(const qk_atomic_i64_t *a) {
+    return __atomic_load_n(&a->value, __ATOMIC_RELAXED);
+}
+static inline void qk_atomic_store_relaxed_i64(qk_atomic_i64_t *a, i64 v) {
+    __atomic_store_n(&a->value, v, __ATOMIC_RELAXED);
+}
+static inline i64 qk_atomic_add_i64(qk_atomic_i64_t *a, i64 v) {
+    return __atomic_fetch_add(&a->value, v, __ATOMIC_SEQ_CST);
+}
+static inline bool qk_atomic_cas_i64(qk_atomic_i64_t *a, i64 expected, i64 desired) {
+    return __atomic_compare_exchange_n(&a->value, &expected, desired, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void qk_atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void qk_cpu_pause(void)    { _mm_pause(); }
+
+#endif
+
+#endif // QK_ATOMIC_H
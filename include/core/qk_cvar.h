@@ -3,6 +3,11 @@
  *
  * Typed cvars with range clamping, change callbacks, and flags.
  * Modules cache qk_cvar_t* at registration time for zero-overhead reads.
+ *
+ * Every real value change bumps cvar->generation, so hot code can detect
+ * changes with one integer compare (qk_cvar_changed). Callbacks do not
+ * fire inside setters: they are queued and run by qk_cvar_dispatch_callbacks
+ * at a safe point in the frame, once per changed cvar.
  */
 
 #ifndef QK_CVAR_H
@@ -28,10 +33,11 @@ enum {
 #define QK_CVAR_MAX_COUNT   512
 #define QK_CVAR_NAME_LEN    64
 #define QK_CVAR_STRING_LEN  256
+#define QK_CVAR_HASH_SIZE   1024    // power of two, >= 2 * QK_CVAR_MAX_COUNT
 
 typedef struct qk_cvar qk_cvar_t;
 
-// Callback: called after value changes, receives the cvar that changed
+// Callback: called (deferred) after value changes, receives the cvar that changed
 typedef void (*qk_cvar_callback_t)(qk_cvar_t *cvar);
 
 struct qk_cvar {
@@ -44,6 +50,8 @@ struct qk_cvar {
     bool                has_range;
     qk_cvar_callback_t  callback;
     bool                in_use;
+    bool                callback_pending;
+    u32                 generation;     // bumped on every value change
 };
 
 // --- Lifecycle ---
@@ -64,11 +72,26 @@ qk_cvar_t *qk_cvar_register_bool(const char *name, bool default_val,
 qk_cvar_t *qk_cvar_register_string(const char *name, const char *default_val,
                                      u32 flags, qk_cvar_callback_t cb);
 
-// --- Lookup ---
+// --- Lookup (hashed) ---
 
 qk_cvar_t *qk_cvar_find(const char *name);
 
-// --- Setters (with clamping + callback) ---
+// --- Change tracking ---
+
+// True if cvar changed since *last_seen was recorded; updates *last_seen.
+static inline bool qk_cvar_changed(const qk_cvar_t *cvar, u32 *last_seen) {
+    if (cvar->generation == *last_seen) return false;
+    *last_seen = cvar->generation;
+    return true;
+}
+
+// Bumped whenever any cvar changes
+u32  qk_cvar_global_generation(void);
+
+// Run queued change callbacks. Call once per frame from the main loop.
+void qk_cvar_dispatch_callbacks(void);
+
+// --- Setters (with clamping; queue callback on change) ---
 
 bool qk_cvar_set_float(qk_cvar_t *cvar, f32 value);
 bool qk_cvar_set_int(qk_cvar_t *cvar, i32 value);
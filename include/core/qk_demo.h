@@ -18,7 +18,7 @@ struct qk_ca_state;
 
 // Demo file magic and version
 #define QK_DEMO_MAGIC           0x4D444B51  // 'QKDM'
-#define QK_DEMO_VERSION         1
+#define QK_DEMO_VERSION         2
 #define QK_DEMO_MAP_NAME_LEN    28
 
 // Record types
@@ -0,0 +1,35 @@
+/*
+ * QUICKEN Engine - String / Byte Hashing
+ *
+ * FNV-1a, 32-bit. Used for name lookup tables (cvars, console commands),
+ * not for anything adversarial.
+ */
+
+#ifndef QK_HASH_H
+#define QK_HASH_H
+
+#include "quicken.h"
+
+#define QK_FNV1A_OFFSET 2166136261u
+#define QK_FNV1A_PRIME  16777619u
+
+static inline u32 qk_hash_str(const char *s) {
+    u32 h = QK_FNV1A_OFFSET;
+    while (*s) {
+        h ^= (u8)*s++;
+        h *= QK_FNV1A_PRIME;
+    }
+    return h;
+}
+
+static inline u32 qk_hash_bytes(const void *data, size_t size) {
+    const u8 *p = (const u8 *)data;
+    u32 h = QK_FNV1A_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= QK_FNV1A_PRIME;
+    }
+    return h;
+}
+
+#endif // QK_HASH_H
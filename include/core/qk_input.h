@@ -17,10 +17,17 @@ typedef struct {
     bool    mouse_buttons[5];
     bool    quit_requested;
     bool    console_active;
+    u64     poll_time_ns;       // SDL_GetTicksNS() when polling finished
 } qk_input_state_t;
 
 void            qk_input_poll(qk_input_state_t *state);
-qk_usercmd_t   qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time);
+// tick_end_ns: wall-clock end of the tick this command covers (same clock as
+// poll_time_ns). Mouse motion and attack/jump presses timestamped before it
+// are consumed into this command (angles, sub-tick offsets); later ones wait
+// for the next tick.
+qk_usercmd_t   qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time,
+                                       u64 tick_end_ns);
+// Latest view angles, including motion not yet assigned to a tick (camera)
 f32             qk_input_get_pitch(void);
 f32             qk_input_get_yaw(void);
 void            qk_input_set_angles(f32 pitch, f32 yaw);
@@ -0,0 +1,69 @@
+/*
+ * QUICKEN Engine - Job System
+ *
+ * Fixed-size work-stealing scheduler shared by all modules. One worker
+ * thread per spare core, each owning a Chase-Lev deque: the owner pushes
+ * and pops at the bottom (LIFO, cache-warm), idle workers steal from the
+ * top. Dependencies are expressed with counters: submit against a counter,
+ * then qk_job_wait() on it. Waiting threads run other jobs instead of
+ * blocking, so nested submit/wait from inside a job is fine.
+ *
+ * The main thread is worker 0. If qk_job_init() has not been called (or
+ * is called from a thread that is not a worker), jobs run inline on the
+ * submitting thread, so callers never need a serial fallback path.
+ */
+
+#ifndef QK_JOB_H
+#define QK_JOB_H
+
+#include "quicken.h"
+#include "core/qk_atomic.h"
+
+#define QK_JOB_MAX_WORKERS 32   // including the main thread
+
+typedef void (*qk_job_fn_t)(void *data);
+typedef void (*qk_job_range_fn_t)(void *data, u32 begin, u32 end);
+
+// Completion counter. Zero-initialize, submit against it, wait on it.
+typedef struct {
+    qk_atomic_i32_t pending;
+} qk_job_counter_t;
+
+typedef enum {
+    QK_JOB_PIN_NONE = 0,    // let the OS schedule workers
+    QK_JOB_PIN_CORES,       // worker i -> logical core i (main thread untouched)
+} qk_job_pin_t;
+
+typedef struct {
+    u32             worker_count;   // threads incl. main; 0 = one per logical core
+    qk_job_pin_t    pin;
+    u64             stack_size;     // per worker thread; 0 = platform default
+} qk_job_config_t;
+
+qk_result_t qk_job_init(const qk_job_config_t *config);
+void        qk_job_shutdown(void);
+
+// Threads available to run jobs, including the caller (1 when not initialized)
+u32         qk_job_worker_count(void);
+
+// 0 on the main thread, 1..N-1 on workers, UINT32_MAX on foreign threads
+u32         qk_job_thread_index(void);
+
+// counter may be NULL for fire-and-forget
+void        qk_job_submit(qk_job_fn_t fn, void *data, qk_job_counter_t *counter);
+
+// Runs other jobs until counter reaches zero
+void        qk_job_wait(qk_job_counter_t *counter);
+bool        qk_job_is_done(const qk_job_counter_t *counter);
+
+/* Splits [0, count) into chunks of at least min_batch and blocks until all
+ * chunks have run. fn receives half-open [begin, end) ranges. */
+void        qk_job_parallel_for(u32 count, u32 min_batch,
+                                qk_job_range_fn_t fn, void *data);
+
+/* Pushes per-worker busy time and job counts into QK_PROF as zones
+ * "job_wN" and counters "job_wN_jobs". Call once per frame on the main
+ * thread before QK_PROF_FRAME_END. No-op without QK_PROFILE. */
+void        qk_job_prof_flush(void);
+
+#endif // QK_JOB_H
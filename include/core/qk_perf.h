@@ -17,6 +17,8 @@ void qk_perf_end_frame(f32 cpu_frame_ms, f32 gpu_frame_ms, f32 world_ms,
                         f32 compose_ms, u32 draw_calls, u32 tris,
                         u32 swapchain_w, u32 swapchain_h,
                         f32 fence_wait_ms, f32 acquire_ms);
+// Scratch arena high-water marks (bytes) for the frame being ended
+void qk_perf_set_scratch_usage(u64 frame_bytes, u64 tick_bytes);
 void qk_perf_set_enabled(bool enabled);
 void qk_perf_log_event(const char *fmt, ...);
 
@@ -2,6 +2,8 @@
  * QUICKEN Engine - Platform Abstraction
  *
  * Monotonic time, sleep. Thin wrappers over OS/SDL3 calls.
+ * Scheduling controls for dedicated servers: each returns false when the
+ * OS refuses (usually missing privileges) and leaves things as they were.
  */
 
 #ifndef QK_PLATFORM_H
@@ -12,4 +14,13 @@
 f64  qk_platform_time_now(void);    // monotonic time in seconds
 void qk_platform_sleep(u32 ms);
 
+// Calling thread only runs on `core` (logical CPU index)
+bool qk_platform_pin_thread(u32 core);
+// Calling thread gets realtime priority (Linux SCHED_FIFO 1..99, Windows
+// time-critical; priority ignored there). Needs CAP_SYS_NICE / rtprio.
+bool qk_platform_set_realtime(u32 priority);
+// Lock current and future pages in RAM (mlockall). Needs CAP_IPC_LOCK or
+// a large enough RLIMIT_MEMLOCK. Not available on Windows.
+bool qk_platform_lock_memory(void);
+
 #endif // QK_PLATFORM_H
@@ -23,6 +23,7 @@ void qk_prof_frame_begin(void);
 void qk_prof_frame_end(void);
 void qk_prof_zone_begin(const char *name);
 void qk_prof_zone_end(const char *name);
+void qk_prof_zone_add(const char *name, f64 ms);
 void qk_prof_counter_add(const char *name, u32 value);
 void qk_prof_event_begin(const char *name);
 void qk_prof_event_end(const char *name);
@@ -33,6 +34,7 @@ void qk_prof_event_end(const char *name);
 #define QK_PROF_FRAME_END()         qk_prof_frame_end()
 #define QK_PROF_ZONE_BEGIN(name)    qk_prof_zone_begin(name)
 #define QK_PROF_ZONE_END(name)      qk_prof_zone_end(name)
+#define QK_PROF_ZONE_ADD(name, ms)  qk_prof_zone_add((name), (ms))
 #define QK_PROF_COUNTER(name, val)  qk_prof_counter_add((name), (val))
 #define QK_PROF_EVENT_BEGIN(name)   qk_prof_event_begin(name)
 #define QK_PROF_EVENT_END(name)     qk_prof_event_end(name)
@@ -45,6 +47,7 @@ void qk_prof_event_end(const char *name);
 #define QK_PROF_FRAME_END()         ((void)0)
 #define QK_PROF_ZONE_BEGIN(name)    ((void)0)
 #define QK_PROF_ZONE_END(name)      ((void)0)
+#define QK_PROF_ZONE_ADD(name, ms)  ((void)0)
 #define QK_PROF_COUNTER(name, val)  ((void)0)
 #define QK_PROF_EVENT_BEGIN(name)   ((void)0)
 #define QK_PROF_EVENT_END(name)     ((void)0)
@@ -0,0 +1,62 @@
+/*
+ * QUICKEN Engine - Frame / Tick Scratch Arenas
+ *
+ * Per-thread temporary memory with a lifetime of one frame or one tick.
+ * Each thread gets two arenas per kind (double-buffered): memory taken in
+ * frame N stays valid through frame N+1, so results can be handed to the
+ * next stage (e.g. render submission) without copying. A thread's arena is
+ * reset lazily the first time it asks for scratch after a boundary, so
+ * worker threads need no coordination with the main loop.
+ *
+ * Use qk_arena_mark / qk_arena_pop for nested temporaries within a frame.
+ *
+ *   qk_arena_t *scratch = qk_scratch(QK_SCRATCH_FRAME);
+ *   qk_arena_marker_t m = qk_arena_mark(scratch);
+ *   foo_t *tmp = qk_arena_alloc(scratch, n * sizeof(foo_t));
+ *   ...
+ *   qk_arena_pop(scratch, m);
+ */
+
+#ifndef QK_SCRATCH_H
+#define QK_SCRATCH_H
+
+#include "quicken.h"
+#include "qk_arena.h"
+
+typedef enum {
+    QK_SCRATCH_FRAME = 0,   // advanced once per rendered/server frame
+    QK_SCRATCH_TICK,        // advanced once per simulation tick
+    QK_SCRATCH_KIND_COUNT
+} qk_scratch_kind_t;
+
+typedef struct {
+    u64     frame_size;     // reservation per arena; 0 = default (8 MB)
+    u64     tick_size;      // 0 = default (4 MB)
+    u32     arena_flags;    // qk_arena_flags_t, e.g. QK_ARENA_HUGE_PAGES
+} qk_scratch_config_t;
+
+typedef struct {
+    u64     high_water[QK_SCRATCH_KIND_COUNT];  // max bytes any thread used in one buffer
+    u64     capacity[QK_SCRATCH_KIND_COUNT];
+    u32     thread_count;                       // threads that have touched scratch
+} qk_scratch_stats_t;
+
+// Optional; without it scratch uses the defaults. Call before any thread uses scratch.
+void        qk_scratch_init(const qk_scratch_config_t *config);
+// Only once no other thread can touch scratch (after qk_job_shutdown)
+void        qk_scratch_shutdown(void);
+
+// Main thread, at the start of each frame / tick
+void        qk_scratch_advance(qk_scratch_kind_t kind);
+
+// Creates and fully commits both buffers of every kind for the calling
+// thread, so it never page-faults on scratch (e.g. before memory locking)
+bool        qk_scratch_prefault(void);
+
+// Calling thread's current arena. NULL only if reservation failed.
+qk_arena_t *qk_scratch(qk_scratch_kind_t kind);
+
+// Peaks of buffers retired since the previous call (resets the peaks)
+void        qk_scratch_get_stats(qk_scratch_stats_t *out_stats);
+
+#endif // QK_SCRATCH_H
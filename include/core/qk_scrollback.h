@@ -0,0 +1,76 @@
+/*
+ * QUICKEN Engine - Console Scrollback
+ *
+ * Lines of text packed into a byte ring with a line index beside it; the
+ * oldest lines go when either fills. Lines printed off the owning thread
+ * go through a bounded lock-free queue that the owner drains into the
+ * scrollback, in push order. No SDL or renderer dependency, so headless
+ * targets and the tests link it directly.
+ *
+ *   worker:  qk_print_queue_push(&queue, text, len, color);
+ *   owner:   dropped = qk_print_queue_drain(&queue, &scrollback);
+ */
+
+#ifndef QK_SCROLLBACK_H
+#define QK_SCROLLBACK_H
+
+#include "quicken.h"
+#include "core/qk_atomic.h"
+
+#define QK_SCROLLBACK_TEXT_BYTES  (64 * 1024)   // power of two
+#define QK_SCROLLBACK_LINES       2048          // power of two
+#define QK_SCROLLBACK_LINE_LEN    256           // longer lines keep LINE_LEN - 1 bytes
+#define QK_PRINT_QUEUE_SIZE       256           // power of two; 1.5 frames of 10k lines/s at 60 Hz
+
+typedef struct {
+    u32  offset;        // bytes written before this line
+    u32  len;
+    u32  color;
+} qk_scrollback_line_t;
+
+typedef struct {
+    char                    text_ring[QK_SCROLLBACK_TEXT_BYTES];
+    u32                     text_head;  // bytes ever written
+    qk_scrollback_line_t    lines[QK_SCROLLBACK_LINES];
+    u32                     line_head;  // lines ever written
+    u32                     line_tail;  // oldest line still held
+} qk_scrollback_t;
+
+// Zeroed is empty
+void qk_scrollback_push(qk_scrollback_t *sb, const char *text, u32 len, u32 color);
+void qk_scrollback_clear(qk_scrollback_t *sb);
+
+static inline u32 qk_scrollback_count(const qk_scrollback_t *sb) {
+    return sb->line_head - sb->line_tail;
+}
+
+// back = 0 is the newest line; back < qk_scrollback_count()
+const qk_scrollback_line_t *qk_scrollback_line(const qk_scrollback_t *sb, u32 back);
+
+// Copies a line out of the ring (it may wrap) into out, which holds at
+// least QK_SCROLLBACK_LINE_LEN bytes; returns its length, not terminated
+u32 qk_scrollback_text(const qk_scrollback_t *sb, const qk_scrollback_line_t *line, char *out);
+
+typedef struct {
+    qk_atomic_i32_t seq;    // see qk_print_queue_push
+    u32             color;
+    u32             len;
+    char            text[QK_SCROLLBACK_LINE_LEN];
+} qk_print_slot_t;
+
+// Multi-producer, single consumer. Zeroed is empty.
+typedef struct {
+    qk_print_slot_t slots[QK_PRINT_QUEUE_SIZE];
+    qk_atomic_i32_t enqueue_pos;
+    u32             dequeue_pos;    // consumer only
+    qk_atomic_i32_t dropped;        // lines lost to a full queue
+} qk_print_queue_t;
+
+// Any thread. False when the queue is full; the line is counted as dropped.
+bool qk_print_queue_push(qk_print_queue_t *queue, const char *text, u32 len, u32 color);
+
+// Consumer only: moves queued lines into sb in push order. Returns the lines
+// dropped since the last drain, for the caller to report.
+u32  qk_print_queue_drain(qk_print_queue_t *queue, qk_scrollback_t *sb);
+
+#endif // QK_SCROLLBACK_H
@@ -0,0 +1,118 @@
+/*
+ * QUICKEN Engine - Server Tick Budget
+ *
+ * Measures each server tick against its budget (1 / tick rate) and,
+ * when ticks keep running long, degrades in a fixed order instead of
+ * letting the accumulator snowball into back-to-back catch-up ticks:
+ *
+ *   1. DEFER      housekeeping waits (demo flush, stats, profiler output)
+ *   2. THIN       low-priority clients (spectators, relays) get fewer snapshots
+ *   3. CAP        at most QK_TICK_BUDGET_CATCHUP_CAPPED ticks per frame;
+ *                 the rest of the backlog is dropped, not replayed
+ *
+ * Levels rise on a smoothed load above QK_TICK_BUDGET_RAISE_LOAD and fall
+ * one at a time after a quiet stretch, so one slow tick does not flap.
+ * Time is passed in, never read, so tests can inject tick cost.
+ *
+ *   qk_tick_budget_begin_tick(&tb, now);
+ *   read_inputs();        qk_tick_budget_mark(&tb, QK_TICK_PHASE_INPUT, now());
+ *   simulate();           qk_tick_budget_mark(&tb, QK_TICK_PHASE_SIM, now());
+ *   ...
+ *   qk_tick_budget_end_tick(&tb, now());
+ */
+
+#ifndef QK_TICK_BUDGET_H
+#define QK_TICK_BUDGET_H
+
+#include "quicken.h"
+
+#define QK_TICK_BUDGET_EVENT_RING       32
+#define QK_TICK_BUDGET_HIST_BUCKETS     64
+
+typedef enum {
+    QK_TICK_PHASE_INPUT = 0,    // read client commands
+    QK_TICK_PHASE_SIM,          // gameplay + physics
+    QK_TICK_PHASE_SNAPSHOT,     // pack entities and events
+    QK_TICK_PHASE_SEND,         // netcode tick: encode and send
+    QK_TICK_PHASE_COUNT
+} qk_tick_phase_t;
+
+typedef enum {
+    QK_DEGRADE_NONE = 0,
+    QK_DEGRADE_DEFER,
+    QK_DEGRADE_THIN,
+    QK_DEGRADE_CAP,
+    QK_DEGRADE_LEVEL_COUNT
+} qk_degrade_level_t;
+
+// Catch-up ticks allowed in one frame (tick time comes from qk_types.h)
+static const u32 QK_TICK_BUDGET_CATCHUP_MAX     = 8;
+static const u32 QK_TICK_BUDGET_CATCHUP_CAPPED  = 2;
+// Snapshot interval for low-priority clients at THIN and above
+static const u32 QK_TICK_BUDGET_THIN_INTERVAL   = 4;
+
+static const f64 QK_TICK_BUDGET_RAISE_LOAD      = 0.9;  // smoothed tick_ms / budget
+static const f64 QK_TICK_BUDGET_LOWER_LOAD      = 0.6;
+static const f64 QK_TICK_BUDGET_SMOOTHING       = 0.1;  // EMA weight per tick
+static const u32 QK_TICK_BUDGET_RAISE_HOLD      = 16;   // ticks between raises
+static const u32 QK_TICK_BUDGET_LOWER_HOLD      = 128;  // quiet ticks per step down
+// Tick duration histogram bucket width; the last bucket takes the tail
+static const f64 QK_TICK_BUDGET_HIST_STEP_MS    = 0.25;
+
+// A level change, for logs and the profiler
+typedef struct {
+    u64                 tick;
+    qk_degrade_level_t  from;
+    qk_degrade_level_t  to;
+    f64                 load;
+} qk_degrade_event_t;
+
+typedef struct {
+    f64                 budget_ms;
+    f64                 tick_start;
+    f64                 phase_start;
+    f64                 phase_ms[QK_TICK_PHASE_COUNT];  // last tick
+    f64                 tick_ms;                        // last tick
+    f64                 load;                           // smoothed tick_ms / budget_ms
+    qk_degrade_level_t  level;
+    u32                 ticks_since_change;
+
+    // Cumulative
+    u64                 ticks;
+    u64                 overruns;           // ticks longer than the budget
+    u64                 ticks_dropped;      // backlog discarded at CAP
+    f64                 worst_tick_ms;
+    u32                 hist[QK_TICK_BUDGET_HIST_BUCKETS];
+
+    qk_degrade_event_t  events[QK_TICK_BUDGET_EVENT_RING];
+    u32                 event_head;
+    u32                 event_read;
+} qk_tick_budget_t;
+
+// budget_ms <= 0: one tick at QK_TICK_RATE
+void qk_tick_budget_init(qk_tick_budget_t *tb, f64 budget_ms);
+
+void qk_tick_budget_begin_tick(qk_tick_budget_t *tb, f64 now);
+// Ends the phase that started at the previous mark (or begin_tick)
+void qk_tick_budget_mark(qk_tick_budget_t *tb, qk_tick_phase_t phase, f64 now);
+void qk_tick_budget_end_tick(qk_tick_budget_t *tb, f64 now);
+
+// Ticks to run this frame. Backlog beyond the catch-up limit (MAX, or
+// CAPPED at QK_DEGRADE_CAP) is removed from the accumulator and counted.
+u32  qk_tick_budget_ticks_due(qk_tick_budget_t *tb, f32 *accumulator, f32 tick_dt);
+
+static inline bool qk_tick_budget_at_least(const qk_tick_budget_t *tb,
+                                           qk_degrade_level_t level) {
+    return tb->level >= level;
+}
+
+// Oldest unread level change; false when there is none
+bool qk_tick_budget_pop_event(qk_tick_budget_t *tb, qk_degrade_event_t *out_event);
+
+// Tick duration (ms) below which `fraction` of all ticks fell, to bucket
+// resolution; the tail bucket reports worst_tick_ms. 0 before any tick.
+f64  qk_tick_budget_percentile(const qk_tick_budget_t *tb, f64 fraction);
+
+const char *qk_degrade_level_name(qk_degrade_level_t level);
+
+#endif // QK_TICK_BUDGET_H
@@ -9,6 +9,7 @@
 
 #include "quicken.h"
 #include "qk_types.h"
+#include "qk_arena.h"
 #include "netcode/n_types.h"
 
 // Forward declaration
@@ -20,6 +21,8 @@ typedef struct {
     u8      rounds_to_win;          // 0 = default (10)
     u32     round_time_limit_ms;    // 0 = default (120000)
     u32     countdown_time_ms;      // 0 = default (5000)
+    qk_arena_t *arena;              // NULL = static state; else allocated here
+                                    // (e.g. a huge-page arena), until shutdown
 } qk_game_config_t;
 
 // Clan Arena state (read-only for UI) -- named struct for forward declaration
@@ -77,4 +80,18 @@ typedef struct {
 // Fills out_events up to max_events.
 u32 qk_game_get_explosions(qk_explosion_event_t *out_events, u32 max_events);
 
+// Most events one tick keeps (the gameplay event ring); a pack buffer
+// this size never leaves any of them out
+#define QK_GAME_MAX_TICK_EVENTS 256
+
+// Quantizes this tick's events (kills, hits, round changes, explosions)
+// for qk_net_server_push_events. Returns the number written; any past
+// max_events are counted in qk_game_get_events_lost.
+u32 qk_game_pack_events(n_game_event_t *out_events, u32 max_events);
+
+// Events that never reached a pack since qk_game_init: overwritten in a
+// tick that produced more than QK_GAME_MAX_TICK_EVENTS, or left out of a
+// pack buffer that was too small
+u32 qk_game_get_events_lost(void);
+
 #endif /* QK_GAMEPLAY_H */
@@ -4,6 +4,7 @@
  * Compact, quantized types for network transmission.
  * n_entity_state_t is the on-the-wire entity representation.
  * n_input_t is the on-the-wire input representation.
+ * n_game_event_t is a quantized gameplay event (kill, hit, round change).
  */
 
 #ifndef N_TYPES_H
@@ -62,9 +63,43 @@ typedef struct {
     u16     pitch;                   // quantized angle
     u16     buttons;
     u8      weapon_select;
+    u8      attack_subtick;          // QK_SUBTICK_NONE unless attack was pressed
+    u8      jump_subtick;
+    u16     attack_yaw;              // quantized angles at the attack press
+    u16     attack_pitch;
 } n_input_t;
 
-_Static_assert(sizeof(n_input_t) == 10,
+_Static_assert(sizeof(n_input_t) == 16,
                "input struct size changed — update wire format");
 
+// Game event kinds (values match the gameplay event enum)
+typedef enum {
+    N_GEVT_KILL = 0,
+    N_GEVT_HIT,
+    N_GEVT_ROUND_START,
+    N_GEVT_ROUND_END,
+    N_GEVT_MATCH_END,
+    N_GEVT_EXPLOSION,
+    N_GEVT_COUNT
+} n_game_event_type_t;
+
+// Game event for network transmission. The server stamps tick when the
+// event is queued; each type occupies only its own fields on the wire.
+typedef struct {
+    u32     tick;
+    u8      type;                    // n_game_event_type_t
+    union {
+        struct { u8 attacker; u8 victim; u8 weapon; } kill;
+        struct { u8 target; u8 attacker; i16 damage; } hit;
+        struct { u8 round_number; } round_start;
+        struct { u8 winner_team; u8 score_a; u8 score_b; } round_end;
+        struct { u8 winner_team; } match_end;
+        struct {
+            i16 pos[3];              // fixed-point 15.1, as n_entity_state_t
+            i8  dir[3];              // unit vector * 127
+            u8  radius;              // game units
+        } explosion;
+    } data;
+} n_game_event_t;
+
 #endif /* N_TYPES_H */
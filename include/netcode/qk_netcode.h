@@ -10,6 +10,7 @@
 
 #include "quicken.h"
 #include "qk_types.h"
+#include "qk_arena.h"
 #include "netcode/n_types.h"
 
 // Server config
@@ -17,13 +18,25 @@ typedef struct {
     u16     server_port;        // 0 = don't bind
     u32     max_clients;        // up to 16
     f64     tick_rate;          // 0 = default (128.0)
+    qk_arena_t *arena;          // NULL = heap; else server state (snapshot
+                                // history etc.) lives here until shutdown
 } qk_net_server_config_t;
 
 // Client config
 typedef struct {
     f64     interp_delay;       // 0 = default (0.020)
+    f64     extrap_limit;       // 0 = default (0.25 s), < 0 = never extrapolate
+    bool    local_direct;       // connect_local skips serialization: snapshots,
+                                // events and inputs are copied between rings
 } qk_net_client_config_t;
 
+// Relay config
+typedef struct {
+    u16     listen_port;        // viewers connect here
+    u32     max_viewers;        // 0 = default (256)
+    f64     delay;              // seconds viewers run behind the game, 0 = live
+} qk_net_relay_config_t;
+
 // Connection state
 typedef enum {
     QK_CONN_DISCONNECTED,
@@ -61,8 +74,35 @@ typedef struct {
     u32     interp_count;
     bool    valid;              // false if no interp pair found
     bool    fallback;           // true if using two-newest fallback
+    f32     extrap_sec;         // > 0 while dead-reckoning past the newest snapshot
 } qk_interp_diag_t;
 
+// Relay counters (cumulative except viewer_count / queued)
+typedef struct {
+    u32     viewer_count;
+    u32     upstream_tick;      // newest snapshot received from the server
+    u32     broadcast_tick;     // newest snapshot sent to viewers
+    u32     queued;             // snapshots waiting out the delay
+    u64     encodes;            // delta encodes performed
+    u64     encodes_shared;     // viewer sends that reused an encode
+    u64     packets_sent;
+    u64     bytes_sent;
+} qk_net_relay_stats_t;
+
+// Server browser reply (see qk_net_query_*)
+typedef struct {
+    char    map_name[128];
+    u8      players;
+    u8      spectators;         // relays
+    u8      max_clients;
+    u16     tick_rate;
+    u32     ping_us;            // request sent to reply received
+} qk_net_server_info_t;
+
+// Collision for extrapolated players: move a player hull from start toward
+// end and return where it stops. Set by the client, which owns the world.
+typedef vec3_t (*qk_net_extrap_trace_fn)(void *user, vec3_t start, vec3_t end);
+
 // Server API
 qk_result_t qk_net_server_init(const qk_net_server_config_t *config);
 void        qk_net_server_tick(void);
@@ -73,11 +113,23 @@ u32         qk_net_server_client_count(void);
 void        qk_net_server_set_entity(u8 entity_id,
                                       const n_entity_state_t *state);
 void        qk_net_server_remove_entity(u8 entity_id);
+// Queue game events for this tick's snapshot (call before qk_net_server_tick).
+// Each is resent with every snapshot until the client acks it, for ~1 s.
+void        qk_net_server_push_events(const n_game_event_t *events, u32 count);
 bool        qk_net_server_get_input(u8 client_id, qk_usercmd_t *out_cmd);
 
 // Per-client server queries (for detecting remote joins/disconnects)
 qk_conn_state_t qk_net_server_get_client_state(u8 client_id);
 bool             qk_net_server_is_client_map_ready(u8 client_id);
+// Spectator relays hold a slot but must not get a player
+bool             qk_net_server_is_client_relay(u8 client_id);
+// Map-ready and not a relay: the slot should have a player in the game
+bool             qk_net_server_is_client_player(u8 client_id);
+
+// Overload thinning: low-priority clients (e.g. spectators) get a snapshot
+// only every `interval` ticks; 0 or 1 sends every tick to everyone
+void        qk_net_server_set_client_low_priority(u8 client_id, bool low_priority);
+void        qk_net_server_set_low_priority_interval(u32 interval);
 
 // Client API
 qk_result_t qk_net_client_init(const qk_net_client_config_t *config);
@@ -92,13 +144,32 @@ void        qk_net_client_send_input(const qk_usercmd_t *cmd);
 const qk_interp_state_t *qk_net_client_get_interp_state(void);
 const qk_interp_diag_t  *qk_net_client_get_interp_diag(void);
 
+// When snapshots run late, entities are extrapolated from the newest one
+// (velocity, plus gravity for airborne players) for up to extrap_limit,
+// then blended back once interpolation resumes. NULL = no collision.
+void        qk_net_client_set_extrap_trace(qk_net_extrap_trace_fn fn, void *user);
+
+// Game events received since the last call, oldest first, each once.
+// tick is the server tick the event happened on.
+u32         qk_net_client_poll_events(n_game_event_t *out_events, u32 max_events);
+
 qk_conn_state_t qk_net_client_get_state(void);
 i32             qk_net_client_get_rtt(void);
+// Clock sync diagnostics: converged once enough snapshots were sampled;
+// min RTT is over the sample window, -1 while no snapshot echoed an input
+bool            qk_net_client_is_clock_converged(void);
+i32             qk_net_client_get_min_rtt_us(void);
 u8              qk_net_client_get_id(void);
 
 // Client prediction support
 u32             qk_net_client_get_input_sequence(void);
 u32             qk_net_client_get_server_cmd_ack(void);
+
+// Time dilation: multiply the command clock's dt by the scale (~0.95..1.05)
+// so the server holds about one tick of this client's input in its buffer.
+// Depth is the smoothed server-reported buffer, in ticks.
+f32             qk_net_client_get_time_scale(void);
+f32             qk_net_client_get_input_depth(void);
 bool            qk_net_client_get_server_player_state(qk_player_state_t *out);
 
 // Map-load handshake: client notifies server after loading a map.
@@ -120,4 +191,23 @@ void            qk_net_client_inject_demo_snapshot(u32 tick, u32 entity_count,
                                                     const u64 *entity_mask,
                                                     const n_entity_state_t *entities);
 
+// Relay API: connects to a game server as a spectator relay (one slot, no
+// player, every entity) and re-broadcasts its snapshots to viewers, who
+// connect with the normal client. Viewers on the same baseline share one
+// delta encode. Tick about once a millisecond.
+qk_result_t     qk_net_relay_init(const qk_net_relay_config_t *config);
+qk_result_t     qk_net_relay_connect(const char *address, u16 port);
+void            qk_net_relay_tick(void);
+void            qk_net_relay_shutdown(void);
+qk_conn_state_t qk_net_relay_get_upstream_state(void);
+void            qk_net_relay_get_stats(qk_net_relay_stats_t *out);
+
+// Server browser query: connectionless, so it costs the server no slot.
+// Each send is one ping sample; poll returns replies as they arrive. The
+// server answers a few queries per second per source address.
+qk_result_t     qk_net_query_open(const char *address, u16 port);
+bool            qk_net_query_send(void);
+bool            qk_net_query_poll(qk_net_server_info_t *out_info);
+void            qk_net_query_close(void);
+
 #endif /* QK_NETCODE_H */
@@ -11,6 +11,7 @@
 #include "quicken.h"
 #include "qk_math.h"
 #include "qk_types.h"
+#include "qk_arena.h"
 
 // Opaque world handle
 typedef struct qk_phys_world qk_phys_world_t;
@@ -41,6 +42,10 @@ typedef struct {
 
 // Lifecycle
 qk_phys_world_t *qk_physics_world_create(qk_collision_model_t *cm);
+// World plus a packed copy of cm, allocated from arena (e.g. one created
+// with QK_ARENA_HUGE_PAGES). cm can be freed afterwards; the world lives
+// until the arena is reset or destroyed, and destroy is a no-op for it.
+qk_phys_world_t *qk_physics_world_create_in(qk_collision_model_t *cm, qk_arena_t *arena);
 void              qk_physics_world_destroy(qk_phys_world_t *world);
 
 // Create a hardcoded test room (512x512x256 box) for testing without a .map file
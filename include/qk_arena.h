@@ -3,6 +3,10 @@
  *
  * Simple bump allocator with 16-byte alignment.
  * All modules use arenas for memory allocation. No malloc/free in hot paths.
+ *
+ * The full size is reserved as address space up front and committed in
+ * chunks as the offset grows, so a large arena costs nothing until used.
+ * Freshly committed memory is zero; memory reused after reset/pop is not.
  */
 
 #ifndef QK_ARENA_H
@@ -12,9 +16,34 @@
 
 typedef struct qk_arena qk_arena_t;
 
+typedef enum {
+    QK_ARENA_HUGE_PAGES = (1 << 0),     // 2 MB pages when the OS grants them
+    // Linux: take the whole size from the preallocated hugetlbfs pool
+    // (vm.nr_hugepages) up front; falls back to QK_ARENA_HUGE_PAGES
+    QK_ARENA_HUGETLB    = (1 << 1),
+} qk_arena_flags_t;
+
+// Saved offset for scoped temporary allocations (mark ... pop)
+typedef struct {
+    u64 offset;
+} qk_arena_marker_t;
+
 qk_arena_t *qk_arena_create(u64 size);
+qk_arena_t *qk_arena_create_ex(u64 size, u32 flags);
 void       *qk_arena_alloc(qk_arena_t *arena, u64 size);
+void       *qk_arena_alloc_aligned(qk_arena_t *arena, u64 size, u64 align);
 void       qk_arena_reset(qk_arena_t *arena);
+// Commit and touch the first `size` bytes (0 = all) so later allocations
+// never page-fault. Call before qk_platform_lock_memory to keep them resident.
+bool       qk_arena_prefault(qk_arena_t *arena, u64 size);
 void       qk_arena_destroy(qk_arena_t *arena);
 
+qk_arena_marker_t qk_arena_mark(const qk_arena_t *arena);
+void              qk_arena_pop(qk_arena_t *arena, qk_arena_marker_t marker);
+
+u64        qk_arena_used(const qk_arena_t *arena);
+u64        qk_arena_high_water(const qk_arena_t *arena);   // peak since last reset
+u64        qk_arena_capacity(const qk_arena_t *arena);
+bool       qk_arena_has_huge_pages(const qk_arena_t *arena);
+
 #endif // QK_ARENA_H
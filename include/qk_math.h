@@ -26,6 +26,10 @@ static inline vec3_t vec3_scale(vec3_t v, f32 s) {
     return (vec3_t){ v.x * s, v.y * s, v.z * s };
 }
 
+static inline vec3_t vec3_lerp(vec3_t a, vec3_t b, f32 t) {
+    return (vec3_t){ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+}
+
 static inline f32 vec3_dot(vec3_t a, vec3_t b) {
     return a.x * b.x + a.y * b.y + a.z * b.z;
 }
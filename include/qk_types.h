@@ -107,8 +107,28 @@ typedef struct {
     f32     yaw;
     u32     buttons;
     u8      weapon_select;      // 0 = no change, otherwise weapon_id_t
+    u8      attack_subtick;     // when attack was pressed this tick (QK_SUBTICK_*)
+    u8      jump_subtick;       // when jump was pressed this tick
+    f32     attack_pitch;       // view angles at the attack press
+    f32     attack_yaw;
 } qk_usercmd_t;
 
+// --- Sub-tick Timestamps ---
+// A press edge records how far into the tick it happened, quantized to
+// 1..255 (start..end of the tick). 0 means no press edge this tick.
+
+#define QK_SUBTICK_NONE 0
+
+static inline u8 qk_subtick_encode(f32 fraction) {
+    if (fraction < 0.0f) fraction = 0.0f;
+    if (fraction > 1.0f) fraction = 1.0f;
+    return (u8)(1.0f + fraction * 254.0f + 0.5f);
+}
+
+static inline f32 qk_subtick_fraction(u8 subtick) {
+    return subtick == QK_SUBTICK_NONE ? 1.0f : (f32)(subtick - 1) / 254.0f;
+}
+
 // --- Player State ---
 
 typedef struct {
@@ -205,7 +225,7 @@ enum {
 };
 
 // --- Layout Assertions ---
-_Static_assert(sizeof(qk_usercmd_t) == 32,
+_Static_assert(sizeof(qk_usercmd_t) == 40,
                "qk_usercmd_t size changed — update netcode serialization");
 _Static_assert(sizeof(qk_trace_result_t) == 44,
                "qk_trace_result_t size changed — check physics/gameplay boundary");
@@ -83,6 +83,12 @@ typedef enum {
 
 // Utility
 #define QK_UNUSED(x) ((void)(x))
+
+#ifdef _MSC_VER
+    #define QK_THREAD_LOCAL __declspec(thread)
+#else
+    #define QK_THREAD_LOCAL _Thread_local
+#endif
 static const u32 QK_TARGET_FPS = 1000;
 
 #endif // QUICKEN_H
@@ -26,6 +26,8 @@ typedef struct {
 typedef struct {
     f32     view_projection[16]; // column-major 4x4
     f32     position[3];
+    f32     z_near;              // projection depth range (light cluster slicing)
+    f32     z_far;
 } qk_camera_t;
 
 // World vertex (produced by map loader, consumed by renderer)
@@ -69,6 +71,14 @@ typedef struct {
     f32     acquire_ms;
 } qk_gpu_stats_t;
 
+// One timed GPU region of a resolved frame (gpu_frame > gpu_world > gpu_fx ...)
+typedef struct {
+    const char *name;
+    i32     parent;         // index into the same array, -1 for the root
+    u32     depth;
+    f64     ms;
+} qk_gpu_region_t;
+
 // Lifecycle
 qk_result_t qk_renderer_init(const qk_renderer_config_t *config);
 void        qk_renderer_shutdown(void);
@@ -87,6 +97,9 @@ qk_result_t qk_renderer_upload_world(
     const qk_draw_surface_t *surfaces, u32 surface_count);
 qk_texture_id_t qk_renderer_upload_texture(
     const u8 *pixels, u32 width, u32 height, u32 channels, bool nearest);
+// RGBA, linear filtered; alpha is a distance field (0.5 = edge) that the
+// UI shader thresholds, so glyphs stay sharp at any draw size
+qk_texture_id_t qk_renderer_upload_sdf_texture(const u8 *pixels, u32 width, u32 height);
 void qk_renderer_free_world(void);
 
 // Lightmap atlas upload (call after upload_world, before rendering)
@@ -96,6 +109,8 @@ qk_result_t qk_renderer_upload_lightmap_atlas(const u8 *pixels, u32 w, u32 h);
 void qk_renderer_begin_frame(const qk_camera_t *camera);
 void qk_renderer_draw_world(void);
 void qk_renderer_push_ui_quad(const qk_ui_quad_t *quad);
+// Same as count push_ui_quad calls, as one copy; quads past the limit are dropped
+void qk_renderer_push_ui_quads(const qk_ui_quad_t *quads, u32 count);
 void qk_renderer_set_ui_layer(bool overlay);
 void qk_renderer_end_frame(void);
 
@@ -168,6 +183,11 @@ void qk_renderer_set_bloom_strength(f32 strength);
 
 // Debug
 void qk_renderer_get_stats(qk_gpu_stats_t *out_stats);
+// GPU regions of the newest frame whose timestamps have been read back
+// (R_FRAMES_IN_FLIGHT frames behind), parents before children. The same
+// times also reach qk_prof as zones when profiling is compiled in.
+u32  qk_renderer_get_gpu_regions(qk_gpu_region_t *out_regions, u32 max_regions,
+                                 u64 *out_frame);
 
 /* High-level UI drawing (convenience functions built on push_ui_quad).
  * Declared here, implemented in src/ui/ui_draw.c */
@@ -176,5 +196,9 @@ void qk_ui_draw_text(f32 x, f32 y, const char *text, f32 size,
                       u32 color_rgba);
 void qk_ui_draw_number(f32 x, f32 y, i32 value, f32 size, u32 color_rgba);
 f32  qk_ui_text_width(const char *text, f32 size);
+// Glyph quads for len bytes of text into out (blanks emit none), for
+// callers that cache them and push with qk_renderer_push_ui_quads
+u32  qk_ui_build_text_quads(f32 x, f32 y, const char *text, u32 len, f32 size,
+                            u32 color_rgba, qk_ui_quad_t *out, u32 max_quads);
 
 #endif // QK_RENDERER_H
@@ -6,6 +6,8 @@
 --   quicken-netcode    StaticLib   (precise float, determinism)
 --   quicken            ConsoleApp  (client executable)
 --   quicken-server     ConsoleApp  (headless dedicated server)
+--   quicken-relay      ConsoleApp  (spectator broadcast relay)
+--   quicken-query      ConsoleApp  (server browser query tool)
 --
 -- IMPORTANT: Different modules use different floating-point settings.
 -- See docs/ARCHITECTURE.md and docs/plans/INTEGRATION.md Section 4.6.
@@ -193,7 +195,8 @@ project "quicken"
 
     removefiles {
         "src/server_main.c",
-        "src/test_main.c"
+        "src/test_main.c",
+        "src/query_main.c"
     }
 
     includedirs {
@@ -287,6 +290,114 @@ project "quicken-server"
 
     filter {}
 
+--------------------------------------------------------------
+-- Spectator relay (headless: one upstream, many viewers)
+--------------------------------------------------------------
+project "quicken-relay"
+    kind "ConsoleApp"
+    language "C"
+    cdialect "C11"
+    warnings "Extra"
+
+    targetdir ("build/bin/" .. outputdir)
+    objdir ("build/obj/" .. outputdir .. "/relay")
+
+    defines { "QK_HEADLESS" }
+
+    -- Netcode references gameplay (player state) and demo hooks
+    files {
+        "src/relay_main.c",
+        "src/core/**.c",
+        "src/gameplay/**.c",
+        "src/gameplay/**.h",
+        "include/**.h"
+    }
+
+    removefiles {
+        "src/core/qk_window.c",
+        "src/core/qk_input.c"
+    }
+
+    includedirs {
+        "include",
+        "src/gameplay"
+    }
+
+    links {
+        "quicken-physics",
+        "quicken-netcode"
+    }
+
+    filter "system:windows"
+        system "windows"
+        links { "ws2_32" }
+
+    filter "system:linux"
+        system "linux"
+        links { "m", "pthread" }
+        buildoptions {
+            "-Wall", "-Wextra", "-Wpedantic",
+            "-msse2",
+            "-std=c11",
+            "-ffp-contract=off"
+        }
+
+    filter {}
+
+--------------------------------------------------------------
+-- Server query tool (connectionless info queries, like a browser)
+--------------------------------------------------------------
+project "quicken-query"
+    kind "ConsoleApp"
+    language "C"
+    cdialect "C11"
+    warnings "Extra"
+
+    targetdir ("build/bin/" .. outputdir)
+    objdir ("build/obj/" .. outputdir .. "/query")
+
+    defines { "QK_HEADLESS" }
+
+    -- Netcode references gameplay (player state) and demo hooks
+    files {
+        "src/query_main.c",
+        "src/core/**.c",
+        "src/gameplay/**.c",
+        "src/gameplay/**.h",
+        "include/**.h"
+    }
+
+    removefiles {
+        "src/core/qk_window.c",
+        "src/core/qk_input.c"
+    }
+
+    includedirs {
+        "include",
+        "src/gameplay"
+    }
+
+    links {
+        "quicken-physics",
+        "quicken-netcode"
+    }
+
+    filter "system:windows"
+        system "windows"
+        links { "ws2_32" }
+
+    filter "system:linux"
+        system "linux"
+        links { "m", "pthread" }
+        buildoptions {
+            "-Wall", "-Wextra", "-Wpedantic",
+            "-msse2",
+            "-std=c11",
+            "-ffp-contract=off"
+        }
+
+    filter {}
+
 --------------------------------------------------------------
 -- Automated test harness (headless gameplay tests)
 --------------------------------------------------------------
@@ -358,8 +469,10 @@ project "test-netcode"
         "tests/test_netcode_loopback.c"
     }
 
+    -- src for netcode/n_internal.h (unit checks below the public API)
     includedirs {
         "include",
+        "src",
         "src/gameplay"
     }
 
@@ -370,10 +483,13 @@ project "test-netcode"
 
     -- Gameplay sources compiled directly (netcode depends on gameplay for prediction API)
     -- Demo source needed because netcode hooks call qk_demo_is_recording()
+    -- (and demo playback uses scratch arenas)
     files {
         "src/gameplay/**.c",
         "src/gameplay/**.h",
         "src/core/qk_demo.c",
+        "src/core/qk_arena.c",
+        "src/core/qk_scratch.c",
         "src/core/qk_prof.c",
         "src/core/qk_platform.c"
     }
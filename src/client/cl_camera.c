@@ -7,6 +7,9 @@
 #include <math.h>
 #include <string.h>
 
+static const f32 CL_CAMERA_Z_NEAR = 0.1f;
+static const f32 CL_CAMERA_Z_FAR  = 4096.0f;
+
 static void build_perspective(f32 *out, f32 fov_deg, f32 aspect,
                                f32 znear, f32 zfar) {
     memset(out, 0, 16 * sizeof(f32));
@@ -72,7 +75,7 @@ qk_camera_t cl_camera_build(f32 pos_x, f32 pos_y, f32 pos_z,
     qk_camera_t cam;
     f32 proj[16], view[16];
 
-    build_perspective(proj, fov, aspect, 0.1f, 4096.0f);
+    build_perspective(proj, fov, aspect, CL_CAMERA_Z_NEAR, CL_CAMERA_Z_FAR);
 
     // Eye position is at player origin + eye height
     f32 eye_z = pos_z + 26.0f;
@@ -82,6 +85,8 @@ qk_camera_t cl_camera_build(f32 pos_x, f32 pos_y, f32 pos_z,
     cam.position[0] = pos_x;
     cam.position[1] = pos_y;
     cam.position[2] = eye_z;
+    cam.z_near = CL_CAMERA_Z_NEAR;
+    cam.z_far  = CL_CAMERA_Z_FAR;
 
     return cam;
 }
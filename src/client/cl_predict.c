@@ -4,6 +4,7 @@
 
 #include "client/cl_predict.h"
 
+#include <math.h>
 #include <string.h>
 
 #include "qk_types.h"
@@ -33,6 +34,31 @@ static bool                 s_has_prediction;
 static f32                  s_accumulator;
 static u32                  s_last_reconciled_ack;
 
+// --- Incremental Replay ---
+
+// Correction replay runs against a copy of the state and is spread across
+// frames: at most CL_REPLAY_BUDGET ticks per reconcile, so a 200 ms ping
+// (~26 ticks in flight) finishes in two frames instead of one 26-tick spike.
+// The displayed tip keeps the old chain until the replay catches up.
+#define CL_REPLAY_BUDGET 16
+
+static const f32 CL_PREDICT_ORIGIN_EPSILON_SQ   = 0.1f;
+static const f32 CL_PREDICT_VELOCITY_EPSILON_SQ = 1.0f;
+
+static bool                 s_replaying;
+static qk_player_state_t    s_replay_ps;        // corrected state after s_replay_seq - 1
+static u32                  s_replay_seq;       // next command to replay
+
+// --- Error Smoothing ---
+
+// When a correction moves the tip, the rendered position keeps the old
+// spot and the difference decays away over a few frames. Teleports and
+// corrections beyond the snap distance are shown at once.
+static vec3_t               s_error_offset;
+static f32                  s_smooth_half_life = 0.05f;
+static f32                  s_smooth_snap_dist = 64.0f;
+static bool                 s_snap_next;        // teleport seen: don't smooth the pending swap
+
 // --- Init / Reset ---
 
 void cl_predict_init(void) {
@@ -47,20 +73,81 @@ void cl_predict_reset(void) {
     s_has_prediction = false;
     s_accumulator = 0.0f;
     s_last_reconciled_ack = 0;
+    s_replaying = false;
+    s_error_offset = (vec3_t){0};
+    s_snap_next = false;
+}
+
+void cl_predict_set_error_smoothing(f32 half_life, f32 snap_dist) {
+    s_smooth_half_life = half_life;
+    s_smooth_snap_dist = snap_dist;
+    if (half_life <= 0.0f) s_error_offset = (vec3_t){0};
+}
+
+// --- State Comparison ---
+
+// Every field qk_physics_move reads back on the next tick. A state that
+// matches on all of them produces the same future from the same commands,
+// which is what lets a replay stop early. command_time is excluded: it is
+// overwritten from each command before it is read.
+static bool predict_physics_match(const qk_player_state_t *a,
+                                  const qk_player_state_t *b) {
+    vec3_t d_origin = vec3_sub(a->origin, b->origin);
+    vec3_t d_velocity = vec3_sub(a->velocity, b->velocity);
+    return vec3_dot(d_origin, d_origin) < CL_PREDICT_ORIGIN_EPSILON_SQ
+        && vec3_dot(d_velocity, d_velocity) < CL_PREDICT_VELOCITY_EPSILON_SQ
+        && a->on_ground == b->on_ground
+        && a->jump_held == b->jump_held
+        && a->jump_buffer_ticks == b->jump_buffer_ticks
+        && a->splash_slick_ticks == b->splash_slick_ticks
+        && a->skim_ticks == b->skim_ticks
+        && a->last_jump_tick == b->last_jump_tick
+        && a->autohop_cooldown == b->autohop_cooldown;
+}
+
+// Authoritative gameplay state (weapon, ammo, health, alive_state, etc.)
+// is never predicted, only carried along
+static void predict_copy_gameplay(qk_player_state_t *dst,
+                                  const qk_player_state_t *src) {
+    dst->weapon          = src->weapon;
+    dst->pending_weapon  = src->pending_weapon;
+    dst->weapon_time     = src->weapon_time;
+    dst->switch_time     = src->switch_time;
+    memcpy(dst->ammo, src->ammo, sizeof(src->ammo));
+    dst->health          = src->health;
+    dst->armor           = src->armor;
+    dst->alive_state     = src->alive_state;
+    dst->frags           = src->frags;
+    dst->deaths          = src->deaths;
+    dst->damage_given    = src->damage_given;
+    dst->damage_taken    = src->damage_taken;
+    dst->respawn_time    = src->respawn_time;
 }
 
 // --- Prediction Tick ---
 
 void cl_predict_tick(const qk_input_state_t *input,
                       qk_phys_world_t *world, f32 dt, bool is_remote) {
-    s_accumulator += dt;
+    // Remote: the command clock runs a few percent fast or slow to keep
+    // about one tick of input buffered on the server
+    f32 time_scale = is_remote ? qk_net_client_get_time_scale() : 1.0f;
+    s_accumulator += dt * time_scale;
+
+    if (s_smooth_half_life > 0.0f) {
+        s_error_offset = vec3_scale(s_error_offset, exp2f(-dt / s_smooth_half_life));
+    }
 
     while (s_accumulator >= QK_TICK_DT) {
         u32 server_time = is_remote
             ? s_cmd_sequence * QK_TICK_DT_MS_NOM
             : qk_net_server_get_tick() * QK_TICK_DT_MS_NOM;
 
-        qk_usercmd_t cmd = qk_input_build_usercmd(input, server_time);
+        // Real time runs (accumulator - one tick) ahead of this tick's end
+        u64 ahead_ns = (u64)((s_accumulator - QK_TICK_DT) / time_scale * 1e9f);
+        u64 poll_ns = input ? input->poll_time_ns : 0;
+        u64 tick_end_ns = poll_ns > ahead_ns ? poll_ns - ahead_ns : 0;
+
+        qk_usercmd_t cmd = qk_input_build_usercmd(input, server_time, tick_end_ns);
 
         u32 cmd_idx = s_cmd_sequence % CL_CMD_BUFFER_SIZE;
         s_cmd_buffer[cmd_idx].cmd = cmd;
@@ -89,69 +176,93 @@ void cl_predict_tick(const qk_input_state_t *input,
 
 // --- Reconciliation ---
 
-void cl_predict_reconcile(qk_phys_world_t *world) {
-    u32 ack = qk_net_client_get_server_cmd_ack();
-    if (ack <= s_last_reconciled_ack || !s_has_prediction) return;
+// Advance the pending replay by up to CL_REPLAY_BUDGET commands. History
+// entries are rewritten as the corrected chain passes them; once the
+// corrected state lands on a stored entry again, everything after it
+// (including the tip) was already right and the replay ends there.
+static void predict_replay_step(qk_phys_world_t *world) {
+    for (u32 n = 0; n < CL_REPLAY_BUDGET && s_replay_seq < s_cmd_sequence; n++) {
+        u32 idx = s_replay_seq % CL_CMD_BUFFER_SIZE;
+        cl_stored_cmd_t *stored = &s_cmd_buffer[idx];
+        if (stored->sequence != s_replay_seq) break;
 
-    qk_player_state_t server_state;
-    if (!qk_net_client_get_server_player_state(&server_state)) return;
+        qk_physics_move(&s_replay_ps, &stored->cmd, world);
 
-    // Find predicted state for ack_sequence
-    u32 ack_idx = ack % CL_CMD_BUFFER_SIZE;
-    cl_predicted_state_t *predicted = &s_pred_history[ack_idx];
-    if (predicted->sequence != ack) {
-        s_last_reconciled_ack = ack;
-        return;
-    }
+        cl_predicted_state_t *hist = &s_pred_history[idx];
+        bool converged = hist->sequence == s_replay_seq
+                      && predict_physics_match(&s_replay_ps, &hist->state);
+        hist->state = s_replay_ps;
+        hist->sequence = s_replay_seq;
+        s_replay_seq++;
 
-    // Always sync authoritative gameplay state from server
-    // (weapon, ammo, health, alive_state, etc.) so changes
-    // are visible immediately even when standing still.
-    s_predicted_ps.weapon          = server_state.weapon;
-    s_predicted_ps.pending_weapon  = server_state.pending_weapon;
-    s_predicted_ps.weapon_time     = server_state.weapon_time;
-    s_predicted_ps.switch_time     = server_state.switch_time;
-    memcpy(s_predicted_ps.ammo, server_state.ammo, sizeof(server_state.ammo));
-    s_predicted_ps.health          = server_state.health;
-    s_predicted_ps.armor           = server_state.armor;
-    s_predicted_ps.alive_state     = server_state.alive_state;
-    s_predicted_ps.frags           = server_state.frags;
-    s_predicted_ps.deaths          = server_state.deaths;
-    s_predicted_ps.damage_given    = server_state.damage_given;
-    s_predicted_ps.damage_taken    = server_state.damage_taken;
-    s_predicted_ps.respawn_time    = server_state.respawn_time;
-
-    // Compare positions (epsilon = 0.1 units squared)
-    f32 delta_x = server_state.origin.x - predicted->state.origin.x;
-    f32 delta_y = server_state.origin.y - predicted->state.origin.y;
-    f32 delta_z = server_state.origin.z - predicted->state.origin.z;
-    f32 dist_sq = delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
-
-    // Detect teleport: snap input angles to server-provided view direction
-    if (server_state.teleport_bit != s_predicted_ps.teleport_bit) {
-        qk_input_set_angles(server_state.pitch, server_state.yaw);
+        if (converged) {
+            s_replaying = false;
+            return;
+        }
     }
 
-    if (dist_sq < 0.1f) {
-        s_last_reconciled_ack = ack;
-        return;  // Position matches, no replay needed
+    // Budget ran out: continue next frame
+    u32 idx = s_replay_seq % CL_CMD_BUFFER_SIZE;
+    if (s_replay_seq < s_cmd_sequence && s_cmd_buffer[idx].sequence == s_replay_seq) return;
+
+    // Caught up with the tip (or the command buffer ran dry): adopt the
+    // corrected chain, keeping the rendered position where it was
+    vec3_t shown = cl_predict_get_render_origin();
+    predict_copy_gameplay(&s_replay_ps, &s_predicted_ps);
+    s_replay_ps.teleport_bit = s_predicted_ps.teleport_bit;
+    s_predicted_ps = s_replay_ps;
+    s_replaying = false;
+
+    vec3_t offset = vec3_sub(shown, vec3_add(s_predicted_ps.origin,
+                                             vec3_scale(s_predicted_ps.velocity, s_accumulator)));
+    f32 snap_sq = s_smooth_snap_dist * s_smooth_snap_dist;
+    if (s_snap_next || s_smooth_half_life <= 0.0f || vec3_dot(offset, offset) > snap_sq) {
+        offset = (vec3_t){0};
     }
+    s_error_offset = offset;
+    s_snap_next = false;
+}
 
-    // Position misprediction: snap to server state and replay
-    s_predicted_ps = server_state;
+void cl_predict_reconcile(qk_phys_world_t *world) {
+    if (!s_has_prediction) return;
 
-    for (u32 seq = ack + 1; seq < s_cmd_sequence; seq++) {
-        u32 idx = seq % CL_CMD_BUFFER_SIZE;
-        cl_stored_cmd_t *stored = &s_cmd_buffer[idx];
-        if (stored->sequence != seq) break;
+    u32 ack = qk_net_client_get_server_cmd_ack();
+    qk_player_state_t server_state;
+    if (ack > s_last_reconciled_ack
+        && qk_net_client_get_server_player_state(&server_state)) {
+        s_last_reconciled_ack = ack;
 
-        qk_physics_move(&s_predicted_ps, &stored->cmd, world);
+        // Sync gameplay state every ack so changes are visible
+        // immediately even when standing still
+        predict_copy_gameplay(&s_predicted_ps, &server_state);
+
+        // Detect teleport: snap input angles to server-provided view direction
+        if (server_state.teleport_bit != s_predicted_ps.teleport_bit) {
+            qk_input_set_angles(server_state.pitch, server_state.yaw);
+            s_predicted_ps.teleport_bit = server_state.teleport_bit;
+            s_error_offset = (vec3_t){0};
+            s_snap_next = true;
+        }
 
-        s_pred_history[idx].state = s_predicted_ps;
-        s_pred_history[idx].sequence = seq;
+        u32 ack_idx = ack % CL_CMD_BUFFER_SIZE;
+        cl_predicted_state_t *predicted = &s_pred_history[ack_idx];
+        if (predicted->sequence == ack) {
+            if (!predict_physics_match(&server_state, &predicted->state)) {
+                // Misprediction: restart the replay from the server state.
+                // Any replay still in progress is superseded.
+                s_replay_ps = server_state;
+                s_replay_seq = ack + 1;
+                s_replaying = true;
+            } else if (s_replaying && s_replay_seq <= ack) {
+                // Server agrees with the old chain at a tick the pending
+                // replay has not reached, so the old chain stands
+                s_replaying = false;
+            }
+        }
     }
 
-    s_last_reconciled_ack = ack;
+    if (s_replaying) predict_replay_step(world);
+    if (!s_replaying) s_snap_next = false;
 }
 
 // --- Getters ---
@@ -164,6 +275,13 @@ qk_player_state_t *cl_predict_get_state_mut(void) {
     return &s_predicted_ps;
 }
 
+vec3_t cl_predict_get_render_origin(void) {
+    // Extrapolate through the partial tick, then add the decaying error
+    vec3_t pos = vec3_add(s_predicted_ps.origin,
+                          vec3_scale(s_predicted_ps.velocity, s_accumulator));
+    return vec3_add(pos, s_error_offset);
+}
+
 bool cl_predict_has_state(void) {
     return s_has_prediction;
 }
@@ -3,23 +3,145 @@
  *
  * Simple bump allocator with 16-byte alignment.
  * This is NOT a stub -- all modules depend on it for memory allocation.
+ *
+ * Backing store is reserved address space (VirtualAlloc / mmap PROT_NONE),
+ * committed in ARENA_COMMIT_CHUNK steps as allocations reach it. Nothing
+ * is memset: the OS hands out zeroed pages on first commit.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE     // MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE
+#endif
+
 #include "qk_arena.h"
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef QK_PLATFORM_WINDOWS
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+#define ARENA_COMMIT_CHUNK  ((u64)64 * 1024)
+#define ARENA_HUGE_PAGE     ((u64)2 * 1024 * 1024)
+
 struct qk_arena {
     u8     *base;
     u64     size;
     u64     offset;
+    u64     committed;
+    u64     high_water;
+    u64     commit_chunk;
+    bool    huge_pages;
 };
 
-qk_arena_t *qk_arena_create(u64 size) {
+static u64 align_up(u64 value, u64 align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+// --- Platform ---
+
+static u8 *arena_reserve(u64 size, bool huge, bool hugetlb, bool *out_huge,
+                         bool *out_committed) {
+    *out_huge = false;
+    *out_committed = false;
+
+#ifdef QK_PLATFORM_WINDOWS
+    QK_UNUSED(hugetlb);
+    if (huge) {
+        // Large pages must be committed at reservation time and need
+        // SeLockMemoryPrivilege; fall through to small pages if refused
+        SIZE_T large = GetLargePageMinimum();
+        if (large > 0) {
+            void *p = VirtualAlloc(NULL, (SIZE_T)align_up(size, large),
+                                   MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE);
+            if (p) {
+                *out_huge = true;
+                *out_committed = true;
+                return (u8 *)p;
+            }
+        }
+    }
+    return (u8 *)VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    #ifdef MAP_HUGETLB
+    if (hugetlb) {
+        // Pool pages are reserved now (mmap fails if the pool is short,
+        // rather than faulting later) and come back zeroed
+        void *p = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            *out_huge = true;
+            *out_committed = true;
+            return (u8 *)p;
+        }
+    }
+    #else
+    QK_UNUSED(hugetlb);
+    #endif
+
+    if (!huge) {
+        void *p = mmap(NULL, (size_t)size, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return p == MAP_FAILED ? NULL : (u8 *)p;
+    }
+
+    // THP only backs 2 MB-aligned ranges: over-reserve and trim to alignment
+    u64 span = size + ARENA_HUGE_PAGE;
+    u8 *raw = (u8 *)mmap(NULL, (size_t)span, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == (u8 *)MAP_FAILED) return NULL;
+    u8 *p = (u8 *)(uintptr_t)align_up((u64)(uintptr_t)raw, ARENA_HUGE_PAGE);
+    if (p > raw) munmap(raw, (size_t)(p - raw));
+    if (p + size < raw + span) munmap(p + size, (size_t)(raw + span - (p + size)));
+
+    #ifdef MADV_HUGEPAGE
+    // Transparent huge pages: a hint, silently ignored if THP is off
+    if (madvise(p, (size_t)size, MADV_HUGEPAGE) == 0) {
+        *out_huge = true;
+    }
+    #endif
+    return p;
+#endif
+}
+
+static bool arena_commit(u8 *addr, u64 size) {
+#ifdef QK_PLATFORM_WINDOWS
+    return VirtualAlloc(addr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(addr, (size_t)size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+static void arena_release(u8 *base, u64 size) {
+#ifdef QK_PLATFORM_WINDOWS
+    QK_UNUSED(size);
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, (size_t)size);
+#endif
+}
+
+// --- Public API ---
+
+qk_arena_t *qk_arena_create_ex(u64 size, u32 flags) {
+    if (size == 0) return NULL;
+
     qk_arena_t *arena = (qk_arena_t *)malloc(sizeof(qk_arena_t));
     if (!arena) return NULL;
 
-    arena->base = (u8 *)malloc((size_t)size);
+    bool want_hugetlb = (flags & QK_ARENA_HUGETLB) != 0;
+    bool want_huge = want_hugetlb || (flags & QK_ARENA_HUGE_PAGES) != 0;
+    u64 chunk = want_huge ? ARENA_HUGE_PAGE : ARENA_COMMIT_CHUNK;
+    size = align_up(size, chunk);
+
+    bool huge, committed;
+    arena->base = arena_reserve(size, want_huge, want_hugetlb, &huge, &committed);
     if (!arena->base) {
         free(arena);
         return NULL;
@@ -27,32 +149,105 @@ qk_arena_t *qk_arena_create(u64 size) {
 
     arena->size = size;
     arena->offset = 0;
-    memset(arena->base, 0, (size_t)size);
+    arena->committed = committed ? size : 0;
+    arena->high_water = 0;
+    arena->commit_chunk = chunk;
+    arena->huge_pages = huge;
     return arena;
 }
 
-void *qk_arena_alloc(qk_arena_t *arena, u64 size) {
+qk_arena_t *qk_arena_create(u64 size) {
+    return qk_arena_create_ex(size, 0);
+}
+
+void *qk_arena_alloc_aligned(qk_arena_t *arena, u64 size, u64 align) {
     QK_ASSERT(arena != NULL);
+    QK_ASSERT(align > 0 && (align & (align - 1)) == 0);
 
-    // Align to 16 bytes
-    u64 aligned_offset = (arena->offset + 15) & ~(u64)15;
+    u64 aligned_offset = align_up(arena->offset, align);
     if (aligned_offset + size > arena->size) {
         return NULL;
     }
 
-    void *ptr = arena->base + aligned_offset;
-    arena->offset = aligned_offset + size;
-    return ptr;
+    u64 end = aligned_offset + size;
+    if (end > arena->committed) {
+        u64 new_committed = align_up(end, arena->commit_chunk);
+        if (new_committed > arena->size) new_committed = arena->size;
+        if (!arena_commit(arena->base + arena->committed,
+                          new_committed - arena->committed)) {
+            return NULL;
+        }
+        arena->committed = new_committed;
+    }
+
+    arena->offset = end;
+    if (end > arena->high_water) arena->high_water = end;
+    return arena->base + aligned_offset;
+}
+
+bool qk_arena_prefault(qk_arena_t *arena, u64 size) {
+    QK_ASSERT(arena != NULL);
+    if (size == 0 || size > arena->size) size = arena->size;
+
+    u64 target = align_up(size, arena->commit_chunk);
+    if (target > arena->size) target = arena->size;
+    if (target > arena->committed) {
+        if (!arena_commit(arena->base + arena->committed, target - arena->committed)) {
+            return false;
+        }
+        arena->committed = target;
+    }
+
+    // One write per 4 KB page. Pages past the offset are free, so they may
+    // be written; pages in use already hold data and are left alone.
+    volatile u8 *p = arena->base;
+    for (u64 at = align_up(arena->offset, 4096); at < target; at += 4096) {
+        p[at] = 0;
+    }
+    return true;
+}
+
+void *qk_arena_alloc(qk_arena_t *arena, u64 size) {
+    // Align to 16 bytes
+    return qk_arena_alloc_aligned(arena, size, 16);
 }
 
 void qk_arena_reset(qk_arena_t *arena) {
     QK_ASSERT(arena != NULL);
     arena->offset = 0;
+    arena->high_water = 0;
+}
+
+qk_arena_marker_t qk_arena_mark(const qk_arena_t *arena) {
+    QK_ASSERT(arena != NULL);
+    return (qk_arena_marker_t){ .offset = arena->offset };
+}
+
+void qk_arena_pop(qk_arena_t *arena, qk_arena_marker_t marker) {
+    QK_ASSERT(arena != NULL);
+    QK_ASSERT(marker.offset <= arena->offset);
+    arena->offset = marker.offset;
+}
+
+u64 qk_arena_used(const qk_arena_t *arena) {
+    return arena ? arena->offset : 0;
+}
+
+u64 qk_arena_high_water(const qk_arena_t *arena) {
+    return arena ? arena->high_water : 0;
+}
+
+u64 qk_arena_capacity(const qk_arena_t *arena) {
+    return arena ? arena->size : 0;
+}
+
+bool qk_arena_has_huge_pages(const qk_arena_t *arena) {
+    return arena ? arena->huge_pages : false;
 }
 
 void qk_arena_destroy(qk_arena_t *arena) {
     if (arena) {
-        free(arena->base);
+        arena_release(arena->base, arena->size);
         free(arena);
     }
 }
@@ -2,44 +2,88 @@
  * QUICKEN Engine - Console Variable (Cvar) System
  *
  * Static array registry, typed setters with range clamping + callbacks.
+ * Name lookup goes through an open-addressed (linear probe) index over the
+ * array; cvars are never unregistered, so there are no tombstones.
  */
 
 #include "core/qk_cvar.h"
+#include "core/qk_hash.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+_Static_assert((QK_CVAR_HASH_SIZE & (QK_CVAR_HASH_SIZE - 1)) == 0,
+               "QK_CVAR_HASH_SIZE must be a power of two");
+_Static_assert(QK_CVAR_HASH_SIZE >= 2 * QK_CVAR_MAX_COUNT,
+               "cvar hash table too small for QK_CVAR_MAX_COUNT");
+
 static qk_cvar_t s_cvars[QK_CVAR_MAX_COUNT];
 static u32 s_cvar_count;
+static u16 s_cvar_index[QK_CVAR_HASH_SIZE];    // s_cvars index + 1, 0 = empty
+static u32 s_global_generation;
+
+// Deferred callbacks, in change order; callback_pending dedupes
+static qk_cvar_t *s_pending[QK_CVAR_MAX_COUNT];
+static u32 s_pending_count;
 
 void qk_cvar_init(void) {
     memset(s_cvars, 0, sizeof(s_cvars));
+    memset(s_cvar_index, 0, sizeof(s_cvar_index));
     s_cvar_count = 0;
+    s_pending_count = 0;
+    s_global_generation = 0;
 }
 
 void qk_cvar_shutdown(void) {
+    memset(s_cvar_index, 0, sizeof(s_cvar_index));
     s_cvar_count = 0;
+    s_pending_count = 0;
 }
 
 // --- Internal Helpers ---
 
+// Returns the index slot holding name, or the empty slot where it would go
+static u16 *cvar_index_slot(const char *name) {
+    u32 mask = QK_CVAR_HASH_SIZE - 1;
+    u32 h = qk_hash_str(name) & mask;
+    for (;;) {
+        u16 *slot = &s_cvar_index[h];
+        if (*slot == 0 || strcmp(s_cvars[*slot - 1].name, name) == 0) return slot;
+        h = (h + 1) & mask;
+    }
+}
+
 static qk_cvar_t *cvar_alloc(const char *name) {
-    if (s_cvar_count >= QK_CVAR_MAX_COUNT) return NULL;
+    // Duplicate registration returns the existing cvar
+    u16 *slot = cvar_index_slot(name);
+    if (*slot) return &s_cvars[*slot - 1];
 
-    // Check for duplicate
-    for (u32 i = 0; i < s_cvar_count; i++) {
-        if (s_cvars[i].in_use && strcmp(s_cvars[i].name, name) == 0) {
-            return &s_cvars[i];
-        }
-    }
+    if (s_cvar_count >= QK_CVAR_MAX_COUNT) return NULL;
 
     qk_cvar_t *cv = &s_cvars[s_cvar_count++];
     memset(cv, 0, sizeof(*cv));
     cv->in_use = true;
     snprintf(cv->name, QK_CVAR_NAME_LEN, "%s", name);
+
+    // Index by the stored (possibly truncated) name so lookups agree
+    slot = cvar_index_slot(cv->name);
+    *slot = (u16)s_cvar_count;
     return cv;
 }
 
+// Records a value change: bumps generations and queues the callback
+static void cvar_changed(qk_cvar_t *cvar) {
+    cvar->generation++;
+    s_global_generation++;
+
+    // A full queue can only mean callbacks feeding each other in a loop
+    if (cvar->callback && !cvar->callback_pending &&
+        s_pending_count < QK_CVAR_MAX_COUNT) {
+        cvar->callback_pending = true;
+        s_pending[s_pending_count++] = cvar;
+    }
+}
+
 // --- Registration ---
 
 qk_cvar_t *qk_cvar_register_float(const char *name, f32 default_val,
@@ -108,12 +152,25 @@ qk_cvar_t *qk_cvar_register_string(const char *name, const char *default_val,
 
 qk_cvar_t *qk_cvar_find(const char *name) {
     if (!name) return NULL;
-    for (u32 i = 0; i < s_cvar_count; i++) {
-        if (s_cvars[i].in_use && strcmp(s_cvars[i].name, name) == 0) {
-            return &s_cvars[i];
-        }
+    u16 *slot = cvar_index_slot(name);
+    return *slot ? &s_cvars[*slot - 1] : NULL;
+}
+
+// --- Change Tracking ---
+
+u32 qk_cvar_global_generation(void) {
+    return s_global_generation;
+}
+
+void qk_cvar_dispatch_callbacks(void) {
+    // Callbacks may change other cvars; those are appended and run in
+    // this same pass. A cvar re-queues only after its own callback ran.
+    for (u32 i = 0; i < s_pending_count; i++) {
+        qk_cvar_t *cv = s_pending[i];
+        cv->callback_pending = false;
+        cv->callback(cv);
     }
-    return NULL;
+    s_pending_count = 0;
 }
 
 // --- Setters ---
@@ -127,8 +184,10 @@ bool qk_cvar_set_float(qk_cvar_t *cvar, f32 value) {
         if (value > cvar->max_val) value = cvar->max_val;
     }
 
-    cvar->value.f = value;
-    if (cvar->callback) cvar->callback(cvar);
+    if (cvar->value.f != value) {
+        cvar->value.f = value;
+        cvar_changed(cvar);
+    }
     return true;
 }
 
@@ -141,8 +200,10 @@ bool qk_cvar_set_int(qk_cvar_t *cvar, i32 value) {
         if (value > (i32)cvar->max_val) value = (i32)cvar->max_val;
     }
 
-    cvar->value.i = value;
-    if (cvar->callback) cvar->callback(cvar);
+    if (cvar->value.i != value) {
+        cvar->value.i = value;
+        cvar_changed(cvar);
+    }
     return true;
 }
 
@@ -150,8 +211,10 @@ bool qk_cvar_set_bool(qk_cvar_t *cvar, bool value) {
     if (!cvar || cvar->type != QK_CVAR_BOOL) return false;
     if (cvar->flags & QK_CVAR_READONLY) return false;
 
-    cvar->value.b = value;
-    if (cvar->callback) cvar->callback(cvar);
+    if (cvar->value.b != value) {
+        cvar->value.b = value;
+        cvar_changed(cvar);
+    }
     return true;
 }
 
@@ -159,8 +222,12 @@ bool qk_cvar_set_string(qk_cvar_t *cvar, const char *value) {
     if (!cvar || cvar->type != QK_CVAR_STRING) return false;
     if (cvar->flags & QK_CVAR_READONLY) return false;
 
-    snprintf(cvar->value.s, QK_CVAR_STRING_LEN, "%s", value ? value : "");
-    if (cvar->callback) cvar->callback(cvar);
+    char next[QK_CVAR_STRING_LEN];
+    snprintf(next, QK_CVAR_STRING_LEN, "%s", value ? value : "");
+    if (strcmp(cvar->value.s, next) != 0) {
+        memcpy(cvar->value.s, next, QK_CVAR_STRING_LEN);
+        cvar_changed(cvar);
+    }
     return true;
 }
 
@@ -188,14 +255,11 @@ void qk_cvar_reset(qk_cvar_t *cvar) {
     if (cvar->flags & QK_CVAR_READONLY) return;
 
     switch (cvar->type) {
-    case QK_CVAR_FLOAT:  cvar->value.f = cvar->default_value.f; break;
-    case QK_CVAR_INT:    cvar->value.i = cvar->default_value.i; break;
-    case QK_CVAR_BOOL:   cvar->value.b = cvar->default_value.b; break;
-    case QK_CVAR_STRING:
-        snprintf(cvar->value.s, QK_CVAR_STRING_LEN, "%s", cvar->default_value.s);
-        break;
+    case QK_CVAR_FLOAT:  qk_cvar_set_float(cvar, cvar->default_value.f); break;
+    case QK_CVAR_INT:    qk_cvar_set_int(cvar, cvar->default_value.i); break;
+    case QK_CVAR_BOOL:   qk_cvar_set_bool(cvar, cvar->default_value.b); break;
+    case QK_CVAR_STRING: qk_cvar_set_string(cvar, cvar->default_value.s); break;
     }
-    if (cvar->callback) cvar->callback(cvar);
 }
 
 // --- Iteration ---
@@ -8,6 +8,7 @@
  */
 
 #include "core/qk_demo.h"
+#include "core/qk_scratch.h"
 #include "gameplay/qk_gameplay.h"
 #include "netcode/qk_netcode.h"
 
@@ -272,8 +273,13 @@ bool qk_demo_play_tick(u32 current_tick) {
             memcpy(snap_mask, payload + 8, QK_DEMO_MASK_U64S * 8);
 
             // Reconstruct full entity array from sparse data
-            n_entity_state_t entities[DEMO_MAX_ENTITIES];
-            memset(entities, 0, sizeof(entities));
+            qk_arena_t *scratch = qk_scratch(QK_SCRATCH_FRAME);
+            if (!scratch) break;
+            qk_arena_marker_t mark = qk_arena_mark(scratch);
+            u64 entities_size = DEMO_MAX_ENTITIES * sizeof(n_entity_state_t);
+            n_entity_state_t *entities = (n_entity_state_t *)qk_arena_alloc(scratch, entities_size);
+            if (!entities) break;
+            memset(entities, 0, (size_t)entities_size);
 
             u32 offset = 40;
             for (u32 i = 0; i < DEMO_MAX_ENTITIES; i++) {
@@ -290,6 +296,7 @@ bool qk_demo_play_tick(u32 current_tick) {
 
             qk_net_client_inject_demo_snapshot(
                 snap_tick, snap_entity_count, snap_mask, entities);
+            qk_arena_pop(scratch, mark);
             break;
         }
         case QK_DEMO_RECORD_USERCMD:
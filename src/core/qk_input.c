@@ -3,6 +3,16 @@
  *
  * Polls SDL3 events, tracks key state, mouse delta, and builds usercmds.
  * Mouse is captured (relative mode) for FPS-style control.
+ *
+ * Aim-relevant events (mouse motion, attack and jump presses) are captured
+ * by an SDL event watch the moment SDL receives them -- on Windows that is
+ * SDL's raw input thread in relative mode, elsewhere the pump on the main
+ * thread -- and pushed with their SDL timestamp into a single-producer
+ * lock-free ring. Building a usercmd consumes exactly the events that
+ * happened before that tick ended, so each tick's view angles contain only
+ * its own motion and presses carry their sub-tick offset and the angles at
+ * that instant. Events past the tick stay queued for the next one; the
+ * camera sees them immediately through the view angles.
  */
 
 #include "core/qk_input.h"
@@ -11,6 +21,7 @@
 
 #include "ui/qk_console.h"
 #include "core/qk_cvar.h"
+#include "core/qk_atomic.h"
 #include <SDL3/SDL.h>
 #include <string.h>
 #include <math.h>
@@ -22,8 +33,11 @@ static i32     s_mouse_dx;
 static i32     s_mouse_dy;
 static bool    s_quit_requested;
 static bool    s_mouse_captured;
-static f32     s_yaw;
+static f32     s_yaw;              // through the last built tick
 static f32     s_pitch;
+static f32     s_view_yaw;         // including motion not yet in a tick
+static f32     s_view_pitch;
+static f32     s_sens = 0.022f;
 
 // Cached cvar pointer for zero-overhead reads
 static qk_cvar_t *s_cvar_sensitivity;
@@ -31,11 +45,141 @@ static qk_cvar_t *s_cvar_sensitivity;
 static const f32 QK_PITCH_MIN = -89.0f;
 static const f32 QK_PITCH_MAX =  89.0f;
 
+// --- Event Ring (event watch -> main thread) ---
+
+#define INPUT_RING_SIZE 4096    // power of two; ~0.5 s of 8 kHz mouse
+
+typedef enum {
+    INPUT_EV_MOTION = 0,
+    INPUT_EV_ATTACK,
+    INPUT_EV_JUMP
+} input_ev_type_t;
+
+typedef struct {
+    u64     time_ns;            // SDL event timestamp
+    f32     dx, dy;
+    u32     type;               // input_ev_type_t
+} input_event_t;
+
+// Gate bits, written by the main thread, read by the watch
+enum {
+    INPUT_GATE_BUTTONS = (1 << 0),  // console closed
+    INPUT_GATE_MOTION  = (1 << 1),  // console closed and mouse captured
+};
+
+static input_event_t    s_ring[INPUT_RING_SIZE];
+static qk_atomic_i32_t  s_ring_head;    // producer
+static qk_atomic_i32_t  s_ring_tail;    // consumer (main thread)
+static qk_atomic_i32_t  s_gate;
+static bool             s_watch_installed;
+
+// SDL serializes event watchers under one lock, so whichever thread SDL
+// delivers from, there is only ever one producer at a time.
+static void input_ring_push(u32 type, u64 time_ns, f32 dx, f32 dy) {
+    i32 head = qk_atomic_load_i32(&s_ring_head);
+    i32 tail = qk_atomic_load_i32(&s_ring_tail);
+    if ((u32)(head - tail) >= INPUT_RING_SIZE) return;  // full: drop
+
+    s_ring[(u32)head & (INPUT_RING_SIZE - 1)] = (input_event_t){
+        .time_ns = time_ns, .dx = dx, .dy = dy, .type = type,
+    };
+    qk_atomic_store_i32(&s_ring_head, head + 1);
+}
+
+static bool SDLCALL input_event_watch(void *userdata, SDL_Event *event) {
+    QK_UNUSED(userdata);
+    i32 gate = qk_atomic_load_i32(&s_gate);
+
+    switch (event->type) {
+    case SDL_EVENT_MOUSE_MOTION:
+        if (gate & INPUT_GATE_MOTION) {
+            input_ring_push(INPUT_EV_MOTION, event->motion.timestamp,
+                            event->motion.xrel, event->motion.yrel);
+        }
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        if ((gate & INPUT_GATE_BUTTONS) && event->button.button == SDL_BUTTON_LEFT) {
+            input_ring_push(INPUT_EV_ATTACK, event->button.timestamp, 0.0f, 0.0f);
+        }
+        break;
+    case SDL_EVENT_KEY_DOWN:
+        if ((gate & INPUT_GATE_BUTTONS) && !event->key.repeat &&
+            event->key.scancode == SDL_SCANCODE_SPACE) {
+            input_ring_push(INPUT_EV_JUMP, event->key.timestamp, 0.0f, 0.0f);
+        }
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+static void input_update_gate(bool console_open) {
+    i32 gate = 0;
+    if (!console_open) gate |= INPUT_GATE_BUTTONS;
+    if (!console_open && s_mouse_captured) gate |= INPUT_GATE_MOTION;
+    qk_atomic_store_i32(&s_gate, gate);
+}
+
+static void input_rotate(f32 *pitch, f32 *yaw, f32 dx, f32 dy) {
+    *yaw -= dx * s_sens;
+    *pitch -= dy * s_sens;
+
+    while (*yaw < 0.0f) *yaw += 360.0f;
+    while (*yaw >= 360.0f) *yaw -= 360.0f;
+
+    if (*pitch < QK_PITCH_MIN) *pitch = QK_PITCH_MIN;
+    if (*pitch > QK_PITCH_MAX) *pitch = QK_PITCH_MAX;
+}
+
+// Fold everything still queued into the view angles the camera uses
+static void input_update_view(void) {
+    s_view_pitch = s_pitch;
+    s_view_yaw = s_yaw;
+
+    i32 head = qk_atomic_load_i32(&s_ring_head);
+    i32 tail = qk_atomic_load_i32(&s_ring_tail);
+    for (i32 i = tail; i != head; i++) {
+        const input_event_t *ev = &s_ring[(u32)i & (INPUT_RING_SIZE - 1)];
+        if (ev->type == INPUT_EV_MOTION) {
+            input_rotate(&s_view_pitch, &s_view_yaw, ev->dx, ev->dy);
+        }
+    }
+}
+
+// When no usercmds are being built (menus, connecting) nothing drains the
+// ring; retire the oldest half so the producer never has to drop.
+static void input_trim_ring(void) {
+    i32 head = qk_atomic_load_i32(&s_ring_head);
+    i32 tail = qk_atomic_load_i32(&s_ring_tail);
+    if ((u32)(head - tail) < INPUT_RING_SIZE / 2) return;
+
+    i32 keep_from = head - (i32)(INPUT_RING_SIZE / 4);
+    for (; tail != keep_from; tail++) {
+        const input_event_t *ev = &s_ring[(u32)tail & (INPUT_RING_SIZE - 1)];
+        if (ev->type == INPUT_EV_MOTION) {
+            input_rotate(&s_pitch, &s_yaw, ev->dx, ev->dy);
+        }
+    }
+    qk_atomic_store_i32(&s_ring_tail, tail);
+}
+
 void qk_input_poll(qk_input_state_t *state) {
     s_mouse_dx = 0;
     s_mouse_dy = 0;
 
+    if (!s_watch_installed) {
+        s_watch_installed = SDL_AddEventWatch(input_event_watch, NULL);
+    }
+
     bool console_open = qk_console_is_open();
+    input_update_gate(console_open);
+
+    // Lazy-cache the sensitivity cvar pointer
+    if (!s_cvar_sensitivity) {
+        s_cvar_sensitivity = qk_cvar_find("sensitivity");
+    }
+    s_sens = s_cvar_sensitivity ? s_cvar_sensitivity->value.f : 0.022f;
 
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
@@ -65,6 +209,7 @@ void qk_input_poll(qk_input_state_t *state) {
                         SDL_StopTextInput(win);
                     }
                 }
+                input_update_gate(console_open);
                 break;
             }
 
@@ -79,6 +224,7 @@ void qk_input_poll(qk_input_state_t *state) {
                     if (win) {
                         SDL_StopTextInput(win);
                     }
+                    input_update_gate(console_open);
                 }
                 break;
             }
@@ -94,6 +240,7 @@ void qk_input_poll(qk_input_state_t *state) {
                 } else {
                     s_quit_requested = true;
                 }
+                input_update_gate(console_open);
             }
             break;
 
@@ -120,6 +267,7 @@ void qk_input_poll(qk_input_state_t *state) {
             if (!s_mouse_captured) {
                 SDL_SetWindowRelativeMouseMode(SDL_GetKeyboardFocus(), true);
                 s_mouse_captured = true;
+                input_update_gate(console_open);
             }
             break;
 
@@ -131,6 +279,7 @@ void qk_input_poll(qk_input_state_t *state) {
             break;
 
         case SDL_EVENT_MOUSE_MOTION:
+            // Angles come from the ring; this is only the per-frame total
             if (s_mouse_captured && !console_open) {
                 s_mouse_dx += (i32)event.motion.xrel;
                 s_mouse_dy += (i32)event.motion.yrel;
@@ -145,23 +294,8 @@ void qk_input_poll(qk_input_state_t *state) {
         }
     }
 
-    // Update view angles from mouse (only when not in console)
-    if (s_mouse_captured && !console_open) {
-        // Lazy-cache the sensitivity cvar pointer
-        if (!s_cvar_sensitivity) {
-            s_cvar_sensitivity = qk_cvar_find("sensitivity");
-        }
-        f32 sens = s_cvar_sensitivity ? s_cvar_sensitivity->value.f : 0.022f;
-
-        s_yaw -= (f32)s_mouse_dx * sens;
-        s_pitch -= (f32)s_mouse_dy * sens;
-
-        while (s_yaw < 0.0f) s_yaw += 360.0f;
-        while (s_yaw >= 360.0f) s_yaw -= 360.0f;
-
-        if (s_pitch < QK_PITCH_MIN) s_pitch = QK_PITCH_MIN;
-        if (s_pitch > QK_PITCH_MAX) s_pitch = QK_PITCH_MAX;
-    }
+    input_trim_ring();
+    input_update_view();
 
     console_open = qk_console_is_open();
 
@@ -172,10 +306,64 @@ void qk_input_poll(qk_input_state_t *state) {
         memcpy(state->mouse_buttons, s_mouse_buttons, sizeof(s_mouse_buttons));
         state->quit_requested = s_quit_requested;
         state->console_active = console_open;
+        state->poll_time_ns = SDL_GetTicksNS();
     }
 }
 
-qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time) {
+// Consume the events that happened before tick_end_ns: motion turns the
+// tick's view angles, and the first attack and jump press are stamped with
+// their sub-tick offset. A stamped press also sets its button, so a click
+// released within the same frame still fires. A press still queued after
+// this tick masks its button instead: in tick time it has not happened yet.
+// Presses more than a tick older than this tick (ring backlog from menus)
+// are dropped rather than fired late.
+static void input_consume_tick(qk_usercmd_t *cmd, u64 tick_end_ns, bool take_presses) {
+    u64 tick_ns = (u64)(QK_TICK_DT_F64 * 1e9);
+    u64 tick_start_ns = tick_end_ns > tick_ns ? tick_end_ns - tick_ns : 0;
+
+    i32 head = qk_atomic_load_i32(&s_ring_head);
+    i32 tail = qk_atomic_load_i32(&s_ring_tail);
+
+    for (; tail != head; tail++) {
+        const input_event_t *ev = &s_ring[(u32)tail & (INPUT_RING_SIZE - 1)];
+        if (ev->time_ns >= tick_end_ns) break;
+
+        if (ev->type == INPUT_EV_MOTION) {
+            input_rotate(&s_pitch, &s_yaw, ev->dx, ev->dy);
+            continue;
+        }
+
+        if (!take_presses || ev->time_ns + tick_ns < tick_start_ns) continue;
+
+        u32 button = ev->type == INPUT_EV_ATTACK ? QK_BUTTON_ATTACK : QK_BUTTON_JUMP;
+        u8 *subtick = ev->type == INPUT_EV_ATTACK ? &cmd->attack_subtick
+                                                  : &cmd->jump_subtick;
+        if (*subtick != QK_SUBTICK_NONE) continue;
+
+        f32 frac = ev->time_ns > tick_start_ns
+            ? (f32)(ev->time_ns - tick_start_ns) / (f32)tick_ns : 0.0f;
+
+        *subtick = qk_subtick_encode(frac);
+        cmd->buttons |= button;
+        if (ev->type == INPUT_EV_ATTACK) {
+            cmd->attack_pitch = s_pitch;
+            cmd->attack_yaw = s_yaw;
+        }
+    }
+    qk_atomic_store_i32(&s_ring_tail, tail);
+
+    for (i32 i = tail; i != head; i++) {
+        const input_event_t *ev = &s_ring[(u32)i & (INPUT_RING_SIZE - 1)];
+        if (ev->type == INPUT_EV_ATTACK && cmd->attack_subtick == QK_SUBTICK_NONE) {
+            cmd->buttons &= ~(u32)QK_BUTTON_ATTACK;
+        } else if (ev->type == INPUT_EV_JUMP && cmd->jump_subtick == QK_SUBTICK_NONE) {
+            cmd->buttons &= ~(u32)QK_BUTTON_JUMP;
+        }
+    }
+}
+
+qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time,
+                                     u64 tick_end_ns) {
     qk_usercmd_t cmd;
     memset(&cmd, 0, sizeof(cmd));
     cmd.server_time = server_time;
@@ -184,6 +372,7 @@ qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_ti
 
     // No game input while console is open
     if (state->console_active) {
+        input_consume_tick(&cmd, tick_end_ns, false);
         cmd.pitch = s_pitch;
         cmd.yaw = s_yaw;
         return cmd;
@@ -208,10 +397,6 @@ qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_ti
     cmd.forward_move = forward;
     cmd.side_move = side;
 
-    // View angles
-    cmd.pitch = s_pitch;
-    cmd.yaw = s_yaw;
-
     // Buttons
     if (state->mouse_buttons[0]) cmd.buttons |= QK_BUTTON_ATTACK;
     if (state->keys[SDL_SCANCODE_SPACE]) cmd.buttons |= QK_BUTTON_JUMP;
@@ -222,6 +407,11 @@ qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_ti
         cmd.buttons |= QK_BUTTON_USE;
     }
 
+    // View angles: this tick's motion only
+    input_consume_tick(&cmd, tick_end_ns, true);
+    cmd.pitch = s_pitch;
+    cmd.yaw = s_yaw;
+
     // Weapon select (number keys)
     if (state->keys[SDL_SCANCODE_1]) cmd.weapon_select = QK_WEAPON_ROCKET;
     if (state->keys[SDL_SCANCODE_2]) cmd.weapon_select = QK_WEAPON_RAIL;
@@ -230,12 +420,13 @@ qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_ti
     return cmd;
 }
 
-f32 qk_input_get_pitch(void) { return s_pitch; }
-f32 qk_input_get_yaw(void) { return s_yaw; }
+f32 qk_input_get_pitch(void) { return s_view_pitch; }
+f32 qk_input_get_yaw(void) { return s_view_yaw; }
 
 void qk_input_set_angles(f32 pitch, f32 yaw) {
     s_pitch = pitch;
     s_yaw = yaw;
+    input_update_view();
 }
 
 #else  // QK_HEADLESS
@@ -248,8 +439,10 @@ void qk_input_poll(qk_input_state_t *state) {
     }
 }
 
-qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time) {
+qk_usercmd_t qk_input_build_usercmd(const qk_input_state_t *state, u32 server_time,
+                                     u64 tick_end_ns) {
     QK_UNUSED(state);
+    QK_UNUSED(tick_end_ns);
     qk_usercmd_t cmd = {0};
     cmd.server_time = server_time;
     return cmd;
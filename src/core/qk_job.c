@@ -0,0 +1,550 @@
+/*
+ * QUICKEN Engine - Job System Implementation
+ *
+ * Chase-Lev work-stealing deques ("Dynamic Circular Work-Stealing Deque",
+ * with the fence placement from Le et al. 2013), fixed capacity per worker.
+ * A full deque runs the job inline rather than growing. Idle workers spin
+ * briefly, then sleep on a condition variable; submitters bump an epoch
+ * counter so a wakeup can never be lost between "found nothing" and "sleep".
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE     // pthread_setaffinity_np, CPU_SET
+#endif
+
+#include "core/qk_job.h"
+#include "core/qk_platform.h"
+#include "core/qk_prof.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef QK_PLATFORM_WINDOWS
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <limits.h>     // PTHREAD_STACK_MIN
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+#define JOB_DEQUE_CAPACITY  1024    // power of two
+#define JOB_DEQUE_MASK      (JOB_DEQUE_CAPACITY - 1)
+#define JOB_SPIN_COUNT      256     // steal attempts before sleeping
+#define JOB_MAX_CHUNKS      128     // parallel_for split limit
+
+_Static_assert((JOB_DEQUE_CAPACITY & JOB_DEQUE_MASK) == 0,
+               "JOB_DEQUE_CAPACITY must be a power of two");
+
+typedef struct {
+    qk_job_fn_t         fn;
+    void               *data;
+    qk_job_counter_t   *counter;
+} job_t;
+
+// top and bottom on separate cache lines: thieves hammer top, owner bottom
+typedef struct {
+    qk_atomic_i64_t     top;
+    u8                  _pad0[56];
+    qk_atomic_i64_t     bottom;
+    u8                  _pad1[56];
+    job_t               jobs[JOB_DEQUE_CAPACITY];
+} job_deque_t;
+
+typedef struct {
+    job_deque_t         deque;
+    u32                 index;
+    u32                 rng;            // victim selection, owner-only
+#ifdef QK_PLATFORM_WINDOWS
+    HANDLE              thread;
+#else
+    pthread_t           thread;
+#endif
+    bool                thread_started;
+    qk_atomic_i64_t     busy_us;        // drained by qk_job_prof_flush
+    qk_atomic_i32_t     jobs_run;
+} job_worker_t;
+
+static struct {
+    job_worker_t       *workers;
+    u32                 worker_count;
+    qk_job_pin_t        pin;
+    bool                initialized;
+    qk_atomic_i32_t     running;
+    qk_atomic_i32_t     epoch;          // bumped on every submit
+    qk_atomic_i32_t     sleepers;
+#ifdef QK_PLATFORM_WINDOWS
+    SRWLOCK             lock;
+    CONDITION_VARIABLE  wake;
+#else
+    pthread_mutex_t     lock;
+    pthread_cond_t      wake;
+#endif
+} s_jobs;
+
+static QK_THREAD_LOCAL u32 s_thread_index = UINT32_MAX;
+
+// --- Platform ---
+
+static u32 job_cpu_count(void) {
+#ifdef QK_PLATFORM_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (u32)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (u32)n : 1;
+#endif
+}
+
+static void job_lock(void) {
+#ifdef QK_PLATFORM_WINDOWS
+    AcquireSRWLockExclusive(&s_jobs.lock);
+#else
+    pthread_mutex_lock(&s_jobs.lock);
+#endif
+}
+
+static void job_unlock(void) {
+#ifdef QK_PLATFORM_WINDOWS
+    ReleaseSRWLockExclusive(&s_jobs.lock);
+#else
+    pthread_mutex_unlock(&s_jobs.lock);
+#endif
+}
+
+static void job_sleep(void) {
+#ifdef QK_PLATFORM_WINDOWS
+    SleepConditionVariableSRW(&s_jobs.wake, &s_jobs.lock, INFINITE, 0);
+#else
+    pthread_cond_wait(&s_jobs.wake, &s_jobs.lock);
+#endif
+}
+
+static void job_yield(void) {
+#ifdef QK_PLATFORM_WINDOWS
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static void job_pin_thread(job_worker_t *w) {
+    if (s_jobs.pin != QK_JOB_PIN_CORES) return;
+    u32 core = w->index % job_cpu_count();
+#ifdef QK_PLATFORM_WINDOWS
+    SetThreadAffinityMask(w->thread, (DWORD_PTR)1 << core);
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)core, &set);
+    pthread_setaffinity_np(w->thread, sizeof(set), &set);
+#endif
+}
+
+// --- Deque ---
+
+// Owner only
+static bool deque_push(job_deque_t *d, const job_t *job) {
+    i64 b = qk_atomic_load_relaxed_i64(&d->bottom);
+    i64 t = qk_atomic_load_i64(&d->top);
+    if (b - t >= JOB_DEQUE_CAPACITY) return false;
+
+    d->jobs[b & JOB_DEQUE_MASK] = *job;
+    qk_atomic_store_i64(&d->bottom, b + 1);     // release publishes the slot
+    return true;
+}
+
+// Owner only
+static bool deque_pop(job_deque_t *d, job_t *out_job) {
+    i64 b = qk_atomic_load_relaxed_i64(&d->bottom) - 1;
+    qk_atomic_store_relaxed_i64(&d->bottom, b);
+    qk_atomic_fence();
+    i64 t = qk_atomic_load_relaxed_i64(&d->top);
+
+    if (t > b) {
+        qk_atomic_store_relaxed_i64(&d->bottom, b + 1);
+        return false;
+    }
+
+    *out_job = d->jobs[b & JOB_DEQUE_MASK];
+    if (t != b) return true;
+
+    // Last item: race any thief for it
+    bool won = qk_atomic_cas_i64(&d->top, t, t + 1);
+    qk_atomic_store_relaxed_i64(&d->bottom, b + 1);
+    return won;
+}
+
+// Any thread
+static bool deque_steal(job_deque_t *d, job_t *out_job) {
+    i64 t = qk_atomic_load_i64(&d->top);
+    qk_atomic_fence();
+    i64 b = qk_atomic_load_i64(&d->bottom);
+    if (t >= b) return false;
+
+    // The slot cannot be recycled until top moves past it, so the copy is
+    // valid exactly when the CAS below succeeds
+    job_t job = d->jobs[t & JOB_DEQUE_MASK];
+    if (!qk_atomic_cas_i64(&d->top, t, t + 1)) return false;
+
+    *out_job = job;
+    return true;
+}
+
+// --- Scheduling ---
+
+static job_worker_t *job_current_worker(void) {
+    u32 idx = s_thread_index;
+    if (!s_jobs.initialized || idx >= s_jobs.worker_count) return NULL;
+    return &s_jobs.workers[idx];
+}
+
+static void job_execute(job_worker_t *self, const job_t *job) {
+#ifdef QK_PROFILE
+    f64 start = qk_platform_time_now();
+#endif
+
+    job->fn(job->data);
+
+#ifdef QK_PROFILE
+    if (self) {
+        i64 us = (i64)((qk_platform_time_now() - start) * 1e6);
+        qk_atomic_add_i64(&self->busy_us, us);
+        qk_atomic_add_i32(&self->jobs_run, 1);
+    }
+#else
+    QK_UNUSED(self);
+#endif
+
+    if (job->counter) qk_atomic_add_i32(&job->counter->pending, -1);
+}
+
+static bool job_steal_any(job_worker_t *self, job_t *out_job) {
+    u32 count = s_jobs.worker_count;
+    u32 start = 0;
+    if (self) {
+        // xorshift32: spread thieves across victims
+        self->rng ^= self->rng << 13;
+        self->rng ^= self->rng >> 17;
+        self->rng ^= self->rng << 5;
+        start = self->rng % count;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        job_worker_t *victim = &s_jobs.workers[(start + i) % count];
+        if (victim == self) continue;
+        if (deque_steal(&victim->deque, out_job)) return true;
+    }
+    return false;
+}
+
+static bool job_try_run_one(job_worker_t *self) {
+    job_t job;
+    bool found = (self && deque_pop(&self->deque, &job)) ||
+                 job_steal_any(self, &job);
+    if (!found) return false;
+
+    job_execute(self, &job);
+    return true;
+}
+
+static void job_wake(u32 count) {
+    qk_atomic_add_i32(&s_jobs.epoch, 1);
+    if (qk_atomic_load_i32(&s_jobs.sleepers) == 0) return;
+
+    job_lock();
+#ifdef QK_PLATFORM_WINDOWS
+    if (count > 1) WakeAllConditionVariable(&s_jobs.wake);
+    else           WakeConditionVariable(&s_jobs.wake);
+#else
+    if (count > 1) pthread_cond_broadcast(&s_jobs.wake);
+    else           pthread_cond_signal(&s_jobs.wake);
+#endif
+    job_unlock();
+}
+
+static void job_worker_loop(job_worker_t *self) {
+    s_thread_index = self->index;
+
+    while (qk_atomic_load_i32(&s_jobs.running)) {
+        if (job_try_run_one(self)) continue;
+
+        // Read the epoch before the last search: any submit after this
+        // point changes it and keeps us awake
+        i32 epoch = qk_atomic_load_i32(&s_jobs.epoch);
+        bool found = false;
+        for (u32 spin = 0; spin < JOB_SPIN_COUNT && !found; spin++) {
+            qk_cpu_pause();
+            found = job_try_run_one(self);
+        }
+        if (found) continue;
+
+        job_lock();
+        qk_atomic_add_i32(&s_jobs.sleepers, 1);
+        while (qk_atomic_load_i32(&s_jobs.epoch) == epoch &&
+               qk_atomic_load_i32(&s_jobs.running)) {
+            job_sleep();
+        }
+        qk_atomic_add_i32(&s_jobs.sleepers, -1);
+        job_unlock();
+    }
+}
+
+#ifdef QK_PLATFORM_WINDOWS
+static DWORD WINAPI job_thread_entry(LPVOID param) {
+    job_worker_loop((job_worker_t *)param);
+    return 0;
+}
+#else
+static void *job_thread_entry(void *param) {
+    job_worker_loop((job_worker_t *)param);
+    return NULL;
+}
+#endif
+
+// --- Public API ---
+
+qk_result_t qk_job_init(const qk_job_config_t *config) {
+    if (s_jobs.initialized) return QK_SUCCESS;
+
+    u32 count = config ? config->worker_count : 0;
+    if (count == 0) count = job_cpu_count();
+    if (count > QK_JOB_MAX_WORKERS) count = QK_JOB_MAX_WORKERS;
+
+    job_worker_t *workers = (job_worker_t *)calloc(count, sizeof(job_worker_t));
+    if (!workers) return QK_ERROR_OUT_OF_MEMORY;
+
+    s_jobs.workers = workers;
+    s_jobs.worker_count = count;
+    s_jobs.pin = config ? config->pin : QK_JOB_PIN_NONE;
+    qk_atomic_store_i32(&s_jobs.running, 1);
+    qk_atomic_store_i32(&s_jobs.epoch, 0);
+    qk_atomic_store_i32(&s_jobs.sleepers, 0);
+
+#ifdef QK_PLATFORM_WINDOWS
+    InitializeSRWLock(&s_jobs.lock);
+    InitializeConditionVariable(&s_jobs.wake);
+#else
+    pthread_mutex_init(&s_jobs.lock, NULL);
+    pthread_cond_init(&s_jobs.wake, NULL);
+#endif
+
+    for (u32 i = 0; i < count; i++) {
+        workers[i].index = i;
+        workers[i].rng = 0x9E3779B9u * (i + 1);
+    }
+
+    // Prime the lazily-initialized clock before any worker reads it
+    (void)qk_platform_time_now();
+
+    s_thread_index = 0;
+    s_jobs.initialized = true;
+
+    u64 stack_size = config ? config->stack_size : 0;
+#ifndef QK_PLATFORM_WINDOWS
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (stack_size > 0) {
+        if (stack_size < (u64)PTHREAD_STACK_MIN) stack_size = (u64)PTHREAD_STACK_MIN;
+        if (pthread_attr_setstacksize(&attr, (size_t)stack_size) != 0) {
+            fprintf(stderr, "[Job] Stack size %llu refused, using default\n",
+                    (unsigned long long)stack_size);
+        }
+    }
+#endif
+
+    for (u32 i = 1; i < count; i++) {
+        job_worker_t *w = &workers[i];
+#ifdef QK_PLATFORM_WINDOWS
+        w->thread = CreateThread(NULL, (SIZE_T)stack_size, job_thread_entry, w,
+                                 stack_size > 0 ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0, NULL);
+        w->thread_started = (w->thread != NULL);
+#else
+        w->thread_started = (pthread_create(&w->thread, &attr, job_thread_entry, w) == 0);
+#endif
+        if (!w->thread_started) {
+            fprintf(stderr, "[Job] Failed to start worker %u\n", i);
+            continue;   // its deque stays empty; others keep working
+        }
+        job_pin_thread(w);
+    }
+#ifndef QK_PLATFORM_WINDOWS
+    pthread_attr_destroy(&attr);
+#endif
+
+    printf("Job system: %u threads%s\n", count,
+           s_jobs.pin == QK_JOB_PIN_CORES ? " (pinned)" : "");
+    return QK_SUCCESS;
+}
+
+void qk_job_shutdown(void) {
+    if (!s_jobs.initialized) return;
+
+    qk_atomic_store_i32(&s_jobs.running, 0);
+    job_lock();
+#ifdef QK_PLATFORM_WINDOWS
+    WakeAllConditionVariable(&s_jobs.wake);
+#else
+    pthread_cond_broadcast(&s_jobs.wake);
+#endif
+    job_unlock();
+
+    for (u32 i = 1; i < s_jobs.worker_count; i++) {
+        job_worker_t *w = &s_jobs.workers[i];
+        if (!w->thread_started) continue;
+#ifdef QK_PLATFORM_WINDOWS
+        WaitForSingleObject(w->thread, INFINITE);
+        CloseHandle(w->thread);
+#else
+        pthread_join(w->thread, NULL);
+#endif
+    }
+
+#ifndef QK_PLATFORM_WINDOWS
+    pthread_cond_destroy(&s_jobs.wake);
+    pthread_mutex_destroy(&s_jobs.lock);
+#endif
+
+    free(s_jobs.workers);
+    memset(&s_jobs, 0, sizeof(s_jobs));
+    s_thread_index = UINT32_MAX;
+}
+
+u32 qk_job_worker_count(void) {
+    return s_jobs.initialized ? s_jobs.worker_count : 1;
+}
+
+u32 qk_job_thread_index(void) {
+    return s_thread_index;
+}
+
+void qk_job_submit(qk_job_fn_t fn, void *data, qk_job_counter_t *counter) {
+    QK_ASSERT(fn != NULL);
+
+    job_t job = { .fn = fn, .data = data, .counter = counter };
+    if (counter) qk_atomic_add_i32(&counter->pending, 1);
+
+    job_worker_t *self = job_current_worker();
+    if (!self || !deque_push(&self->deque, &job)) {
+        job_execute(self, &job);
+        return;
+    }
+    job_wake(1);
+}
+
+void qk_job_wait(qk_job_counter_t *counter) {
+    job_worker_t *self = job_current_worker();
+    u32 idle = 0;
+
+    while (qk_atomic_load_i32(&counter->pending) > 0) {
+        if (s_jobs.initialized && job_try_run_one(self)) {
+            idle = 0;
+            continue;
+        }
+        qk_cpu_pause();
+        if (++idle >= JOB_SPIN_COUNT) {
+            job_yield();
+            idle = 0;
+        }
+    }
+}
+
+bool qk_job_is_done(const qk_job_counter_t *counter) {
+    return qk_atomic_load_i32(&counter->pending) <= 0;
+}
+
+// --- Parallel For ---
+
+typedef struct {
+    qk_job_range_fn_t   fn;
+    void               *data;
+    u32                 begin;
+    u32                 end;
+} job_range_t;
+
+static void job_range_entry(void *data) {
+    const job_range_t *range = (const job_range_t *)data;
+    range->fn(range->data, range->begin, range->end);
+}
+
+void qk_job_parallel_for(u32 count, u32 min_batch,
+                         qk_job_range_fn_t fn, void *data) {
+    if (count == 0) return;
+    if (min_batch == 0) min_batch = 1;
+
+    // A few chunks per thread so stealing can even out uneven work
+    u32 chunks = (count + min_batch - 1) / min_batch;
+    u32 max_chunks = qk_job_worker_count() * 4;
+    if (max_chunks > JOB_MAX_CHUNKS) max_chunks = JOB_MAX_CHUNKS;
+    if (chunks > max_chunks) chunks = max_chunks;
+
+    if (chunks <= 1) {
+        fn(data, 0, count);
+        return;
+    }
+
+    job_range_t ranges[JOB_MAX_CHUNKS];
+    qk_job_counter_t counter = {0};
+    u32 per_chunk = count / chunks;
+    u32 remainder = count % chunks;
+    u32 begin = 0;
+
+    for (u32 i = 0; i < chunks; i++) {
+        u32 size = per_chunk + (i < remainder ? 1 : 0);
+        ranges[i] = (job_range_t){
+            .fn = fn, .data = data, .begin = begin, .end = begin + size
+        };
+        begin += size;
+    }
+
+    // Chunk 0 runs here; the rest go to the deque for thieves
+    job_worker_t *self = job_current_worker();
+    u32 queued = 0;
+    for (u32 i = 1; i < chunks; i++) {
+        job_t job = { .fn = job_range_entry, .data = &ranges[i], .counter = &counter };
+        qk_atomic_add_i32(&counter.pending, 1);
+        if (self && deque_push(&self->deque, &job)) {
+            queued++;
+        } else {
+            job_execute(self, &job);
+        }
+    }
+    if (queued > 0) job_wake(queued);
+
+    job_range_entry(&ranges[0]);
+    qk_job_wait(&counter);
+}
+
+// --- Profiling ---
+
+void qk_job_prof_flush(void) {
+#ifdef QK_PROFILE
+    // Names must outlive the profiler, which keeps the pointers
+    static char s_zone_names[QK_JOB_MAX_WORKERS][16];
+    static char s_counter_names[QK_JOB_MAX_WORKERS][24];
+
+    if (!s_jobs.initialized) return;
+
+    for (u32 i = 0; i < s_jobs.worker_count; i++) {
+        job_worker_t *w = &s_jobs.workers[i];
+        if (!s_zone_names[i][0]) {
+            snprintf(s_zone_names[i], sizeof(s_zone_names[i]), "job_w%u", i);
+            snprintf(s_counter_names[i], sizeof(s_counter_names[i]), "job_w%u_jobs", i);
+        }
+
+        i64 us = qk_atomic_load_i64(&w->busy_us);
+        i32 jobs = qk_atomic_load_i32(&w->jobs_run);
+        qk_atomic_add_i64(&w->busy_us, -us);
+        qk_atomic_add_i32(&w->jobs_run, -jobs);
+
+        if (jobs > 0) {
+            QK_PROF_ZONE_ADD(s_zone_names[i], (f64)us / 1000.0);
+            QK_PROF_COUNTER(s_counter_names[i], (u32)jobs);
+        }
+    }
+#endif
+}
@@ -26,6 +26,9 @@ void qk_perf_end_frame(f32 cpu_frame_ms, f32 gpu_frame_ms, f32 world_ms,
     QK_UNUSED(swapchain_w); QK_UNUSED(swapchain_h);
     QK_UNUSED(fence_wait_ms); QK_UNUSED(acquire_ms);
 }
+void qk_perf_set_scratch_usage(u64 frame_bytes, u64 tick_bytes) {
+    QK_UNUSED(frame_bytes); QK_UNUSED(tick_bytes);
+}
 void qk_perf_set_enabled(bool enabled) { QK_UNUSED(enabled); }
 void qk_perf_log_event(const char *fmt, ...) { QK_UNUSED(fmt); }
 
@@ -63,6 +66,12 @@ typedef struct {
     f64     sum_gpu_ms;
     f32     min_gpu_ms;
     f32     max_gpu_ms;
+
+    // Scratch arena high-water (latest and lifetime peak, bytes)
+    u64     scratch_frame_bytes;
+    u64     scratch_tick_bytes;
+    u64     max_scratch_frame_bytes;
+    u64     max_scratch_tick_bytes;
 } perf_state_t;
 
 static perf_state_t s_perf;
@@ -84,10 +93,13 @@ void qk_perf_shutdown(void)
 
         fprintf(s_perf.file, "# SUMMARY: frames=%llu avg_fps=%.1f "
                 "cpu_avg=%.3f cpu_min=%.3f cpu_max=%.3f "
-                "gpu_avg=%.3f gpu_min=%.3f gpu_max=%.3f\n",
+                "gpu_avg=%.3f gpu_min=%.3f gpu_max=%.3f "
+                "scratch_frame_peak_kb=%.1f scratch_tick_peak_kb=%.1f\n",
                 (unsigned long long)s_perf.total_frames, avg_fps,
                 avg_cpu, (double)s_perf.min_cpu_ms, (double)s_perf.max_cpu_ms,
-                avg_gpu, (double)s_perf.min_gpu_ms, (double)s_perf.max_gpu_ms);
+                avg_gpu, (double)s_perf.min_gpu_ms, (double)s_perf.max_gpu_ms,
+                (double)s_perf.max_scratch_frame_bytes / 1024.0,
+                (double)s_perf.max_scratch_tick_bytes / 1024.0);
     }
 
     if (s_perf.file) {
@@ -107,7 +119,8 @@ void qk_perf_set_enabled(bool enabled)
 
         fprintf(s_perf.file, "frame,cpu_ms,gpu_ms,world_ms,compose_ms,"
                 "draw_calls,tris,swap_w,swap_h,fence_ms,acquire_ms,"
-                "avg_cpu_ms,avg_gpu_ms,avg_fence_ms,avg_acquire_ms\n");
+                "avg_cpu_ms,avg_gpu_ms,avg_fence_ms,avg_acquire_ms,"
+                "scratch_frame_kb,scratch_tick_kb\n");
 
         s_perf.total_frames = 0;
         s_perf.interval_counter = 0;
@@ -119,12 +132,22 @@ void qk_perf_set_enabled(bool enabled)
         s_perf.max_cpu_ms = 0.0f;
         s_perf.min_gpu_ms = 9999.0f;
         s_perf.max_gpu_ms = 0.0f;
+        s_perf.max_scratch_frame_bytes = 0;
+        s_perf.max_scratch_tick_bytes = 0;
         s_perf.enabled = true;
     } else {
         qk_perf_shutdown();
     }
 }
 
+void qk_perf_set_scratch_usage(u64 frame_bytes, u64 tick_bytes)
+{
+    s_perf.scratch_frame_bytes = frame_bytes;
+    s_perf.scratch_tick_bytes = tick_bytes;
+    if (frame_bytes > s_perf.max_scratch_frame_bytes) s_perf.max_scratch_frame_bytes = frame_bytes;
+    if (tick_bytes > s_perf.max_scratch_tick_bytes) s_perf.max_scratch_tick_bytes = tick_bytes;
+}
+
 void qk_perf_begin_frame(void)
 {
     if (!s_perf.enabled) return;
@@ -177,13 +200,15 @@ void qk_perf_end_frame(f32 cpu_frame_ms, f32 gpu_frame_ms, f32 world_ms,
     avg_acquire /= (f64)count;
 
     fprintf(s_perf.file, "%llu,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u,%.3f,%.3f,"
-            "%.3f,%.3f,%.3f,%.3f\n",
+            "%.3f,%.3f,%.3f,%.3f,%.1f,%.1f\n",
             (unsigned long long)s_perf.total_frames,
             (double)cpu_frame_ms, (double)gpu_frame_ms,
             (double)world_ms, (double)compose_ms,
             draw_calls, tris, swapchain_w, swapchain_h,
             (double)fence_wait_ms, (double)acquire_ms,
-            avg_cpu, avg_gpu, avg_fence, avg_acquire);
+            avg_cpu, avg_gpu, avg_fence, avg_acquire,
+            (double)s_perf.scratch_frame_bytes / 1024.0,
+            (double)s_perf.scratch_tick_bytes / 1024.0);
 }
 
 void qk_perf_log_event(const char *fmt, ...)
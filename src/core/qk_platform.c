@@ -3,8 +3,13 @@
  *
  * Monotonic time via SDL3 (client) or OS APIs (headless server).
  * Sleep via SDL3 or OS APIs.
+ * Scheduling (pinning, realtime priority, memory locking) is OS-only.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE     // sched_setaffinity, CPU_SET
+#endif
+
 #include "core/qk_platform.h"
 
 #ifdef QK_HEADLESS
@@ -80,3 +85,55 @@ void qk_platform_sleep(u32 ms) {
 }
 
 #endif // QK_HEADLESS
+
+// --- Scheduling (OS only, both builds) ---
+
+#ifdef QK_PLATFORM_WINDOWS
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+
+bool qk_platform_pin_thread(u32 core) {
+    if (core >= 64) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+}
+
+bool qk_platform_set_realtime(u32 priority) {
+    QK_UNUSED(priority);
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+}
+
+bool qk_platform_lock_memory(void) {
+    // VirtualLock works per range and is capped by the working set
+    return false;
+}
+
+#else
+    #include <sched.h>
+    #include <sys/mman.h>
+
+bool qk_platform_pin_thread(u32 core) {
+    if (core >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)core, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool qk_platform_set_realtime(u32 priority) {
+    i32 lo = sched_get_priority_min(SCHED_FIFO);
+    i32 hi = sched_get_priority_max(SCHED_FIFO);
+    i32 prio = (i32)priority;
+    if (prio < lo) prio = lo;
+    if (prio > hi) prio = hi;
+
+    struct sched_param param = { .sched_priority = prio };
+    return sched_setscheduler(0, SCHED_FIFO, &param) == 0;
+}
+
+bool qk_platform_lock_memory(void) {
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
+#endif // QK_PLATFORM_WINDOWS
@@ -428,6 +428,17 @@ void qk_prof_zone_end(const char *name) {
     s_prof.zones[idx].active = false;
 }
 
+/* Time measured elsewhere (e.g. job workers, which must not touch s_prof
+ * from their own threads) and handed over on the main thread. */
+void qk_prof_zone_add(const char *name, f64 ms) {
+    if (!s_prof.file) return;
+
+    i32 idx = find_or_add_zone(name);
+    if (idx < 0) return;
+
+    s_prof.zones[idx].elapsed_ms += ms;
+}
+
 void qk_prof_counter_add(const char *name, u32 value) {
     if (!s_prof.file) return;
 
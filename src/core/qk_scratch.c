@@ -0,0 +1,147 @@
+/*
+ * QUICKEN Engine - Frame / Tick Scratch Arenas
+ *
+ * Threads register into a fixed table on first use. Each kind has a global
+ * generation counter; a thread that sees a new generation switches to
+ * buffer (generation & 1), folds that buffer's high-water mark into the
+ * shared peak, and resets it. Arenas are reserved lazily and commit on
+ * demand, so unused threads and unused kinds cost only address space.
+ */
+
+#include "core/qk_scratch.h"
+#include "core/qk_atomic.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SCRATCH_MAX_THREADS 64
+
+static const u64 SCRATCH_DEFAULT_FRAME_SIZE = (u64)8 * 1024 * 1024;
+static const u64 SCRATCH_DEFAULT_TICK_SIZE  = (u64)4 * 1024 * 1024;
+
+typedef struct {
+    qk_arena_t     *arenas[QK_SCRATCH_KIND_COUNT][2];
+    u32             generation[QK_SCRATCH_KIND_COUNT];
+} scratch_thread_t;
+
+static struct {
+    u64                 size[QK_SCRATCH_KIND_COUNT];
+    u32                 arena_flags;
+    qk_atomic_i32_t     generation[QK_SCRATCH_KIND_COUNT];
+    qk_atomic_i64_t     peak[QK_SCRATCH_KIND_COUNT];
+    qk_atomic_i32_t     thread_count;
+    scratch_thread_t    threads[SCRATCH_MAX_THREADS];
+} s_scratch;
+
+static QK_THREAD_LOCAL scratch_thread_t *s_self;
+
+static u64 scratch_size(qk_scratch_kind_t kind) {
+    if (s_scratch.size[kind]) return s_scratch.size[kind];
+    return kind == QK_SCRATCH_FRAME ? SCRATCH_DEFAULT_FRAME_SIZE
+                                    : SCRATCH_DEFAULT_TICK_SIZE;
+}
+
+static void scratch_note_peak(qk_scratch_kind_t kind, u64 bytes) {
+    i64 cur = qk_atomic_load_i64(&s_scratch.peak[kind]);
+    while ((i64)bytes > cur) {
+        if (qk_atomic_cas_i64(&s_scratch.peak[kind], cur, (i64)bytes)) break;
+        cur = qk_atomic_load_i64(&s_scratch.peak[kind]);
+    }
+}
+
+static scratch_thread_t *scratch_self(void) {
+    if (s_self) return s_self;
+
+    i32 slot = qk_atomic_add_i32(&s_scratch.thread_count, 1);
+    if (slot >= SCRATCH_MAX_THREADS) {
+        qk_atomic_add_i32(&s_scratch.thread_count, -1);
+        fprintf(stderr, "[Scratch] Thread table full (%d)\n", SCRATCH_MAX_THREADS);
+        return NULL;
+    }
+
+    scratch_thread_t *t = &s_scratch.threads[slot];
+    for (u32 k = 0; k < QK_SCRATCH_KIND_COUNT; k++) {
+        t->generation[k] = (u32)qk_atomic_load_i32(&s_scratch.generation[k]);
+    }
+    s_self = t;
+    return t;
+}
+
+// --- Public API ---
+
+void qk_scratch_init(const qk_scratch_config_t *config) {
+    if (!config) return;
+    s_scratch.size[QK_SCRATCH_FRAME] = config->frame_size;
+    s_scratch.size[QK_SCRATCH_TICK]  = config->tick_size;
+    s_scratch.arena_flags = config->arena_flags;
+}
+
+void qk_scratch_shutdown(void) {
+    i32 count = qk_atomic_load_i32(&s_scratch.thread_count);
+    for (i32 i = 0; i < count; i++) {
+        scratch_thread_t *t = &s_scratch.threads[i];
+        for (u32 k = 0; k < QK_SCRATCH_KIND_COUNT; k++) {
+            qk_arena_destroy(t->arenas[k][0]);
+            qk_arena_destroy(t->arenas[k][1]);
+        }
+    }
+    memset(&s_scratch, 0, sizeof(s_scratch));
+    s_self = NULL;  // other threads' pointers are gone with them
+}
+
+void qk_scratch_advance(qk_scratch_kind_t kind) {
+    qk_atomic_add_i32(&s_scratch.generation[kind], 1);
+}
+
+bool qk_scratch_prefault(void) {
+    scratch_thread_t *t = scratch_self();
+    if (!t) return false;
+
+    for (u32 k = 0; k < QK_SCRATCH_KIND_COUNT; k++) {
+        for (u32 buf = 0; buf < 2; buf++) {
+            qk_arena_t **slot = &t->arenas[k][buf];
+            if (!*slot) {
+                *slot = qk_arena_create_ex(scratch_size((qk_scratch_kind_t)k),
+                                           s_scratch.arena_flags);
+                if (!*slot) return false;
+            }
+            if (!qk_arena_prefault(*slot, 0)) return false;
+        }
+    }
+    return true;
+}
+
+qk_arena_t *qk_scratch(qk_scratch_kind_t kind) {
+    QK_ASSERT(kind < QK_SCRATCH_KIND_COUNT);
+
+    scratch_thread_t *t = scratch_self();
+    if (!t) return NULL;
+
+    u32 gen = (u32)qk_atomic_load_i32(&s_scratch.generation[kind]);
+    u32 buf = gen & 1;
+    qk_arena_t **slot = &t->arenas[kind][buf];
+
+    if (!*slot) {
+        *slot = qk_arena_create_ex(scratch_size(kind), s_scratch.arena_flags);
+        if (!*slot) return NULL;
+    }
+
+    if (gen != t->generation[kind]) {
+        // Buffer being recycled is at least one full boundary old
+        t->generation[kind] = gen;
+        scratch_note_peak(kind, qk_arena_high_water(*slot));
+        qk_arena_reset(*slot);
+    }
+
+    return *slot;
+}
+
+void qk_scratch_get_stats(qk_scratch_stats_t *out_stats) {
+    memset(out_stats, 0, sizeof(*out_stats));
+    for (u32 k = 0; k < QK_SCRATCH_KIND_COUNT; k++) {
+        i64 peak = qk_atomic_load_i64(&s_scratch.peak[k]);
+        qk_atomic_cas_i64(&s_scratch.peak[k], peak, 0);
+        out_stats->high_water[k] = (u64)peak;
+        out_stats->capacity[k] = scratch_size((qk_scratch_kind_t)k);
+    }
+    out_stats->thread_count = (u32)qk_atomic_load_i32(&s_scratch.thread_count);
+}
@@ -0,0 +1,105 @@
+/*
+ * QUICKEN Engine - Console Scrollback
+ *
+ * Ring offsets are byte counts since creation, masked on access, so a
+ * line's bytes are live while text_head - offset <= the ring size. The
+ * print queue is Vyukov's bounded MPSC queue.
+ */
+
+#include "core/qk_scrollback.h"
+#include <string.h>
+
+_Static_assert((QK_SCROLLBACK_TEXT_BYTES & (QK_SCROLLBACK_TEXT_BYTES - 1)) == 0 &&
+               (QK_SCROLLBACK_LINES & (QK_SCROLLBACK_LINES - 1)) == 0 &&
+               (QK_PRINT_QUEUE_SIZE & (QK_PRINT_QUEUE_SIZE - 1)) == 0,
+               "scrollback and print queue sizes must be powers of two");
+
+// --- Scrollback ---
+
+void qk_scrollback_push(qk_scrollback_t *sb, const char *text, u32 len, u32 color) {
+    if (len >= QK_SCROLLBACK_LINE_LEN) len = QK_SCROLLBACK_LINE_LEN - 1;
+
+    // Drop the oldest lines until both the index and the byte ring have room
+    while (sb->line_head != sb->line_tail &&
+           (sb->line_head - sb->line_tail >= QK_SCROLLBACK_LINES ||
+            sb->text_head + len - sb->lines[sb->line_tail & (QK_SCROLLBACK_LINES - 1)].offset >
+                QK_SCROLLBACK_TEXT_BYTES)) {
+        sb->line_tail++;
+    }
+
+    u32 at = sb->text_head & (QK_SCROLLBACK_TEXT_BYTES - 1);
+    u32 first = len < QK_SCROLLBACK_TEXT_BYTES - at ? len : QK_SCROLLBACK_TEXT_BYTES - at;
+    memcpy(&sb->text_ring[at], text, first);
+    memcpy(sb->text_ring, text + first, len - first);
+
+    qk_scrollback_line_t *line = &sb->lines[sb->line_head & (QK_SCROLLBACK_LINES - 1)];
+    line->offset = sb->text_head;
+    line->len = len;
+    line->color = color;
+    sb->text_head += len;
+    sb->line_head++;
+}
+
+void qk_scrollback_clear(qk_scrollback_t *sb) {
+    sb->line_tail = sb->line_head;
+}
+
+const qk_scrollback_line_t *qk_scrollback_line(const qk_scrollback_t *sb, u32 back) {
+    QK_ASSERT(back < qk_scrollback_count(sb));
+    return &sb->lines[(sb->line_head - 1 - back) & (QK_SCROLLBACK_LINES - 1)];
+}
+
+u32 qk_scrollback_text(const qk_scrollback_t *sb, const qk_scrollback_line_t *line, char *out) {
+    u32 at = line->offset & (QK_SCROLLBACK_TEXT_BYTES - 1);
+    u32 first = line->len < QK_SCROLLBACK_TEXT_BYTES - at ? line->len : QK_SCROLLBACK_TEXT_BYTES - at;
+    memcpy(out, &sb->text_ring[at], first);
+    memcpy(out + first, sb->text_ring, line->len - first);
+    return line->len;
+}
+
+// --- Print queue ---
+// Slot i is free for the producer at position pos when its seq is pos, and
+// holds a line for the consumer when it is pos + 1. Seq is stored minus the
+// slot index so zero is the initial state.
+
+bool qk_print_queue_push(qk_print_queue_t *queue, const char *text, u32 len, u32 color) {
+    u32 pos = (u32)qk_atomic_load_i32(&queue->enqueue_pos);
+    for (;;) {
+        u32 idx = pos & (QK_PRINT_QUEUE_SIZE - 1);
+        qk_print_slot_t *slot = &queue->slots[idx];
+        u32 seq = (u32)qk_atomic_load_i32(&slot->seq) + idx;
+        i32 diff = (i32)(seq - pos);
+
+        if (diff == 0) {
+            if (qk_atomic_cas_i32(&queue->enqueue_pos, (i32)pos, (i32)(pos + 1))) {
+                if (len >= QK_SCROLLBACK_LINE_LEN) len = QK_SCROLLBACK_LINE_LEN - 1;
+                memcpy(slot->text, text, len);
+                slot->len = len;
+                slot->color = color;
+                qk_atomic_store_i32(&slot->seq, (i32)(pos + 1 - idx));
+                return true;
+            }
+            pos = (u32)qk_atomic_load_i32(&queue->enqueue_pos);
+        } else if (diff < 0) {
+            qk_atomic_add_i32(&queue->dropped, 1);  // full: the consumer is behind
+            return false;
+        } else {
+            pos = (u32)qk_atomic_load_i32(&queue->enqueue_pos);
+        }
+    }
+}
+
+u32 qk_print_queue_drain(qk_print_queue_t *queue, qk_scrollback_t *sb) {
+    for (;;) {
+        u32 pos = queue->dequeue_pos;
+        u32 idx = pos & (QK_PRINT_QUEUE_SIZE - 1);
+        qk_print_slot_t *slot = &queue->slots[idx];
+        if ((u32)qk_atomic_load_i32(&slot->seq) + idx != pos + 1) break;
+
+        qk_scrollback_push(sb, slot->text, slot->len, slot->color);
+        qk_atomic_store_i32(&slot->seq, (i32)(pos + QK_PRINT_QUEUE_SIZE - idx));
+        queue->dequeue_pos = pos + 1;
+    }
+
+    return (u32)qk_atomic_exchange_i32(&queue->dropped, 0);
+}
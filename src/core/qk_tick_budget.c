@@ -0,0 +1,121 @@
+/*
+ * QUICKEN Engine - Server Tick Budget
+ *
+ * Load is an EMA of tick_ms / budget_ms. A level change resets the hold
+ * counter, so raises are at least QK_TICK_BUDGET_RAISE_HOLD ticks apart
+ * (the EMA needs that long to see what the last step bought) and each
+ * step down needs QK_TICK_BUDGET_LOWER_HOLD ticks of low load.
+ */
+
+#include "core/qk_tick_budget.h"
+#include "qk_types.h"
+#include <string.h>
+
+static const char *s_level_names[QK_DEGRADE_LEVEL_COUNT] = {
+    "none", "defer", "thin", "cap",
+};
+
+static void budget_set_level(qk_tick_budget_t *tb, qk_degrade_level_t level) {
+    qk_degrade_event_t *ev = &tb->events[tb->event_head % QK_TICK_BUDGET_EVENT_RING];
+    ev->tick = tb->ticks;
+    ev->from = tb->level;
+    ev->to   = level;
+    ev->load = tb->load;
+    tb->event_head++;
+
+    // Unread events past the ring are lost, oldest first
+    if (tb->event_head - tb->event_read > QK_TICK_BUDGET_EVENT_RING) {
+        tb->event_read = tb->event_head - QK_TICK_BUDGET_EVENT_RING;
+    }
+
+    tb->level = level;
+    tb->ticks_since_change = 0;
+}
+
+// --- Public API ---
+
+void qk_tick_budget_init(qk_tick_budget_t *tb, f64 budget_ms) {
+    memset(tb, 0, sizeof(*tb));
+    tb->budget_ms = budget_ms > 0.0 ? budget_ms : QK_TICK_DT_F64 * 1000.0;
+}
+
+void qk_tick_budget_begin_tick(qk_tick_budget_t *tb, f64 now) {
+    tb->tick_start = now;
+    tb->phase_start = now;
+    memset(tb->phase_ms, 0, sizeof(tb->phase_ms));
+}
+
+void qk_tick_budget_mark(qk_tick_budget_t *tb, qk_tick_phase_t phase, f64 now) {
+    QK_ASSERT(phase < QK_TICK_PHASE_COUNT);
+    tb->phase_ms[phase] += (now - tb->phase_start) * 1000.0;
+    tb->phase_start = now;
+}
+
+void qk_tick_budget_end_tick(qk_tick_budget_t *tb, f64 now) {
+    f64 ms = (now - tb->tick_start) * 1000.0;
+    if (ms < 0.0) ms = 0.0;
+
+    tb->tick_ms = ms;
+    tb->ticks++;
+    tb->ticks_since_change++;
+    if (ms > tb->budget_ms) tb->overruns++;
+    if (ms > tb->worst_tick_ms) tb->worst_tick_ms = ms;
+
+    u32 bucket = (u32)(ms / QK_TICK_BUDGET_HIST_STEP_MS);
+    if (bucket >= QK_TICK_BUDGET_HIST_BUCKETS) bucket = QK_TICK_BUDGET_HIST_BUCKETS - 1;
+    tb->hist[bucket]++;
+
+    tb->load += (ms / tb->budget_ms - tb->load) * QK_TICK_BUDGET_SMOOTHING;
+
+    if (tb->load > QK_TICK_BUDGET_RAISE_LOAD && tb->level < QK_DEGRADE_CAP &&
+        tb->ticks_since_change >= QK_TICK_BUDGET_RAISE_HOLD) {
+        budget_set_level(tb, (qk_degrade_level_t)(tb->level + 1));
+    } else if (tb->load < QK_TICK_BUDGET_LOWER_LOAD && tb->level > QK_DEGRADE_NONE &&
+               tb->ticks_since_change >= QK_TICK_BUDGET_LOWER_HOLD) {
+        budget_set_level(tb, (qk_degrade_level_t)(tb->level - 1));
+    }
+}
+
+u32 qk_tick_budget_ticks_due(qk_tick_budget_t *tb, f32 *accumulator, f32 tick_dt) {
+    if (*accumulator < tick_dt) return 0;
+
+    u32 due = (u32)(*accumulator / tick_dt);
+    u32 cap = tb->level >= QK_DEGRADE_CAP ? QK_TICK_BUDGET_CATCHUP_CAPPED
+                                          : QK_TICK_BUDGET_CATCHUP_MAX;
+    if (due > cap) {
+        // Replaying the backlog would only make the next frame later
+        u32 dropped = due - cap;
+        *accumulator -= (f32)dropped * tick_dt;
+        tb->ticks_dropped += dropped;
+        due = cap;
+    }
+    return due;
+}
+
+bool qk_tick_budget_pop_event(qk_tick_budget_t *tb, qk_degrade_event_t *out_event) {
+    if (tb->event_read == tb->event_head) return false;
+    *out_event = tb->events[tb->event_read % QK_TICK_BUDGET_EVENT_RING];
+    tb->event_read++;
+    return true;
+}
+
+f64 qk_tick_budget_percentile(const qk_tick_budget_t *tb, f64 fraction) {
+    if (tb->ticks == 0) return 0.0;
+
+    u64 want = (u64)(fraction * (f64)tb->ticks + 0.5);
+    if (want == 0) want = 1;
+    u64 seen = 0;
+    for (u32 b = 0; b < QK_TICK_BUDGET_HIST_BUCKETS - 1; b++) {
+        seen += tb->hist[b];
+        if (seen >= want) {
+            f64 edge = (f64)(b + 1) * QK_TICK_BUDGET_HIST_STEP_MS;
+            return edge < tb->worst_tick_ms ? edge : tb->worst_tick_ms;
+        }
+    }
+    return tb->worst_tick_ms;
+}
+
+const char *qk_degrade_level_name(qk_degrade_level_t level) {
+    if ((u32)level >= QK_DEGRADE_LEVEL_COUNT) return "?";
+    return s_level_names[level];
+}
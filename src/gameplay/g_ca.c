@@ -3,6 +3,10 @@
  *
  * Round state machine: warmup -> countdown -> playing -> round_end -> match_end.
  * Teams spawn with full health/armor/weapons. Rounds until one team eliminated.
+ *
+ * Event driven: each state has an absolute deadline on the server clock,
+ * and alive counts change on spawn, kill and disconnect rather than by
+ * rescanning players every tick.
  */
 
 #include "g_internal.h"
@@ -25,10 +29,60 @@ static const qk_spawn_point_t s_beta_spawns[] = {
 #define NUM_ALPHA_SPAWNS (sizeof(s_alpha_spawns) / sizeof(s_alpha_spawns[0]))
 #define NUM_BETA_SPAWNS  (sizeof(s_beta_spawns) / sizeof(s_beta_spawns[0]))
 
+/*
+ * Spawn order per team, built once from the spawn distance table: each
+ * spawn is ranked by its distance to the nearest enemy spawn, farthest
+ * first, so a round start is one table lookup per player.
+ */
+static u8 s_alpha_order[NUM_ALPHA_SPAWNS];
+static u8 s_beta_order[NUM_BETA_SPAWNS];
+
+static void ca_build_spawn_order(const qk_spawn_point_t *own, u32 own_count,
+                                 const qk_spawn_point_t *enemy, u32 enemy_count,
+                                 u8 *out_order) {
+    f32 safety[NUM_ALPHA_SPAWNS > NUM_BETA_SPAWNS ? NUM_ALPHA_SPAWNS : NUM_BETA_SPAWNS];
+
+    for (u32 i = 0; i < own_count; i++) {
+        f32 nearest = 1e30f;
+        for (u32 j = 0; j < enemy_count; j++) {
+            f32 d = vec3_length(vec3_sub(own[i].origin, enemy[j].origin));
+            if (d < nearest) nearest = d;
+        }
+        safety[i] = nearest;
+
+        // insertion by safety, farthest first; ties keep table order
+        u32 k = i;
+        while (k > 0 && safety[out_order[k - 1]] < nearest) {
+            out_order[k] = out_order[k - 1];
+            k--;
+        }
+        out_order[k] = (u8)i;
+    }
+}
+
+// --- Deadlines ---
+
+static void ca_set_state(qk_game_state_t *gs, ca_round_state_t state, u32 duration_ms) {
+    gs->ca.state = (u8)state;
+    gs->ca.state_timer_ms = duration_ms;
+    gs->mode_state_seen = (u8)state;
+    gs->mode_deadline_ms = gs->server_time_ms + duration_ms;
+}
+
+// Remaining time for readers of qk_ca_state_t (HUD, demos)
+void g_ca_sync_timer(qk_game_state_t *gs) {
+    u32 now = gs->server_time_ms;
+    gs->ca.state_timer_ms = gs->mode_deadline_ms > now ? gs->mode_deadline_ms - now : 0;
+}
+
 // --- Init ---
 void g_ca_init(qk_game_state_t *gs) {
-    gs->ca.state = CA_STATE_WARMUP;
-    gs->ca.state_timer_ms = 0;
+    ca_build_spawn_order(s_alpha_spawns, NUM_ALPHA_SPAWNS,
+                         s_beta_spawns, NUM_BETA_SPAWNS, s_alpha_order);
+    ca_build_spawn_order(s_beta_spawns, NUM_BETA_SPAWNS,
+                         s_alpha_spawns, NUM_ALPHA_SPAWNS, s_beta_order);
+
+    ca_set_state(gs, CA_STATE_WARMUP, 0);
     gs->ca.score_alpha = 0;
     gs->ca.score_beta = 0;
     gs->ca.round_number = 0;
@@ -36,7 +90,7 @@ void g_ca_init(qk_game_state_t *gs) {
     gs->ca.alive_beta = 0;
 }
 
-// --- Count alive players per team ---
+// --- Count alive players per team (full scan; events keep it current) ---
 void g_ca_count_alive(qk_game_state_t *gs) {
     u8 alive_a = 0, alive_b = 0;
 
@@ -55,8 +109,7 @@ void g_ca_count_alive(qk_game_state_t *gs) {
 
 // --- Start Countdown ---
 void g_ca_start_countdown(qk_game_state_t *gs) {
-    gs->ca.state = CA_STATE_COUNTDOWN;
-    gs->ca.state_timer_ms = gs->countdown_time_ms;
+    ca_set_state(gs, CA_STATE_COUNTDOWN, gs->countdown_time_ms);
 }
 
 // --- Begin Round (transition from COUNTDOWN -> PLAYING) ---
@@ -71,7 +124,7 @@ void g_ca_begin_round(qk_game_state_t *gs) {
         proj = next;
     }
 
-    // spawn all players at their team spawn points
+    // spawn all players at their team spawn points, counting as we go
     u8 alpha_idx = 0, beta_idx = 0;
 
     for (entity_t *e = g_entity_first(&gs->entities, ENTITY_PLAYER);
@@ -79,19 +132,18 @@ void g_ca_begin_round(qk_game_state_t *gs) {
         qk_player_state_t *ps = &e->data.player;
 
         if (ps->team == QK_TEAM_ALPHA) {
-            u8 si = alpha_idx % NUM_ALPHA_SPAWNS;
-            g_player_spawn_ca(e, s_alpha_spawns[si].origin, s_alpha_spawns[si].yaw);
-            ps->team = QK_TEAM_ALPHA;
+            const qk_spawn_point_t *sp = &s_alpha_spawns[s_alpha_order[alpha_idx % NUM_ALPHA_SPAWNS]];
+            g_player_spawn_ca(e, sp->origin, sp->yaw);
             alpha_idx++;
         } else if (ps->team == QK_TEAM_BETA) {
-            u8 si = beta_idx % NUM_BETA_SPAWNS;
-            g_player_spawn_ca(e, s_beta_spawns[si].origin, s_beta_spawns[si].yaw);
-            ps->team = QK_TEAM_BETA;
+            const qk_spawn_point_t *sp = &s_beta_spawns[s_beta_order[beta_idx % NUM_BETA_SPAWNS]];
+            g_player_spawn_ca(e, sp->origin, sp->yaw);
             beta_idx++;
         }
     }
 
-    g_ca_count_alive(gs);
+    gs->ca.alive_alpha = alpha_idx;
+    gs->ca.alive_beta = beta_idx;
 
     // push round start event
     game_event_t evt = {
@@ -115,8 +167,7 @@ void g_ca_end_round(qk_game_state_t *gs) {
     }
     // both zero = draw round, no score change
 
-    gs->ca.state = CA_STATE_ROUND_END;
-    gs->ca.state_timer_ms = QK_CA_ROUND_END_MS;
+    ca_set_state(gs, CA_STATE_ROUND_END, QK_CA_ROUND_END_MS);
 
     // push round end event
     game_event_t evt = {
@@ -156,8 +207,7 @@ void g_ca_end_round_timeout(qk_game_state_t *gs) {
     }
     // equal = draw, no score change
 
-    gs->ca.state = CA_STATE_ROUND_END;
-    gs->ca.state_timer_ms = QK_CA_ROUND_END_MS;
+    ca_set_state(gs, CA_STATE_ROUND_END, QK_CA_ROUND_END_MS);
 
     game_event_t evt = {
         .type = GEVT_ROUND_END,
@@ -171,40 +221,54 @@ void g_ca_end_round_timeout(qk_game_state_t *gs) {
     g_event_push(&gs->events, &evt);
 }
 
+// --- Player events ---
+
+static void ca_player_gone(qk_game_state_t *gs, const entity_t *ent) {
+    const qk_player_state_t *ps = &ent->data.player;
+    if (ps->team == QK_TEAM_ALPHA && gs->ca.alive_alpha > 0) gs->ca.alive_alpha--;
+    else if (ps->team == QK_TEAM_BETA && gs->ca.alive_beta > 0) gs->ca.alive_beta--;
+}
+
 // --- CA Tick (called once per server tick) ---
-void g_ca_tick(qk_game_state_t *gs, u32 dt_ms) {
+/*
+ * Constant work unless something is due: a state written from outside the
+ * mode (tests, admin tools) is adopted, its timer becoming a deadline and
+ * the alive counts rebuilt; then the current state's deadline is compared.
+ * Eliminations are seen through the counts, which kills keep current.
+ */
+static void ca_tick(qk_game_state_t *gs) {
+    if (gs->ca.state != gs->mode_state_seen) {
+        ca_set_state(gs, (ca_round_state_t)gs->ca.state, gs->ca.state_timer_ms);
+        g_ca_count_alive(gs);
+    }
+
+    bool due = gs->server_time_ms >= gs->mode_deadline_ms;
+
     switch (gs->ca.state) {
     case CA_STATE_WARMUP:
         // allow free movement, no damage. wait for ready-up or admin force.
         break;
 
     case CA_STATE_COUNTDOWN:
-        gs->ca.state_timer_ms -= min_u32(dt_ms, gs->ca.state_timer_ms);
-        if (gs->ca.state_timer_ms == 0) {
+        if (due) {
             g_ca_begin_round(gs);
-            gs->ca.state = CA_STATE_PLAYING;
-            gs->ca.state_timer_ms = gs->round_time_limit_ms;
+            ca_set_state(gs, CA_STATE_PLAYING, gs->round_time_limit_ms);
         }
         break;
 
     case CA_STATE_PLAYING:
-        gs->ca.state_timer_ms -= min_u32(dt_ms, gs->ca.state_timer_ms);
-
-        g_ca_count_alive(gs);
-
         if (gs->ca.alive_alpha == 0 || gs->ca.alive_beta == 0) {
             g_ca_end_round(gs);
-        } else if (gs->ca.state_timer_ms == 0) {
+        } else if (due) {
             g_ca_end_round_timeout(gs);
         }
         break;
 
     case CA_STATE_ROUND_END:
-        gs->ca.state_timer_ms -= min_u32(dt_ms, gs->ca.state_timer_ms);
-        if (gs->ca.state_timer_ms == 0) {
+        if (due) {
             if (gs->ca.score_alpha >= gs->rounds_to_win ||
                 gs->ca.score_beta >= gs->rounds_to_win) {
-                gs->ca.state = CA_STATE_MATCH_END;
+                ca_set_state(gs, CA_STATE_MATCH_END, 0);
 
                 game_event_t evt = {
                     .type = GEVT_MATCH_END,
@@ -229,3 +293,12 @@ void g_ca_tick(qk_game_state_t *gs, u32 dt_ms) {
         break;
     }
 }
+
+// --- Mode plugin ---
+const g_mode_t g_mode_ca = {
+    .name           = "ca",
+    .init           = g_ca_init,
+    .tick           = ca_tick,
+    .player_killed  = ca_player_gone,
+    .player_removed = ca_player_gone,
+};
@@ -57,7 +57,8 @@ void g_combat_apply_damage(qk_game_state_t *gs, const damage_event_t *dmg) {
         game_event_t evt = {
             .type = GEVT_HIT,
             .server_time = gs->server_time_ms,
-            .data.hit = { .target = dmg->victim_id, .damage = actual_damage },
+            .data.hit = { .target = dmg->victim_id, .damage = actual_damage,
+                           .attacker = dmg->attacker_id },
         };
         g_event_push(&gs->events, &evt);
     }
@@ -75,6 +76,7 @@ void g_combat_kill(qk_game_state_t *gs, u8 attacker_id, u8 victim_id,
     if (!victim || victim->type != ENTITY_PLAYER) return;
 
     qk_player_state_t *vps = &victim->data.player;
+    bool was_alive = vps->alive_state == QK_PSTATE_ALIVE;
     vps->alive_state = QK_PSTATE_DEAD;
     vps->deaths++;
 
@@ -94,8 +96,8 @@ void g_combat_kill(qk_game_state_t *gs, u8 attacker_id, u8 victim_id,
     };
     g_event_push(&gs->events, &evt);
 
-    // recount alive players
-    g_ca_count_alive(gs);
+    // mode keeps its alive counts (and sees eliminations) from this
+    if (was_alive) gs->mode->player_killed(gs, victim);
 }
 
 // --- Hitscan Trace (Railgun) ---
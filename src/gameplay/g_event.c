@@ -2,17 +2,36 @@
  * QUICKEN Engine - Game Event Queue
  *
  * Push/clear game events for client consumption (killfeed, hit confirm, etc.).
+ * Events live in a ring so a busy tick (a rocket volley into a crowd)
+ * loses its oldest entries instead of silently refusing new ones.
  */
 
 #include "g_internal.h"
 
 void g_event_push(game_event_queue_t *queue, const game_event_t *event) {
     if (!queue || !event) return;
-    if (queue->count >= MAX_GAME_EVENTS_PER_TICK) return;
-    queue->events[queue->count++] = *event;
+    if (queue->head - queue->tick_first >= G_EVENT_RING_SIZE) {
+        queue->overwritten++;
+    }
+    queue->events[queue->head % G_EVENT_RING_SIZE] = *event;
+    queue->head++;
 }
 
 void g_event_clear(game_event_queue_t *queue) {
     if (!queue) return;
-    queue->count = 0;
+    queue->head = 0;
+    queue->tick_first = 0;
+    queue->overwritten = 0;
+    queue->unpacked = 0;
+}
+
+void g_event_begin_tick(game_event_queue_t *queue) {
+    if (!queue) return;
+    queue->tick_first = queue->head;
+}
+
+u32 g_event_tick_start(const game_event_queue_t *queue) {
+    u32 count = queue->head - queue->tick_first;
+    if (count > G_EVENT_RING_SIZE) return queue->head - G_EVENT_RING_SIZE;
+    return queue->tick_first;
 }
@@ -59,7 +59,7 @@ typedef struct {
     u32 server_time;
     union {
         struct { u8 attacker; u8 victim; qk_weapon_id_t weapon; } kill;
-        struct { u8 target; i16 damage; } hit;
+        struct { u8 target; i16 damage; u8 attacker; } hit;
         struct { u8 round_number; } round_start;
         struct { u8 winner_team; u8 score_a; u8 score_b; } round_end;
         struct { u8 winner_team; } match_end;
@@ -67,11 +67,16 @@ typedef struct {
     } data;
 } game_event_t;
 
-#define MAX_GAME_EVENTS_PER_TICK 32
+// Ring of recent events. head only grows; this tick's events are
+// [tick_first, head). A full ring overwrites the oldest entry.
+#define G_EVENT_RING_SIZE QK_GAME_MAX_TICK_EVENTS
 
 typedef struct {
-    game_event_t events[MAX_GAME_EVENTS_PER_TICK];
-    u32 count;
+    game_event_t events[G_EVENT_RING_SIZE];
+    u32 head;
+    u32 tick_first;
+    u32 overwritten;    // events lost to wraparound before their tick ended
+    u32 unpacked;       // events past a full qk_game_pack_events buffer
 } game_event_queue_t;
 
 // --- Damage Event ---
@@ -85,6 +90,20 @@ typedef struct {
     bool            is_self;
 } damage_event_t;
 
+// --- Game Mode Plugin ---
+/*
+ * A mode's rules, driven by events. tick runs every server tick and must
+ * be constant time while nothing is due (compare a deadline, read a
+ * counter); per-player work belongs in the event hooks.
+ */
+typedef struct g_mode {
+    const char *name;
+    void (*init)(qk_game_state_t *gs);
+    void (*tick)(qk_game_state_t *gs);
+    void (*player_killed)(qk_game_state_t *gs, const entity_t *victim);
+    void (*player_removed)(qk_game_state_t *gs, const entity_t *ent);  // alive at disconnect
+} g_mode_t;
+
 // --- Game State (opaque struct definition) ---
 struct qk_game_state {
     entity_pool_t       entities;
@@ -93,6 +112,12 @@ struct qk_game_state {
     u32                 server_time_ms;
     u8                  num_clients;
     i32                 player_entity[QK_MAX_PLAYERS]; // entity index per client, -1 = none
+    u32                 subtick_fire_mask;  // clients whose shot resolves after movement
+
+    // game mode (rules plugin and its state timing)
+    const g_mode_t     *mode;
+    u32                 mode_deadline_ms;   // server_time_ms the current state ends
+    u8                  mode_state_seen;    // last state the mode set itself
 
     // config (copied from init)
     u8                  max_players;
@@ -102,6 +127,8 @@ struct qk_game_state {
 
 };
 
+_Static_assert(QK_MAX_PLAYERS <= 32, "subtick_fire_mask holds one bit per client");
+
 // --- Entity functions (g_entity.c) ---
 void      g_entity_pool_init(entity_pool_t *pool);
 entity_t *g_entity_alloc(entity_pool_t *pool, entity_type_t type);
@@ -119,6 +146,7 @@ void g_player_apply_armor(qk_player_state_t *ps, i16 raw_damage,
 void g_weapon_tick(qk_game_state_t *gs, entity_t *player_ent, u32 tick_dt_ms);
 bool g_weapon_fire(qk_game_state_t *gs, entity_t *player_ent);
 void g_weapon_switch(entity_t *player_ent, qk_weapon_id_t new_weapon);
+void g_weapon_fire_subtick(qk_game_state_t *gs, const vec3_t *tick_start_origin);
 
 // --- Combat functions (g_combat.c) ---
 void g_combat_apply_damage(qk_game_state_t *gs, const damage_event_t *dmg);
@@ -143,8 +171,10 @@ void g_projectile_tick(qk_game_state_t *gs, f32 dt,
                        const qk_phys_world_t *world);
 
 // --- Clan Arena functions (g_ca.c) ---
+extern const g_mode_t g_mode_ca;
+
 void g_ca_init(qk_game_state_t *gs);
-void g_ca_tick(qk_game_state_t *gs, u32 dt_ms);
+void g_ca_sync_timer(qk_game_state_t *gs);
 void g_ca_start_countdown(qk_game_state_t *gs);
 void g_ca_begin_round(qk_game_state_t *gs);
 void g_ca_end_round(qk_game_state_t *gs);
@@ -154,6 +184,13 @@ void g_ca_count_alive(qk_game_state_t *gs);
 // --- Event functions (g_event.c) ---
 void g_event_push(game_event_queue_t *queue, const game_event_t *event);
 void g_event_clear(game_event_queue_t *queue);
+void g_event_begin_tick(game_event_queue_t *queue);
+// First sequence of this tick still in the ring; iterate to queue->head
+u32  g_event_tick_start(const game_event_queue_t *queue);
+
+static inline const game_event_t *g_event_at(const game_event_queue_t *queue, u32 seq) {
+    return &queue->events[seq % G_EVENT_RING_SIZE];
+}
 
 // --- Trigger functions (g_triggers.c) ---
 void g_triggers_load(const qk_teleporter_t *teleporters, u32 teleporter_count,
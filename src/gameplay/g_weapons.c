@@ -168,6 +168,61 @@ void g_weapon_tick(qk_game_state_t *gs, entity_t *player_ent, u32 tick_dt_ms) {
 
     // weapon ready: check if attack button pressed
     if (ps->last_cmd.buttons & QK_BUTTON_ATTACK) {
-        g_weapon_fire(gs, player_ent);
+        if (ps->last_cmd.attack_subtick != QK_SUBTICK_NONE) {
+            // pressed mid-tick: fire once movement has produced the
+            // end-of-tick positions to interpolate against
+            gs->subtick_fire_mask |= 1u << ps->client_num;
+        } else {
+            g_weapon_fire(gs, player_ent);
+        }
+    }
+}
+
+// --- Sub-tick Fire (after movement, before triggers) ---
+// Each deferred shot is evaluated at the moment of its press: every alive
+// player is placed at lerp(tick start, tick end, fraction) and the shooter
+// aims with the angles it had when it clicked. Origins and angles are
+// restored afterwards, so only the shot's effects (damage, kills,
+// projectiles) remain.
+void g_weapon_fire_subtick(qk_game_state_t *gs, const vec3_t *tick_start_origin) {
+    u32 mask = gs->subtick_fire_mask;
+    gs->subtick_fire_mask = 0;
+
+    for (u8 shooter = 0; shooter < QK_MAX_PLAYERS && mask; shooter++) {
+        if (!(mask & (1u << shooter))) continue;
+        mask &= ~(1u << shooter);
+
+        i32 shooter_idx = gs->player_entity[shooter];
+        if (shooter_idx < 0) continue;
+        entity_t *ent = &gs->entities.entities[shooter_idx];
+        qk_player_state_t *ps = &ent->data.player;
+        if (ps->alive_state != QK_PSTATE_ALIVE) continue;
+
+        f32 t = qk_subtick_fraction(ps->last_cmd.attack_subtick);
+
+        vec3_t tick_end_origin[QK_MAX_PLAYERS];
+        for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
+            i32 idx = gs->player_entity[i];
+            if (idx < 0) continue;
+            qk_player_state_t *other = &gs->entities.entities[idx].data.player;
+            tick_end_origin[i] = other->origin;
+            other->origin = vec3_lerp(tick_start_origin[i], other->origin, t);
+        }
+
+        f32 pitch = ps->pitch;
+        f32 yaw = ps->yaw;
+        ps->pitch = ps->last_cmd.attack_pitch;
+        ps->yaw = ps->last_cmd.attack_yaw;
+
+        g_weapon_fire(gs, ent);
+
+        ps->pitch = pitch;
+        ps->yaw = yaw;
+
+        for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
+            i32 idx = gs->player_entity[i];
+            if (idx < 0) continue;
+            gs->entities.entities[idx].data.player.origin = tick_end_origin[i];
+        }
     }
 }
@@ -11,77 +11,103 @@
 #include "core/qk_demo.h"
 
 // --- Global Game State ---
-static qk_game_state_t s_gs;
+// Points at s_gs_default unless qk_game_init was given an arena
+static qk_game_state_t s_gs_default;
+static qk_game_state_t *s_gs = &s_gs_default;
+
+_Static_assert(GEVT_KILL == (int)N_GEVT_KILL && GEVT_HIT == (int)N_GEVT_HIT &&
+               GEVT_ROUND_START == (int)N_GEVT_ROUND_START &&
+               GEVT_ROUND_END == (int)N_GEVT_ROUND_END &&
+               GEVT_MATCH_END == (int)N_GEVT_MATCH_END &&
+               GEVT_EXPLOSION == (int)N_GEVT_EXPLOSION &&
+               GEVT_COUNT == (int)N_GEVT_COUNT,
+               "game event types must match the wire enum");
 
 // --- Lifecycle ---
 
 qk_result_t qk_game_init(const qk_game_config_t *config) {
-    memset(&s_gs, 0, sizeof(s_gs));
+    s_gs = &s_gs_default;
+    if (config && config->arena) {
+        qk_game_state_t *gs = (qk_game_state_t *)qk_arena_alloc_aligned(
+            config->arena, sizeof(qk_game_state_t), 64);
+        if (gs) s_gs = gs;
+    }
+    memset(s_gs, 0, sizeof(*s_gs));
 
-    g_entity_pool_init(&s_gs.entities);
+    g_entity_pool_init(&s_gs->entities);
 
     // apply config with defaults
-    s_gs.max_players = (config && config->max_players > 0) ?
+    s_gs->max_players = (config && config->max_players > 0) ?
         config->max_players : QK_MAX_PLAYERS;
-    s_gs.rounds_to_win = (config && config->rounds_to_win > 0) ?
+    s_gs->rounds_to_win = (config && config->rounds_to_win > 0) ?
         config->rounds_to_win : QK_CA_ROUNDS_TO_WIN;
-    s_gs.round_time_limit_ms = (config && config->round_time_limit_ms > 0) ?
+    s_gs->round_time_limit_ms = (config && config->round_time_limit_ms > 0) ?
         config->round_time_limit_ms : QK_CA_ROUND_TIME_MS;
-    s_gs.countdown_time_ms = (config && config->countdown_time_ms > 0) ?
+    s_gs->countdown_time_ms = (config && config->countdown_time_ms > 0) ?
         config->countdown_time_ms : QK_CA_COUNTDOWN_MS;
 
-    s_gs.server_time_ms = 0;
-    s_gs.num_clients = 0;
+    s_gs->server_time_ms = 0;
+    s_gs->num_clients = 0;
 
     // initialize player entity mapping
     for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
-        s_gs.player_entity[i] = -1;
+        s_gs->player_entity[i] = -1;
     }
 
-    g_ca_init(&s_gs);
-    g_event_clear(&s_gs.events);
+    // Clan Arena is the only mode so far; others plug in as a g_mode_t
+    s_gs->mode = &g_mode_ca;
+    s_gs->mode->init(s_gs);
+    g_event_clear(&s_gs->events);
 
     return QK_SUCCESS;
 }
 
 void qk_game_tick(qk_phys_world_t *world, f32 dt) {
     u32 dt_ms = (u32)(dt * 1000.0f + 0.5f);
-    s_gs.server_time_ms += dt_ms;
+    s_gs->server_time_ms += dt_ms;
 
-    // clear events from previous tick
-    g_event_clear(&s_gs.events);
+    // events pushed from here on belong to this tick
+    g_event_begin_tick(&s_gs->events);
 
-    // 1. CA mode tick (state machine transitions)
-    g_ca_tick(&s_gs, dt_ms);
+    // 1. Game mode tick (state deadlines, round end)
+    s_gs->mode->tick(s_gs);
 
     // 2. Process player commands (weapon tick, view angles)
-    g_process_commands(&s_gs, dt_ms);
+    g_process_commands(s_gs, dt_ms);
 
     // 3. Physics movement for all alive players
+    vec3_t tick_start_origin[QK_MAX_PLAYERS];
     for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
-        i32 ent_idx = s_gs.player_entity[i];
+        i32 ent_idx = s_gs->player_entity[i];
         if (ent_idx < 0) continue;
 
-        entity_t *ent = &s_gs.entities.entities[ent_idx];
+        entity_t *ent = &s_gs->entities.entities[ent_idx];
         qk_player_state_t *ps = &ent->data.player;
+        tick_start_origin[i] = ps->origin;
 
         if (ps->alive_state != QK_PSTATE_ALIVE) continue;
 
         qk_physics_move(ps, &ps->last_cmd, world);
     }
 
+    // 3b. Shots pressed mid-tick, against interpolated positions
+    if (s_gs->subtick_fire_mask) {
+        g_weapon_fire_subtick(s_gs, tick_start_origin);
+    }
+
     // 4. Trigger checks (teleporters + jump pads, after physics)
-    g_triggers_tick(&s_gs);
+    g_triggers_tick(s_gs);
 
     // 5. Projectile tick (movement + collision against world and players)
-    g_projectile_tick(&s_gs, dt, world);
+    g_projectile_tick(s_gs, dt, world);
 
     // 6. Demo recording hooks
     if (qk_demo_is_recording()) {
-        u32 tick = s_gs.server_time_ms / QK_TICK_DT_MS_NOM;
-        qk_demo_record_gamestate(tick, &s_gs.ca);
-        for (u32 i = 0; i < s_gs.events.count; i++) {
-            qk_demo_record_event(tick, &s_gs.events.events[i],
+        u32 tick = s_gs->server_time_ms / QK_TICK_DT_MS_NOM;
+        g_ca_sync_timer(s_gs);
+        qk_demo_record_gamestate(tick, &s_gs->ca);
+        for (u32 seq = g_event_tick_start(&s_gs->events); seq != s_gs->events.head; seq++) {
+            qk_demo_record_event(tick, g_event_at(&s_gs->events, seq),
                                  (u16)sizeof(game_event_t));
         }
     }
@@ -94,19 +120,20 @@ void qk_game_load_triggers(const qk_teleporter_t *teleporters, u32 teleporter_co
 
 void qk_game_shutdown(void) {
     g_triggers_clear();
-    memset(&s_gs, 0, sizeof(s_gs));
+    memset(s_gs, 0, sizeof(*s_gs));
+    s_gs = &s_gs_default;  // an arena copy dies with its arena
 }
 
 // --- Player Management ---
 
 qk_result_t qk_game_player_connect(u8 client_num, const char *name, qk_team_t team) {
     if (client_num >= QK_MAX_PLAYERS) return QK_ERROR_INVALID_PARAM;
-    if (s_gs.player_entity[client_num] >= 0) return QK_ERROR_FULL;
+    if (s_gs->player_entity[client_num] >= 0) return QK_ERROR_FULL;
 
-    entity_t *ent = g_entity_alloc(&s_gs.entities, ENTITY_PLAYER);
+    entity_t *ent = g_entity_alloc(&s_gs->entities, ENTITY_PLAYER);
     if (!ent) return QK_ERROR_FULL;
 
-    s_gs.player_entity[client_num] = (i32)(ent - s_gs.entities.entities);
+    s_gs->player_entity[client_num] = (i32)(ent - s_gs->entities.entities);
 
     qk_player_state_t *ps = &ent->data.player;
     memset(ps, 0, sizeof(*ps));
@@ -119,7 +146,7 @@ qk_result_t qk_game_player_connect(u8 client_num, const char *name, qk_team_t te
     ps->max_speed = QK_PM_MAX_SPEED;
     ps->gravity = QK_PM_GRAVITY;
 
-    s_gs.num_clients++;
+    s_gs->num_clients++;
 
     QK_UNUSED(name);
     return QK_SUCCESS;
@@ -127,21 +154,25 @@ qk_result_t qk_game_player_connect(u8 client_num, const char *name, qk_team_t te
 
 void qk_game_player_disconnect(u8 client_num) {
     if (client_num >= QK_MAX_PLAYERS) return;
-    i32 idx = s_gs.player_entity[client_num];
+    i32 idx = s_gs->player_entity[client_num];
     if (idx < 0) return;
 
-    g_entity_free(&s_gs.entities, &s_gs.entities.entities[idx]);
-    s_gs.player_entity[client_num] = -1;
+    entity_t *ent = &s_gs->entities.entities[idx];
+    if (ent->data.player.alive_state == QK_PSTATE_ALIVE) {
+        s_gs->mode->player_removed(s_gs, ent);
+    }
+    g_entity_free(&s_gs->entities, ent);
+    s_gs->player_entity[client_num] = -1;
 
-    if (s_gs.num_clients > 0) s_gs.num_clients--;
+    if (s_gs->num_clients > 0) s_gs->num_clients--;
 }
 
 void qk_game_player_command(u8 client_num, const qk_usercmd_t *cmd) {
     if (client_num >= QK_MAX_PLAYERS || !cmd) return;
-    i32 idx = s_gs.player_entity[client_num];
+    i32 idx = s_gs->player_entity[client_num];
     if (idx < 0) return;
 
-    entity_t *ent = &s_gs.entities.entities[idx];
+    entity_t *ent = &s_gs->entities.entities[idx];
     ent->data.player.last_cmd = *cmd;
 }
 
@@ -149,24 +180,25 @@ void qk_game_player_command(u8 client_num, const qk_usercmd_t *cmd) {
 
 const qk_player_state_t *qk_game_get_player_state(u8 client_num) {
     if (client_num >= QK_MAX_PLAYERS) return NULL;
-    i32 idx = s_gs.player_entity[client_num];
+    i32 idx = s_gs->player_entity[client_num];
     if (idx < 0) return NULL;
-    return &s_gs.entities.entities[idx].data.player;
+    return &s_gs->entities.entities[idx].data.player;
 }
 
 qk_player_state_t *qk_game_get_player_state_mut(u8 client_num) {
     if (client_num >= QK_MAX_PLAYERS) return NULL;
-    i32 idx = s_gs.player_entity[client_num];
+    i32 idx = s_gs->player_entity[client_num];
     if (idx < 0) return NULL;
-    return &s_gs.entities.entities[idx].data.player;
+    return &s_gs->entities.entities[idx].data.player;
 }
 
 const qk_ca_state_t *qk_game_get_ca_state(void) {
-    return &s_gs.ca;
+    g_ca_sync_timer(s_gs);
+    return &s_gs->ca;
 }
 
 qk_game_state_t *qk_game_get_state(void) {
-    return &s_gs;
+    return s_gs;
 }
 
 // --- Entity Packing (for netcode) ---
@@ -175,7 +207,7 @@ void qk_game_pack_entity(u8 entity_id, n_entity_state_t *out) {
     if (!out) return;
     memset(out, 0, sizeof(*out));
 
-    entity_t *ent = &s_gs.entities.entities[entity_id];
+    entity_t *ent = &s_gs->entities.entities[entity_id];
     if (!ent->active || ent->type == ENTITY_NONE) return;
 
     if (ent->type == ENTITY_PLAYER) {
@@ -234,11 +266,11 @@ void qk_game_pack_entity(u8 entity_id, n_entity_state_t *out) {
 }
 
 u32 qk_game_get_entity_count(void) {
-    return s_gs.entities.high_water;
+    return s_gs->entities.high_water;
 }
 
 bool qk_game_get_entity_origin(u8 entity_id, f32 *x, f32 *y, f32 *z) {
-    entity_t *ent = &s_gs.entities.entities[entity_id];
+    entity_t *ent = &s_gs->entities.entities[entity_id];
     if (!ent->active) return false;
     if (ent->type == ENTITY_PLAYER) {
         *x = ent->data.player.origin.x;
@@ -258,21 +290,92 @@ bool qk_game_get_entity_origin(u8 entity_id, f32 *x, f32 *y, f32 *z) {
 
 u32 qk_game_get_explosions(qk_explosion_event_t *out_events, u32 max_events) {
     u32 count = 0;
-    for (u32 i = 0; i < s_gs.events.count && count < max_events; i++) {
-        if (s_gs.events.events[i].type == GEVT_EXPLOSION) {
-            out_events[count].pos[0] = s_gs.events.events[i].data.explosion.pos[0];
-            out_events[count].pos[1] = s_gs.events.events[i].data.explosion.pos[1];
-            out_events[count].pos[2] = s_gs.events.events[i].data.explosion.pos[2];
-            out_events[count].dir[0] = s_gs.events.events[i].data.explosion.dir[0];
-            out_events[count].dir[1] = s_gs.events.events[i].data.explosion.dir[1];
-            out_events[count].dir[2] = s_gs.events.events[i].data.explosion.dir[2];
-            out_events[count].radius = s_gs.events.events[i].data.explosion.radius;
+    for (u32 seq = g_event_tick_start(&s_gs->events);
+         seq != s_gs->events.head && count < max_events; seq++) {
+        const game_event_t *evt = g_event_at(&s_gs->events, seq);
+        if (evt->type == GEVT_EXPLOSION) {
+            out_events[count].pos[0] = evt->data.explosion.pos[0];
+            out_events[count].pos[1] = evt->data.explosion.pos[1];
+            out_events[count].pos[2] = evt->data.explosion.pos[2];
+            out_events[count].dir[0] = evt->data.explosion.dir[0];
+            out_events[count].dir[1] = evt->data.explosion.dir[1];
+            out_events[count].dir[2] = evt->data.explosion.dir[2];
+            out_events[count].radius = evt->data.explosion.radius;
             count++;
         }
     }
     return count;
 }
 
+// --- Event Packing for Netcode ---
+
+static i16 quant_pos(f32 v) {
+    f32 q = v * 2.0f;
+    if (q > 32767.0f) q = 32767.0f;
+    if (q < -32768.0f) q = -32768.0f;
+    return (i16)q;
+}
+
+static i8 quant_dir(f32 v) {
+    f32 q = v * 127.0f;
+    if (q > 127.0f) q = 127.0f;
+    if (q < -127.0f) q = -127.0f;
+    return (i8)q;
+}
+
+u32 qk_game_pack_events(n_game_event_t *out_events, u32 max_events) {
+    u32 count = 0;
+    u32 seq = g_event_tick_start(&s_gs->events);
+    for (; seq != s_gs->events.head && count < max_events; seq++) {
+        const game_event_t *evt = g_event_at(&s_gs->events, seq);
+        n_game_event_t *out = &out_events[count++];
+        memset(out, 0, sizeof(*out));
+        out->type = (u8)evt->type;
+
+        switch (evt->type) {
+            case GEVT_KILL:
+                out->data.kill.attacker = evt->data.kill.attacker;
+                out->data.kill.victim = evt->data.kill.victim;
+                out->data.kill.weapon = (u8)evt->data.kill.weapon;
+                break;
+            case GEVT_HIT:
+                out->data.hit.target = evt->data.hit.target;
+                out->data.hit.attacker = evt->data.hit.attacker;
+                out->data.hit.damage = evt->data.hit.damage;
+                break;
+            case GEVT_ROUND_START:
+                out->data.round_start.round_number = evt->data.round_start.round_number;
+                break;
+            case GEVT_ROUND_END:
+                out->data.round_end.winner_team = evt->data.round_end.winner_team;
+                out->data.round_end.score_a = evt->data.round_end.score_a;
+                out->data.round_end.score_b = evt->data.round_end.score_b;
+                break;
+            case GEVT_MATCH_END:
+                out->data.match_end.winner_team = evt->data.match_end.winner_team;
+                break;
+            case GEVT_EXPLOSION: {
+                f32 radius = evt->data.explosion.radius;
+                for (u32 k = 0; k < 3; k++) {
+                    out->data.explosion.pos[k] = quant_pos(evt->data.explosion.pos[k]);
+                    out->data.explosion.dir[k] = quant_dir(evt->data.explosion.dir[k]);
+                }
+                out->data.explosion.radius = (u8)(radius > 255.0f ? 255.0f : radius);
+                break;
+            }
+            default:
+                count--;
+                break;
+        }
+    }
+    s_gs->events.unpacked += s_gs->events.head - seq;
+    return count;
+}
+
+u32 qk_game_get_events_lost(void) {
+    return s_gs->events.overwritten + s_gs->events.unpacked;
+}
+
 // --- Process Commands (called during tick) ---
 
 void g_process_commands(qk_game_state_t *gs, u32 tick_dt_ms) {
@@ -30,6 +30,8 @@
 #include "core/qk_prof.h"
 #include "core/qk_demo.h"
 #include "core/qk_cpuid.h"
+#include "core/qk_job.h"
+#include "core/qk_scratch.h"
 #include "core/qk_simd_dispatch.h"
 #include "ui/qk_console.h"
 
@@ -76,6 +78,13 @@ static qk_cvar_t *s_cvar_r_fullscreen;
 static qk_cvar_t *s_cvar_r_perflog;
 static qk_cvar_t *s_cvar_r_ambient;
 static qk_cvar_t *s_cvar_r_bloom_strength;
+static qk_cvar_t *s_cvar_cl_smooth_time;
+static qk_cvar_t *s_cvar_cl_smooth_snap;
+
+/* Renderer tunables are polled once per frame with qk_cvar_changed instead
+ * of using callbacks; the sentinel pushes the current values on frame 1. */
+static u32 s_seen_r_ambient        = UINT32_MAX;
+static u32 s_seen_r_bloom_strength = UINT32_MAX;
 
 // Window pointer for cvar callbacks
 static qk_window_t *s_window;
@@ -86,12 +95,21 @@ static void cb_perflog_changed(qk_cvar_t *cvar) {
     qk_perf_set_enabled(cvar->value.b);
 }
 
-static void cb_ambient_changed(qk_cvar_t *cvar) {
-    qk_renderer_set_ambient(cvar->value.f);
+static void cb_predict_smoothing_changed(qk_cvar_t *cvar) {
+    QK_UNUSED(cvar);
+    if (!s_cvar_cl_smooth_time || !s_cvar_cl_smooth_snap) return;
+    cl_predict_set_error_smoothing(s_cvar_cl_smooth_time->value.f,
+                                   s_cvar_cl_smooth_snap->value.f);
 }
 
-static void cb_bloom_strength_changed(qk_cvar_t *cvar) {
-    qk_renderer_set_bloom_strength(cvar->value.f);
+// --- Netcode extrapolation collision ---
+
+static vec3_t extrap_trace(void *user, vec3_t start, vec3_t end) {
+    const qk_phys_world_t *world = (const qk_phys_world_t *)user;
+    if (!world) return end;
+    qk_trace_result_t tr = qk_physics_trace(world, start, end,
+                                            QK_PLAYER_MINS, QK_PLAYER_MAXS);
+    return tr.start_solid ? start : tr.end_pos;
 }
 
 // --- vid_restart callback ---
@@ -127,6 +145,24 @@ static void cb_fullscreen_changed(qk_cvar_t *cvar) {
     }
 }
 
+static void cmd_gpu_timers(i32 argc, const char **argv) {
+    QK_UNUSED(argc);
+    QK_UNUSED(argv);
+
+    qk_gpu_region_t regions[32];
+    u64 frame = 0;
+    u32 count = qk_renderer_get_gpu_regions(regions, 32, &frame);
+    if (count == 0) {
+        qk_console_print("No GPU timestamps (unsupported or not resolved yet).");
+        return;
+    }
+    qk_console_printf("GPU regions, frame %llu:", (unsigned long long)frame);
+    for (u32 i = 0; i < count; i++) {
+        qk_console_printf("%*s%-20s %7.3f ms", (int)(regions[i].depth * 2), "",
+                          regions[i].name, regions[i].ms);
+    }
+}
+
 static void cmd_vid_restart(i32 argc, const char **argv) {
     QK_UNUSED(argc);
     QK_UNUSED(argv);
@@ -145,10 +181,12 @@ static void cmd_vid_restart(i32 argc, const char **argv) {
 // --- Server Tick ---
 
 static void server_tick(qk_phys_world_t *phys_world) {
+    qk_scratch_advance(QK_SCRATCH_TICK);
+
     // 0. Detect remote client connects and disconnects
     for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
         bool was_ready = s_client_map_ready[i];
-        bool is_ready = qk_net_server_is_client_map_ready(i);
+        bool is_ready = qk_net_server_is_client_player(i);     // relays get no player
 
         if (is_ready && !was_ready) {
             qk_game_player_connect(i, "Remote", QK_TEAM_ALPHA);
@@ -180,6 +218,13 @@ static void server_tick(qk_phys_world_t *phys_world) {
         }
     }
 
+    // 2c. Game events ride the snapshots (hit confirms, killfeed)
+    {
+        n_game_event_t net_events[QK_GAME_MAX_TICK_EVENTS];
+        u32 net_count = qk_game_pack_events(net_events, QK_GAME_MAX_TICK_EVENTS);
+        qk_net_server_push_events(net_events, net_count);
+    }
+
     // 3. Pack entity states for netcode snapshot
     for (u32 i = 0; i < qk_game_get_entity_count(); i++) {
         n_entity_state_t net_state;
@@ -195,6 +240,38 @@ static void server_tick(qk_phys_world_t *phys_world) {
     qk_net_server_tick();
 }
 
+// --- Network Game Events ---
+
+// Killfeed and hit markers from the server's event stream. Explosions come
+// from here only when remote; a local server hands them over directly.
+static void client_consume_events(u8 local_id, bool remote, f64 now) {
+    n_game_event_t events[64];
+    u32 count;
+    while ((count = qk_net_client_poll_events(events, 64)) > 0) {
+        for (u32 i = 0; i < count; i++) {
+            const n_game_event_t *evt = &events[i];
+            if (evt->type == N_GEVT_HIT) {
+                if (evt->data.hit.attacker == local_id) {
+                    qk_ui_event_hit(evt->data.hit.damage);
+                }
+            } else if (evt->type == N_GEVT_KILL) {
+                char attacker[16], victim[16];
+                snprintf(attacker, sizeof(attacker), "player%u", (u32)evt->data.kill.attacker);
+                snprintf(victim, sizeof(victim), "player%u", (u32)evt->data.kill.victim);
+                qk_ui_event_kill(attacker, victim, (qk_weapon_id_t)evt->data.kill.weapon);
+            } else if (evt->type == N_GEVT_EXPLOSION && remote) {
+                qk_explosion_event_t expl;
+                for (u32 k = 0; k < 3; k++) {
+                    expl.pos[k] = (f32)evt->data.explosion.pos[k] * 0.5f;
+                    expl.dir[k] = (f32)evt->data.explosion.dir[k] / 127.0f;
+                }
+                expl.radius = (f32)evt->data.explosion.radius;
+                cl_fx_add_explosions(&expl, 1, now);
+            }
+        }
+    }
+}
+
 // --- Map Console Command ---
 
 static void cmd_map(i32 argc, const char **argv) {
@@ -264,6 +341,7 @@ static void restore_loopback_netcode(void) {
 
     qk_net_client_config_t ncc = {
         .interp_delay = 0.0,
+        .local_direct = true,
     };
     qk_net_client_init(&ncc);
     qk_net_client_connect_local();
@@ -409,6 +487,7 @@ int main(int argc, char *argv[]) {
 #endif
     qk_cpuid_print();
     printf("SIMD tier: %s\n", qk_simd_tier_name(qk_simd_get_tier()));
+    qk_job_init(&(qk_job_config_t){ .worker_count = 0, .pin = QK_JOB_PIN_NONE });
     printf("\n");
 
     // --- Parse arguments ---
@@ -488,12 +567,18 @@ int main(int argc, char *argv[]) {
     s_cvar_r_perflog = qk_cvar_register_bool("r_perflog", false, 0,
                                                cb_perflog_changed);
     s_cvar_r_ambient = qk_cvar_register_float("r_ambient", 0.0125f, 0.0f, 2.0f,
-                                                QK_CVAR_ARCHIVE,
-                                                cb_ambient_changed);
+                                                QK_CVAR_ARCHIVE, NULL);
     s_cvar_r_bloom_strength = qk_cvar_register_float("r_bloom_strength", 0.3f,
                                                        0.0f, 2.0f,
-                                                       QK_CVAR_ARCHIVE,
-                                                       cb_bloom_strength_changed);
+                                                       QK_CVAR_ARCHIVE, NULL);
+    s_cvar_cl_smooth_time = qk_cvar_register_float("cl_smooth_time", 0.05f,
+                                                     0.0f, 1.0f,
+                                                     QK_CVAR_ARCHIVE,
+                                                     cb_predict_smoothing_changed);
+    s_cvar_cl_smooth_snap = qk_cvar_register_float("cl_smooth_snap", 64.0f,
+                                                     0.0f, 1024.0f,
+                                                     QK_CVAR_ARCHIVE,
+                                                     cb_predict_smoothing_changed);
 
     qk_perf_init();
     qk_demo_init();
@@ -506,6 +591,8 @@ int main(int argc, char *argv[]) {
                              "Load a map by name (e.g. map asylum)");
     qk_console_register_cmd("vid_restart", cmd_vid_restart,
                              "Apply render setting changes");
+    qk_console_register_cmd("gpu_timers", cmd_gpu_timers,
+                             "Print the newest resolved GPU region timings");
     qk_console_register_cmd("demo_record", cmd_demo_record,
                              "Start recording a demo");
     qk_console_register_cmd("demo_stop", cmd_demo_stop,
@@ -519,9 +606,8 @@ int main(int argc, char *argv[]) {
     qk_console_register_cmd("disconnect", cmd_disconnect,
                              "Disconnect from remote server");
 
-    // Manually fire off callbacks since the renderer is already init
-    cb_ambient_changed(s_cvar_r_ambient);
-    cb_bloom_strength_changed(s_cvar_r_bloom_strength);
+    // Apply the initial smoothing values; later edits arrive by callback
+    cb_predict_smoothing_changed(s_cvar_cl_smooth_time);
 
     // --- Initial world (test room as baseline) ---
     qk_map_data_t map_data = {0};
@@ -554,6 +640,7 @@ int main(int argc, char *argv[]) {
 
     qk_net_client_config_t ncc = {
         .interp_delay = 0.0,
+        .local_direct = true,
     };
 
     res = qk_net_client_init(&ncc);
@@ -614,6 +701,7 @@ int main(int argc, char *argv[]) {
     while (running) {
         qk_perf_begin_frame();
         QK_PROF_FRAME_BEGIN();
+        qk_scratch_advance(QK_SCRATCH_FRAME);
 
         f64 now = qk_platform_time_now();
         f32 real_dt = (f32)(now - prev_time);
@@ -641,6 +729,9 @@ int main(int argc, char *argv[]) {
             break;
         }
 
+        // Cvar change callbacks (console edits land during input poll)
+        qk_cvar_dispatch_callbacks();
+
         // Sync local_client_id from file-static (console commands may change it)
         local_client_id = s_local_client_id;
 
@@ -690,6 +781,7 @@ int main(int argc, char *argv[]) {
 
                     qk_net_client_config_t ncc2 = {
                         .interp_delay = 0.0,
+                        .local_direct = true,
                     };
                     qk_net_client_init(&ncc2);
                     qk_net_client_connect_local();
@@ -857,6 +949,7 @@ int main(int argc, char *argv[]) {
 
             QK_PROF_ZONE_BEGIN("net_client");
             qk_net_client_tick();
+            client_consume_events(local_client_id, s_conn_mode == CONN_MODE_REMOTE, now);
             QK_PROF_ZONE_END("net_client");
             QK_PROF_ZONE_BEGIN("reconcile");
             cl_predict_reconcile(phys_world);
@@ -868,16 +961,16 @@ int main(int argc, char *argv[]) {
                 f64 render_tick = input_tick - 2.0;
                 if (render_tick < 0.0) render_tick = 0.0;
                 f64 render_time = render_tick * QK_TICK_DT_F64;
+                qk_net_client_set_extrap_trace(extrap_trace, phys_world);
                 qk_net_client_interpolate(render_time);
             }
             QK_PROF_ZONE_END("interp");
 
             if (cl_predict_has_state()) {
-                const qk_player_state_t *pred = cl_predict_get_state();
-                f32 pred_alpha = cl_predict_get_accumulator() / QK_TICK_DT;
-                cam_x = pred->origin.x + pred->velocity.x * QK_TICK_DT * pred_alpha;
-                cam_y = pred->origin.y + pred->velocity.y * QK_TICK_DT * pred_alpha;
-                cam_z = pred->origin.z + pred->velocity.z * QK_TICK_DT * pred_alpha;
+                vec3_t cam_pos = cl_predict_get_render_origin();
+                cam_x = cam_pos.x;
+                cam_y = cam_pos.y;
+                cam_z = cam_pos.z;
             }
             cam_pitch = qk_input_get_pitch();
             cam_yaw = qk_input_get_yaw();
@@ -905,6 +998,7 @@ int main(int argc, char *argv[]) {
 
             QK_PROF_ZONE_BEGIN("net_client");
             qk_net_client_tick();
+            client_consume_events(local_client_id, s_conn_mode == CONN_MODE_REMOTE, now);
             QK_PROF_ZONE_END("net_client");
             QK_PROF_ZONE_BEGIN("reconcile");
             cl_predict_reconcile(phys_world);
@@ -917,16 +1011,16 @@ int main(int argc, char *argv[]) {
                 f64 render_tick = srv_tick + frac - 1.0;
                 if (render_tick < 0.0) render_tick = 0.0;
                 f64 render_time = render_tick * QK_TICK_DT_F64;
+                qk_net_client_set_extrap_trace(extrap_trace, phys_world);
                 qk_net_client_interpolate(render_time);
             }
             QK_PROF_ZONE_END("interp");
 
             if (cl_predict_has_state()) {
-                const qk_player_state_t *pred = cl_predict_get_state();
-                f32 pred_alpha = cl_predict_get_accumulator() / QK_TICK_DT;
-                cam_x = pred->origin.x + pred->velocity.x * QK_TICK_DT * pred_alpha;
-                cam_y = pred->origin.y + pred->velocity.y * QK_TICK_DT * pred_alpha;
-                cam_z = pred->origin.z + pred->velocity.z * QK_TICK_DT * pred_alpha;
+                vec3_t cam_pos = cl_predict_get_render_origin();
+                cam_x = cam_pos.x;
+                cam_y = cam_pos.y;
+                cam_z = cam_pos.z;
             }
             cam_pitch = qk_input_get_pitch();
             cam_yaw = qk_input_get_yaw();
@@ -951,6 +1045,15 @@ int main(int argc, char *argv[]) {
                                                fov, aspect);
         QK_PROF_ZONE_END("camera");
 
+        if (s_cvar_r_ambient &&
+            qk_cvar_changed(s_cvar_r_ambient, &s_seen_r_ambient)) {
+            qk_renderer_set_ambient(s_cvar_r_ambient->value.f);
+        }
+        if (s_cvar_r_bloom_strength &&
+            qk_cvar_changed(s_cvar_r_bloom_strength, &s_seen_r_bloom_strength)) {
+            qk_renderer_set_bloom_strength(s_cvar_r_bloom_strength->value.f);
+        }
+
         // --- Render ---
         QK_PROF_ZONE_BEGIN("render_begin");
         qk_renderer_begin_frame(&camera);
@@ -1035,6 +1138,11 @@ int main(int argc, char *argv[]) {
 
         // --- Profiler data ---
         {
+            qk_scratch_stats_t scratch;
+            qk_scratch_get_stats(&scratch);
+            qk_perf_set_scratch_usage(scratch.high_water[QK_SCRATCH_FRAME],
+                                      scratch.high_water[QK_SCRATCH_TICK]);
+
             qk_gpu_stats_t stats;
             qk_renderer_get_stats(&stats);
             qk_perf_end_frame(
@@ -1049,6 +1157,7 @@ int main(int argc, char *argv[]) {
                 stats.acquire_ms);
         }
 
+        qk_job_prof_flush();
         QK_PROF_FRAME_END();
     }
 
@@ -1071,6 +1180,8 @@ shutdown:
     qk_renderer_shutdown();
     qk_window_destroy(window);
     qk_map_free(&map_data);
+    qk_job_shutdown();
+    qk_scratch_shutdown();
 
     printf("Clean shutdown.\n");
     return 0;
@@ -47,13 +47,14 @@ static f64 client_render_time(const n_client_t *client) {
 
 // --- Lifecycle ---
 
-void n_client_init(n_client_t *client, f64 interp_delay) {
+void n_client_init(n_client_t *client, f64 interp_delay, f64 extrap_limit) {
     memset(client, 0, sizeof(*client));
 
     client->conn_state = N_CONN_DISCONNECTED;
     client->transport.socket_fd = -1;
     n_reliable_init(&client->reliable);
     n_clock_init(&client->clock);
+    client->time_scale = 1.0f;
 
     if (interp_delay > 0.0) {
         if (interp_delay < N_INTERP_DELAY_MIN) interp_delay = N_INTERP_DELAY_MIN;
@@ -62,6 +63,7 @@ void n_client_init(n_client_t *client, f64 interp_delay) {
     } else {
         client->interp_delay = N_INTERP_DELAY_DEFAULT;
     }
+    client->extrap_limit = extrap_limit != 0.0 ? extrap_limit : N_EXTRAP_LIMIT_DEFAULT;
 
     client->initialized = true;
 }
@@ -102,6 +104,7 @@ void n_client_connect_remote(n_client_t *client, const char *address, u16 port)
     }
 
     client->is_loopback = false;
+    n_msg_queue_reset(&client->outgoing);
     client->conn_state = N_CONN_CONNECTING;
     client->client_challenge = n_random_u32();
     client->connect_start_time = n_platform_time();
@@ -140,18 +143,19 @@ void n_client_connect_local(n_client_t *client, n_server_t *srv) {
     server_slot->state = N_CONN_CONNECTED;
     server_slot->is_loopback = true;
     server_slot->map_ready = true;  // loopback: same process, map is shared
+    server_slot->direct = client->local_direct;
     server_slot->last_packet_recv_time = now;
     srv->client_count++;
 
     client->conn_state = N_CONN_CONNECTED;
     client->client_id = (u8)slot;
     client->input_tick = srv->tick;
+    client->event_tick = srv->tick;
+    server_slot->event_ack = srv->tick;
+    client->has_input_depth = false;
+    client->time_scale = 1.0f;
     client->map_ready = true;   // loopback: same process, map is shared
 
-    // Zero clock offset for loopback (zero latency, same clock)
-    client->clock.smoothed_offset = (f64)srv->tick * N_TICK_INTERVAL - now;
-    client->clock.converged = true;
-
     N_DBG("connect_local: connected as client_id=%u, server_tick=%u", (u32)slot, srv->tick);
 }
 
@@ -180,11 +184,16 @@ void n_client_disconnect(n_client_t *client) {
     }
 
     n_transport_close(&client->transport);
+    n_msg_queue_reset(&client->outgoing);
     client->conn_state = N_CONN_DISCONNECTED;
     client->has_baseline = false;
     client->interp_count = 0;
     client->interp_write = 0;
     client->map_ready = false;
+    client->extrap_base_tick = 0;
+    memset(client->blend_offset, 0, sizeof(client->blend_offset));
+    client->event_read = client->event_head;
+    client->event_ack_pending = false;
     n_clock_init(&client->clock);
 }
 
@@ -199,8 +208,11 @@ static void send_connect_request(n_client_t *client) {
     n_bitwriter_t writer;
     n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE,
                      N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-    n_msg_header_write(&writer, N_MSG_CONNECT_REQUEST, 4);
+    // Flags byte only when set, so plain requests keep the 4-byte payload
+    bool has_flags = client->connect_flags != 0;
+    n_msg_header_write(&writer, N_MSG_CONNECT_REQUEST, has_flags ? 5 : 4);
     n_write_u32(&writer, client->client_challenge);
+    if (has_flags) n_write_u8(&writer, client->connect_flags);
     n_msg_header_write(&writer, N_MSG_NOP, 0);
 
     u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
@@ -227,32 +239,6 @@ static void send_connect_response(n_client_t *client) {
     client->stats.packets_sent++;
 }
 
-// --- Send clock sync probe ---
-
-static void send_clock_sync(n_client_t *client) {
-    u8 pkt[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = client->outgoing_sequence++;
-    hdr.ack = client->incoming_sequence;
-    hdr.ack_bitfield = client->ack_bitfield;
-    n_packet_header_write(pkt, &hdr);
-
-    n_bitwriter_t writer;
-    n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-    n_msg_header_write(&writer, N_MSG_CLOCK_SYNC, 8);
-
-    f64 now = n_platform_time();
-    client->clock_sync_send_time = now;
-    n_write_f64(&writer, now);
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
-
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_transport_send(&client->transport, &client->server_address, pkt, total);
-    n_clock_mark_sent(&client->clock, now);
-    client->stats.packets_sent++;
-}
-
 // --- Packet processing ---
 
 static void update_client_ack_bitfield(n_client_t *client, u16 remote_seq) {
@@ -277,8 +263,74 @@ static void update_client_ack_bitfield(n_client_t *client, u16 remote_seq) {
     }
 }
 
+static void update_time_scale(n_client_t *client, i8 depth) {
+    if (depth == N_INPUT_DEPTH_UNKNOWN) return;
+
+    if (!client->has_input_depth) {
+        client->input_depth = (f32)depth;
+        client->has_input_depth = true;
+    } else {
+        client->input_depth += ((f32)depth - client->input_depth) * N_INPUT_DEPTH_SMOOTHING;
+    }
+
+    // Too little slack: run the command clock faster so inputs arrive
+    // earlier; too much: run it slower to shed buffered latency.
+    f32 adjust = (N_INPUT_DEPTH_TARGET - client->input_depth) * N_TIME_SCALE_GAIN;
+    if (adjust < -N_TIME_SCALE_LIMIT) adjust = -N_TIME_SCALE_LIMIT;
+    if (adjust >  N_TIME_SCALE_LIMIT) adjust =  N_TIME_SCALE_LIMIT;
+    client->time_scale = 1.0f + adjust;
+}
+
+// Command ack, input depth and clock sample: everything in a snapshot
+// header the client acts on before decoding
+static void apply_snapshot_header(n_client_t *client, u32 current_tick, u32 cmd_ack,
+                                  i8 input_depth, u32 echo_time_us, u16 hold_us) {
+    client->last_server_cmd_ack = cmd_ack;
+    update_time_scale(client, input_depth);
+
+    // Clock sample: the snapshot left the server at its tick time
+    u64 arrival_us = n_platform_time_us();
+    u32 rtt_us = N_CLOCK_RTT_UNKNOWN;
+    if (hold_us != N_CLOCK_HOLD_UNKNOWN) {
+        u32 round_trip = (u32)arrival_us - echo_time_us;   // wraps correctly
+        if (round_trip >= hold_us && round_trip - hold_us < (u32)N_TIMEOUT_SEC * 1000000u) {
+            rtt_us = round_trip - hold_us;
+        }
+    }
+    n_clock_add_sample(&client->clock, (u64)current_tick * 1000000 / N_TICK_RATE,
+                       arrival_us, rtt_us);
+}
+
+// The snapshot at interp_write is complete: publish it
+static void commit_snapshot(n_client_t *client) {
+    u32 write_idx = client->interp_write;
+    const n_snapshot_t *dest = &client->interp_snapshots[write_idx];
+
+    // Teleport handling: do NOT flush the interp buffer here.
+    // Flushing destroys the delta-decode baseline chain, causing most
+    // subsequent snapshots to be dropped (base_tick mismatch).
+    // Instead, teleport is handled per-entity in n_client_interpolate()
+    // via XOR comparison of the toggle bit between snap_a and snap_b.
+    // When the bit differs, that entity snaps to destination without
+    // lerp.  Other entities (projectiles, etc.) interpolate normally.
+    client->interp_write = (write_idx + 1) % N_INTERP_BUFFER_SIZE;
+    if (client->interp_count < N_INTERP_BUFFER_SIZE) {
+        client->interp_count++;
+    }
+
+    // Update baseline: the most recent fully decoded snapshot
+    client->baseline_snapshot = *dest;
+    client->has_baseline = true;
+
+    // Demo recording hook
+    if (qk_demo_is_recording()) {
+        qk_demo_record_snapshot(dest->tick, dest->entity_count,
+                                dest->entity_mask, dest->entities);
+    }
+}
+
 static void handle_snapshot_message(n_client_t *client, const u8 *payload, u32 len) {
-    if (len < 12) return;
+    if (len < 19) return;
 
     n_bitreader_t reader;
     n_bitreader_init(&reader, payload, len);
@@ -286,16 +338,19 @@ static void handle_snapshot_message(n_client_t *client, const u8 *payload, u32 l
     u32 base_tick = n_read_u32(&reader);
     u32 current_tick = n_read_u32(&reader);
     u32 cmd_ack = n_read_u32(&reader);
+    i8 input_depth = (i8)n_read_u8(&reader);
+    u32 echo_time_us = n_read_u32(&reader);
+    u16 hold_us = n_read_u16(&reader);
 
     if (n_bitreader_overflowed(&reader)) return;
 
-    client->last_server_cmd_ack = cmd_ack;
+    apply_snapshot_header(client, current_tick, cmd_ack, input_depth, echo_time_us, hold_us);
 
     // Read full-precision player state (if present)
     u8 has_ps = n_read_u8(&reader);
     if (n_bitreader_overflowed(&reader)) return;
 
-    u32 header_consumed = 13; // 12 + 1 flag byte
+    u32 header_consumed = 20; // 19 + 1 flag byte
     if (has_ps) {
         if (len < header_consumed + sizeof(n_player_state_t)) return;
         u8 *ps_bytes = (u8 *)&client->server_player_state;
@@ -344,34 +399,41 @@ static void handle_snapshot_message(n_client_t *client, const u8 *payload, u32 l
     }
 
     // Decode snapshot
-    u32 write_idx = client->interp_write;
-    n_snapshot_t *dest = &client->interp_snapshots[write_idx];
+    n_snapshot_t *dest = &client->interp_snapshots[client->interp_write];
 
     if (!n_snapshot_delta_decode(baseline, dest, delta_buf, delta_bytes, current_tick)) {
         return;
     }
 
-    // Teleport handling: do NOT flush the interp buffer here.
-    // Flushing destroys the delta-decode baseline chain, causing most
-    // subsequent snapshots to be dropped (base_tick mismatch).
-    // Instead, teleport is handled per-entity in n_client_interpolate()
-    // via XOR comparison of the toggle bit between snap_a and snap_b.
-    // When the bit differs, that entity snaps to destination without
-    // lerp.  Other entities (projectiles, etc.) interpolate normally.
-    client->interp_write = (write_idx + 1) % N_INTERP_BUFFER_SIZE;
-    if (client->interp_count < N_INTERP_BUFFER_SIZE) {
-        client->interp_count++;
-    }
+    commit_snapshot(client);
+}
 
-    // Update baseline: the most recent fully decoded snapshot
-    client->baseline_snapshot = *dest;
-    client->has_baseline = true;
+// Events newer than event_tick are new; everything through the message's
+// through-tick is now held, whatever arrived out of order before it
+static void handle_events_message(n_client_t *client, const u8 *payload, u32 len) {
+    if (len < 5) return;
 
-    // Demo recording hook
-    if (qk_demo_is_recording()) {
-        qk_demo_record_snapshot(dest->tick, dest->entity_count,
-                                dest->entity_mask, dest->entities);
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, payload, len);
+    u32 through_tick = n_read_u32(&reader);
+    u32 count = n_read_u8(&reader);
+    if (through_tick <= client->event_tick) return;
+
+    for (u32 i = 0; i < count; i++) {
+        n_game_event_t evt;
+        u8 age;
+        if (!n_game_event_read(&reader, &evt, &age)) return;
+        if (age > through_tick) continue;
+        evt.tick = through_tick - age;
+        if (evt.tick <= client->event_tick) continue;
+
+        client->events[client->event_head % N_EVENT_RING_SIZE] = evt;
+        client->event_head++;
+        client->stats.events_received++;
     }
+
+    client->event_tick = through_tick;
+    client->event_ack_pending = true;
 }
 
 static void handle_connect_challenge(n_client_t *client, const u8 *payload, u32 len) {
@@ -400,6 +462,8 @@ static void handle_connect_accepted(n_client_t *client, const u8 *payload, u32 l
 
     client->conn_state = N_CONN_CONNECTED;
     client->input_tick = server_tick;
+    client->has_input_depth = false;
+    client->time_scale = 1.0f;
 
     // Read map name (if present in payload)
     client->server_map_name[0] = '\0';
@@ -413,11 +477,6 @@ static void handle_connect_accepted(n_client_t *client, const u8 *payload, u32 l
             N_DBG("connect_accepted: map='%s'", client->server_map_name);
         }
     }
-
-    // Initialize clock offset estimate from server tick
-    f64 now = n_platform_time();
-    f64 server_time = (f64)server_tick * N_TICK_INTERVAL;
-    client->clock.smoothed_offset = server_time - now;
 }
 
 static void handle_connect_rejected(n_client_t *client) {
@@ -425,25 +484,6 @@ static void handle_connect_rejected(n_client_t *client) {
     n_transport_close(&client->transport);
 }
 
-static void handle_clock_sync_response(n_client_t *client, const u8 *payload, u32 len) {
-    if (len < 16) return;
-
-    n_bitreader_t reader;
-    n_bitreader_init(&reader, payload, len);
-    f64 client_send_time = n_read_f64(&reader);
-    f64 server_time = n_read_f64(&reader);
-
-    f64 now = n_platform_time();
-    f64 rtt = now - client_send_time;
-    if (rtt < 0.0) return;
-
-    f64 one_way = rtt * 0.5;
-    f64 server_time_now = server_time + one_way;
-    f64 offset = server_time_now - now;
-
-    n_clock_add_sample(&client->clock, rtt, offset);
-}
-
 void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 now) {
     if (len < N_PACKET_HEADER_SIZE) {
         client->stats.packets_dropped++;
@@ -481,6 +521,9 @@ void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 no
             case N_MSG_SNAPSHOT:
                 handle_snapshot_message(client, payload_buf, payload_bytes);
                 break;
+            case N_MSG_EVENTS:
+                handle_events_message(client, payload_buf, payload_bytes);
+                break;
             case N_MSG_CONNECT_CHALLENGE:
                 handle_connect_challenge(client, payload_buf, payload_bytes);
                 break;
@@ -490,9 +533,6 @@ void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 no
             case N_MSG_CONNECT_REJECTED:
                 handle_connect_rejected(client);
                 break;
-            case N_MSG_CLOCK_SYNC:
-                handle_clock_sync_response(client, payload_buf, payload_bytes);
-                break;
             case N_MSG_MAP_CONFIRMED: {
                 if (payload_bytes >= 4) {
                     n_bitreader_t map_reader;
@@ -500,10 +540,13 @@ void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 no
                     u32 server_tick = n_read_u32(&map_reader);
                     client->map_ready = true;
                     client->input_tick = server_tick;
+                    client->event_tick = server_tick;
                     // Reset interp buffer for clean start
                     client->interp_count = 0;
                     client->interp_write = 0;
                     client->has_baseline = false;
+                    client->extrap_base_tick = 0;
+                    memset(client->blend_offset, 0, sizeof(client->blend_offset));
                     N_DBG("map_confirmed: server_tick=%u", server_tick);
                 }
                 break;
@@ -522,6 +565,54 @@ void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 no
     QK_PROF_COUNTER("cl_bytes_recv", len);
 }
 
+// --- Direct loopback ---
+
+// Listen-server fast path: take the frames the server queued this tick and
+// copy their snapshots and events straight out of its rings. Nothing is
+// encoded, so there is no baseline to lose and no event ack to send.
+static void drain_direct_frames(n_client_t *client) {
+    n_server_t *srv = client->loopback_server;
+    n_client_slot_t *slot = &srv->clients[client->client_id];
+    if (!slot->direct) return;
+
+    if (slot->direct_head - slot->direct_read > N_DIRECT_QUEUE_SIZE) {
+        slot->direct_read = slot->direct_head - N_DIRECT_QUEUE_SIZE;
+    }
+
+    u32 through_tick = client->event_tick;
+    while (slot->direct_read != slot->direct_head) {
+        const n_direct_frame_t *frame = &slot->direct_frames[slot->direct_read % N_DIRECT_QUEUE_SIZE];
+        slot->direct_read++;
+
+        apply_snapshot_header(client, frame->tick, frame->cmd_ack, frame->input_depth,
+                              frame->echo_time_us, frame->hold_us);
+        client->has_server_player_state = frame->has_player_state;
+        if (frame->has_player_state) client->server_player_state = frame->player_state;
+
+        // Past the history ring the server has moved on; skip, as with a lost packet
+        const n_snapshot_t *snap = &srv->snapshot_buffer.snapshots[frame->tick % N_SNAPSHOT_HISTORY];
+        if (snap->tick != frame->tick) continue;
+
+        client->interp_snapshots[client->interp_write] = *snap;
+        commit_snapshot(client);
+        client->stats.snapshots_direct++;
+        if (frame->tick > through_tick) through_tick = frame->tick;
+    }
+
+    if (through_tick <= client->event_tick) return;
+
+    u32 oldest = srv->event_head > N_EVENT_RING_SIZE ? srv->event_head - N_EVENT_RING_SIZE : 0;
+    for (u32 seq = oldest; seq != srv->event_head; seq++) {
+        const n_game_event_t *evt = &srv->events[seq % N_EVENT_RING_SIZE];
+        if (evt->tick <= client->event_tick || evt->tick > through_tick) continue;
+        client->events[client->event_head % N_EVENT_RING_SIZE] = *evt;
+        client->event_head++;
+        client->stats.events_received++;
+    }
+    client->event_tick = through_tick;
+    slot->event_ack = through_tick;
+}
+
 // --- Client tick ---
 
 void n_client_tick(n_client_t *client, f64 now) {
@@ -554,17 +645,18 @@ void n_client_tick(n_client_t *client, f64 now) {
         }
 
         case N_CONN_CONNECTED: {
-            // Clock sync
-            if (n_clock_should_sync(&client->clock, now)) {
-                send_clock_sync(client);
-            }
-
             // Timeout check (not for loopback)
             if (!client->is_loopback &&
                 now - client->last_packet_recv_time > N_TIMEOUT_SEC) {
                 client->conn_state = N_CONN_DISCONNECTED;
                 n_transport_close(&client->transport);
+                break;
+            }
+            if (client->is_loopback && client->local_direct) {
+                drain_direct_frames(client);
             }
+            // Anything queued without an input to ride on
+            n_client_flush(client);
             break;
         }
 
@@ -583,17 +675,19 @@ void n_client_send_input(n_client_t *client, const n_input_t *input, f64 now) {
     client->input_history[idx] = *input;
     client->input_history_head++;
 
-    // Build input packet with redundancy
-    u8 pkt[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = client->outgoing_sequence++;
-    hdr.ack = client->incoming_sequence;
-    hdr.ack_bitfield = client->ack_bitfield;
-    n_packet_header_write(pkt, &hdr);
+    // Listen server: straight into the server's queue, no redundancy needed
+    if (client->is_loopback && client->local_direct) {
+        n_server_store_inputs(client->loopback_server, client->client_id, client->input_tick,
+                              input, 1, (u32)n_platform_time_us());
+        n_client_flush(client);
+        client->input_tick++;
+        return;
+    }
 
+    // Input message with redundancy
+    u8 payload[N_TRANSPORT_MTU];
     n_bitwriter_t writer;
-    n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
+    n_bitwriter_init(&writer, payload, sizeof(payload));
 
     // Determine how many redundant inputs to send
     u32 available = client->input_history_head;
@@ -601,37 +695,105 @@ void n_client_send_input(n_client_t *client, const n_input_t *input, f64 now) {
     u32 start_idx = client->input_history_head - count;
     u32 start_tick = client->input_tick > (count - 1) ? client->input_tick - (count - 1) : 0;
 
-    // Input message payload size: 2 bits (count) + 32 bits (start_tick) + count * 9 bytes
-    u16 payload_len = (u16)(1 + 4 + count * 9); // approximate byte size
-    n_msg_header_write(&writer, N_MSG_INPUT, payload_len);
+    // Input message payload: 2 bits (count) + 32 bits (start_tick) +
+    // 32 bits (send time, echoed for RTT) + inputs.
+    // The server reads exactly this many bytes, so the length must be exact.
+    u32 payload_bits = 2 + 32 + 32;
+    for (u32 i = 0; i < count; i++) {
+        u32 hist_idx = (start_idx + i) % N_INPUT_QUEUE_SIZE;
+        payload_bits += n_input_wire_bits(&client->input_history[hist_idx]);
+    }
+    u16 payload_len = (u16)((payload_bits + 7) / 8);
 
     n_write_bits(&writer, count - 1, 2); // 0=1 input, 1=2 inputs, 2=3 inputs
     n_write_u32(&writer, start_tick);
+    n_write_u32(&writer, (u32)n_platform_time_us());
 
     for (u32 i = 0; i < count; i++) {
         u32 hist_idx = (start_idx + i) % N_INPUT_QUEUE_SIZE;
-        const n_input_t *inp = &client->input_history[hist_idx];
-        n_write_u8(&writer, (u8)inp->forward_move);
-        n_write_u8(&writer, (u8)inp->side_move);
-        n_write_u16(&writer, inp->yaw);
-        n_write_u16(&writer, inp->pitch);
-        n_write_u16(&writer, inp->buttons);
-        n_write_u8(&writer, inp->weapon_select);
+        n_input_write(&writer, &client->input_history[hist_idx]);
     }
+    // Pad to the declared length so the next message header lines up
+    n_write_bits(&writer, 0, (u32)payload_len * 8 - payload_bits);
 
-    // Terminate
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
+    n_msg_queue_push(&client->outgoing, N_MSG_INPUT, N_MSG_PRIORITY_STATE,
+                     payload, payload_len);
 
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_transport_send(&client->transport, &client->server_address, pkt, total);
+    // Input is the last thing produced each command tick
+    n_client_flush(client);
 
     client->input_tick++;
-    client->stats.packets_sent++;
-    client->stats.bytes_sent += total;
 
     QK_UNUSED(now);
 }
 
+// --- Flush ---
+
+void n_client_flush(n_client_t *client) {
+    u8 pkt[N_TRANSPORT_MTU];
+
+    // One ack covers every events message since the last flush
+    if (client->event_ack_pending) {
+        u8 ack[4];
+        n_bitwriter_t writer;
+        n_bitwriter_init(&writer, ack, sizeof(ack));
+        n_write_u32(&writer, client->event_tick);
+        if (n_msg_queue_push(&client->outgoing, N_MSG_EVENT_ACK, N_MSG_PRIORITY_STATE,
+                             ack, sizeof(ack))) {
+            client->event_ack_pending = false;
+        }
+    }
+
+    while (!n_msg_queue_empty(&client->outgoing)) {
+        n_packet_header_t hdr = {
+            .sequence = client->outgoing_sequence,
+            .ack = client->incoming_sequence,
+            .ack_bitfield = client->ack_bitfield,
+        };
+        u32 messages = 0;
+        u32 total = n_msg_queue_pack(&client->outgoing, &hdr, pkt, sizeof(pkt), &messages);
+        if (total == 0) continue;   // only oversize messages were left
+
+        client->outgoing_sequence++;
+        n_transport_send(&client->transport, &client->server_address, pkt, total);
+        client->stats.packets_sent++;
+        client->stats.bytes_sent += total;
+        client->stats.messages_sent += messages;
+    }
+
+    client->stats.messages_dropped += client->outgoing.dropped;
+    client->outgoing.dropped = 0;
+}
+
+// --- Game events ---
+
+// Oldest unread first; a reader more than a ring behind loses the oldest
+u32 n_client_poll_events(n_client_t *client, n_game_event_t *out, u32 max) {
+    if (client->event_head - client->event_read > N_EVENT_RING_SIZE) {
+        client->event_read = client->event_head - N_EVENT_RING_SIZE;
+    }
+    u32 count = 0;
+    while (client->event_read != client->event_head && count < max) {
+        out[count++] = client->events[client->event_read % N_EVENT_RING_SIZE];
+        client->event_read++;
+    }
+    return count;
+}
+
+// --- Map handshake ---
+
+void n_client_send_map_loaded(n_client_t *client, u32 map_hash) {
+    if (client->conn_state != N_CONN_CONNECTED) return;
+
+    // Rides with the next input (or the end-of-tick flush)
+    u8 payload[4];
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, payload, sizeof(payload));
+    n_write_u32(&writer, map_hash);
+    n_msg_queue_push(&client->outgoing, N_MSG_MAP_LOADED, N_MSG_PRIORITY_CONTROL,
+                     payload, sizeof(payload));
+}
+
 // --- Interpolation ---
 
 // Find two snapshots that bracket the given render tick
@@ -716,6 +878,75 @@ static f32 dequant_vel(i16 quantized) {
     return (f32)quantized;
 }
 
+// --- Extrapolation ---
+
+// Dead-reckon entities present in the newest snapshot by dt seconds. The
+// interp pass has already placed them at that snapshot (t clamped to 1).
+static void extrapolate_entities(n_client_t *client, const n_snapshot_t *snap, f32 dt) {
+    for (u32 id = 0; id < N_MAX_ENTITIES; id++) {
+        qk_interp_entity_t *entity = &client->interp_state.entities[id];
+        if (!entity->active || !n_snapshot_has_entity(snap, (u8)id)) continue;
+
+        vec3_t start = { entity->pos_x, entity->pos_y, entity->pos_z };
+        vec3_t vel = { entity->vel_x, entity->vel_y, entity->vel_z };
+        vec3_t end = vec3_add(start, vec3_scale(vel, dt));
+
+        bool is_player = entity->entity_type == N_ENTITY_TYPE_PLAYER;
+        if (is_player && !(entity->flags & QK_ENT_FLAG_ON_GROUND)) {
+            end.z -= 0.5f * QK_PM_GRAVITY * dt * dt;
+            entity->vel_z -= QK_PM_GRAVITY * dt;
+        }
+        if (is_player && client->extrap_trace) {
+            end = client->extrap_trace(client->extrap_trace_user, start, end);
+        }
+
+        entity->pos_x = end.x;
+        entity->pos_y = end.y;
+        entity->pos_z = end.z;
+    }
+}
+
+// Going from extrapolation back to interpolation (or on to a newer base)
+// moves entities; keep them where they were shown and decay the difference.
+static void blend_capture(n_client_t *client) {
+    for (u32 id = 0; id < N_MAX_ENTITIES; id++) {
+        const qk_interp_entity_t *entity = &client->interp_state.entities[id];
+        client->blend_offset[id] = (vec3_t){ entity->pos_x, entity->pos_y, entity->pos_z };
+        client->blend_shown[id] = entity->active;
+    }
+}
+
+static void blend_resolve(n_client_t *client) {
+    f32 snap_sq = N_EXTRAP_SNAP_DIST * N_EXTRAP_SNAP_DIST;
+    for (u32 id = 0; id < N_MAX_ENTITIES; id++) {
+        const qk_interp_entity_t *entity = &client->interp_state.entities[id];
+        vec3_t shown = client->blend_offset[id];
+        vec3_t offset = {0};
+        if (entity->active && client->blend_shown[id]) {
+            offset = vec3_sub(shown, (vec3_t){ entity->pos_x, entity->pos_y, entity->pos_z });
+            if (vec3_dot(offset, offset) > snap_sq) offset = (vec3_t){0};
+        }
+        client->blend_offset[id] = offset;
+    }
+}
+
+static void blend_apply(n_client_t *client, f64 render_tick) {
+    f64 elapsed = render_tick - client->blend_render_tick;
+    client->blend_render_tick = render_tick;
+    if (elapsed < 0.0) elapsed = 0.0;
+    f32 decay = exp2f(-(f32)elapsed / N_EXTRAP_BLEND_TICKS);
+
+    for (u32 id = 0; id < N_MAX_ENTITIES; id++) {
+        qk_interp_entity_t *entity = &client->interp_state.entities[id];
+        vec3_t *offset = &client->blend_offset[id];
+        *offset = vec3_scale(*offset, decay);
+        if (!entity->active) continue;
+        entity->pos_x += offset->x;
+        entity->pos_y += offset->y;
+        entity->pos_z += offset->z;
+    }
+}
+
 void n_client_interpolate(n_client_t *client, f64 render_time) {
     if (client->conn_state != N_CONN_CONNECTED) return;
 
@@ -762,6 +993,16 @@ void n_client_interpolate(n_client_t *client, f64 render_time) {
         return;
     }
 
+    // Render time past the newest snapshot: snapshots are late or lost
+    f64 extrap_ticks = render_tick - (f64)snap_b->tick;
+    f64 extrap_max = client->extrap_limit * (f64)N_TICK_RATE;
+    if (extrap_ticks > extrap_max) extrap_ticks = extrap_max;
+    u32 extrap_base = extrap_ticks > 0.0 ? snap_b->tick : 0;
+
+    bool switching = client->extrap_base_tick != 0 && extrap_base != client->extrap_base_tick;
+    if (switching) blend_capture(client);
+    client->extrap_base_tick = extrap_base;
+
     // Compute interpolation factor
     f32 t = 0.0f;
     if (snap_b->tick != snap_a->tick) {
@@ -779,6 +1020,16 @@ void n_client_interpolate(n_client_t *client, f64 render_time) {
     client->interp_diag.t = t;
     client->interp_diag.render_tick = render_tick;
     client->interp_diag.interp_count = client->interp_count;
+    client->interp_diag.extrap_sec = extrap_base ? (f32)(extrap_ticks / (f64)N_TICK_RATE) : 0.0f;
+
+    // Positions of entities present in both snapshots go through the
+    // Hermite kernel after this pass, as flattened x/y/z lanes
+    f32 span = (f32)(snap_b->tick - snap_a->tick) / (f32)N_TICK_RATE;
+    f32 hermite_p0[N_MAX_ENTITIES * 3], hermite_v0[N_MAX_ENTITIES * 3];
+    f32 hermite_p1[N_MAX_ENTITIES * 3], hermite_v1[N_MAX_ENTITIES * 3];
+    f32 hermite_out[N_MAX_ENTITIES * 3];
+    u8  hermite_ids[N_MAX_ENTITIES];
+    u32 hermite_count = 0;
 
     for (u32 id = 0; id < N_MAX_ENTITIES; id++) {
         qk_interp_entity_t *interp_entity = &client->interp_state.entities[id];
@@ -805,10 +1056,22 @@ void n_client_interpolate(n_client_t *client, f64 render_time) {
                 interp_entity->yaw = (f32)entity_b->yaw * (360.0f / 65536.0f);
                 interp_entity->pitch = (f32)entity_b->pitch * (360.0f / 65536.0f);
             } else {
-                // Normal interpolation
-                interp_entity->pos_x = lerpf(dequant_pos(entity_a->pos_x), dequant_pos(entity_b->pos_x), t);
-                interp_entity->pos_y = lerpf(dequant_pos(entity_a->pos_y), dequant_pos(entity_b->pos_y), t);
-                interp_entity->pos_z = lerpf(dequant_pos(entity_a->pos_z), dequant_pos(entity_b->pos_z), t);
+                // Normal interpolation (position filled in by the kernel below)
+                u32 lane = hermite_count * 3;
+                hermite_p0[lane + 0] = dequant_pos(entity_a->pos_x);
+                hermite_p0[lane + 1] = dequant_pos(entity_a->pos_y);
+                hermite_p0[lane + 2] = dequant_pos(entity_a->pos_z);
+                hermite_v0[lane + 0] = dequant_vel(entity_a->vel_x);
+                hermite_v0[lane + 1] = dequant_vel(entity_a->vel_y);
+                hermite_v0[lane + 2] = dequant_vel(entity_a->vel_z);
+                hermite_p1[lane + 0] = dequant_pos(entity_b->pos_x);
+                hermite_p1[lane + 1] = dequant_pos(entity_b->pos_y);
+                hermite_p1[lane + 2] = dequant_pos(entity_b->pos_z);
+                hermite_v1[lane + 0] = dequant_vel(entity_b->vel_x);
+                hermite_v1[lane + 1] = dequant_vel(entity_b->vel_y);
+                hermite_v1[lane + 2] = dequant_vel(entity_b->vel_z);
+                hermite_ids[hermite_count++] = (u8)id;
+
                 interp_entity->vel_x = lerpf(dequant_vel(entity_a->vel_x), dequant_vel(entity_b->vel_x), t);
                 interp_entity->vel_y = lerpf(dequant_vel(entity_a->vel_y), dequant_vel(entity_b->vel_y), t);
                 interp_entity->vel_z = lerpf(dequant_vel(entity_a->vel_z), dequant_vel(entity_b->vel_z), t);
@@ -877,4 +1140,21 @@ void n_client_interpolate(n_client_t *client, f64 render_time) {
             interp_entity->active = false;
         }
     }
+
+    if (hermite_count > 0) {
+        n_hermite_batch(hermite_p0, hermite_v0, hermite_p1, hermite_v1,
+                        hermite_out, hermite_count * 3, t, span);
+        for (u32 i = 0; i < hermite_count; i++) {
+            qk_interp_entity_t *interp_entity = &client->interp_state.entities[hermite_ids[i]];
+            interp_entity->pos_x = hermite_out[i * 3 + 0];
+            interp_entity->pos_y = hermite_out[i * 3 + 1];
+            interp_entity->pos_z = hermite_out[i * 3 + 2];
+        }
+    }
+
+    if (extrap_base) {
+        extrapolate_entities(client, snap_b, (f32)(extrap_ticks / (f64)N_TICK_RATE));
+    }
+    if (switching) blend_resolve(client);
+    blend_apply(client, render_tick);
 }
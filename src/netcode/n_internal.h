@@ -25,8 +25,15 @@
 #define N_SNAPSHOT_HISTORY      64
 #define N_INPUT_QUEUE_SIZE      64
 #define N_INTERP_BUFFER_SIZE    32
-#define N_CLOCK_SYNC_SAMPLES    16
+#define N_CLOCK_WINDOW          64
 #define N_RELIABLE_MAX_PAYLOAD  4096
+#define N_RELAY_ENCODE_CACHE    8
+#define N_MSG_QUEUE_MAX         16
+#define N_MSG_QUEUE_BYTES       (2 * N_TRANSPORT_MTU)
+#define N_EVENT_RING_SIZE       256
+#define N_DIRECT_QUEUE_SIZE     8
+#define N_INFO_LIMIT_SLOTS      256
+#define N_QUERY_PENDING         16
 
 // Timing
 static const u32 N_TICK_RATE              = 128;
@@ -35,16 +42,24 @@ static const f64 N_INTERP_DELAY_DEFAULT   = 0.020;
 static const f64 N_INTERP_DELAY_MIN       = 0.0078;
 static const f64 N_INTERP_DELAY_MAX       = 0.100;
 
+// Extrapolation during snapshot underruns
+static const f64 N_EXTRAP_LIMIT_DEFAULT   = 0.25;   // seconds of dead reckoning, then hold
+static const f32 N_EXTRAP_BLEND_TICKS     = 4.0f;   // half-life of the error when snapshots resume
+static const f32 N_EXTRAP_SNAP_DIST       = 64.0f;  // larger errors are shown at once
+static const u8  N_ENTITY_TYPE_PLAYER     = 1;      // ENTITY_PLAYER on the wire
+static const f32 N_HERMITE_MAX_CHORD_ERR  = 8.0f;   // tangents this far off the chord: use linear
+
 // Connection
 static const f64 N_CONNECT_RETRY_SEC      = 0.5;
 static const f64 N_CONNECT_TIMEOUT_SEC    = 10.0;
 static const f64 N_TIMEOUT_SEC            = 30.0;
 static const f64 N_DISCONNECT_LINGER_SEC  = 1.0;
+static const u8  N_CONNECT_FLAG_RELAY     = 1 << 0; // optional 5th connect-request byte
 
-// Clock sync
-static const f64 N_CLOCK_SYNC_INTERVAL    = 1.0;
-static const f64 N_CLOCK_SYNC_FAST        = 0.1;
+// Clock sync (one sample per snapshot; N_CLOCK_WINDOW is ~0.5 s at 128 Hz)
 static const u32 N_CLOCK_CONVERGE_COUNT   = 4;
+static const i64 N_CLOCK_SLEW_DIVISOR     = 16;     // offset moves 1/16 of the error per sample
+static const u16 N_CLOCK_HOLD_UNKNOWN     = 0xFFFF; // snapshot carries no input echo
 
 // Reliable channel
 static const f64 N_RELIABLE_RETRANSMIT_SEC = 0.2;
@@ -52,6 +67,32 @@ static const f64 N_RELIABLE_RETRANSMIT_SEC = 0.2;
 // Input redundancy
 static const u32 N_INPUT_REDUNDANCY       = 3;
 
+// Newest input tick minus this is taken as the client's snapshot ack
+static const u32 N_INPUT_ACK_LAG          = 4;
+
+// Game events: resent with every snapshot until acked or this old
+static const u32 N_EVENT_RESEND_TICKS     = 128;    // ~1 s; age fits the u8 wire field
+static const u32 N_EVENT_MSG_MAX_BYTES    = 512;    // older events first, the rest next tick
+
+// Relay (one upstream connection, many downstream viewers)
+static const u32 N_RELAY_MAX_VIEWERS_DEFAULT = 256;
+static const f64 N_RELAY_DELAY_MAX        = 120.0;  // seconds; ~5.5 KB per queued tick
+static const u32 N_RELAY_QUEUE_SLACK      = 64;     // queue slots beyond delay * tick rate
+
+// Server browser queries: answered from a cached packet, rate limited per
+// source IP with a token bucket
+static const f32 N_INFO_QUERY_RATE        = 4.0f;   // tokens per second
+static const f32 N_INFO_QUERY_BURST       = 8.0f;
+
+// Input buffer steering: the server reports how many ticks ahead of
+// consumption each client's newest input was, and the client scales its
+// command rate to hold that near the target.
+static const i8  N_INPUT_DEPTH_UNKNOWN    = -128;   // wire value: no sample yet
+static const f32 N_INPUT_DEPTH_TARGET     = 1.0f;   // ticks of slack
+static const f32 N_INPUT_DEPTH_SMOOTHING  = 0.05f;  // EMA weight per snapshot
+static const f32 N_TIME_SCALE_GAIN        = 0.02f;  // rate change per tick of error
+static const f32 N_TIME_SCALE_LIMIT       = 0.05f;  // at most +-5%
+
 // Entity field count for delta bitmask
 static const u32 N_ENTITY_FIELD_COUNT     = 12;
 
@@ -62,7 +103,7 @@ enum {
     N_MSG_INPUT             = 1,
     N_MSG_SNAPSHOT          = 2,
     N_MSG_COMMAND           = 3,
-    N_MSG_CLOCK_SYNC        = 4,
+    N_MSG_EVENTS            = 4,    // server -> client: unacked game events
     N_MSG_DISCONNECT        = 5,
     N_MSG_CONNECT_REQUEST   = 6,
     N_MSG_CONNECT_CHALLENGE = 7,
@@ -71,6 +112,9 @@ enum {
     N_MSG_CONNECT_REJECTED  = 10,
     N_MSG_MAP_LOADED        = 11,   // client -> server: map load complete
     N_MSG_MAP_CONFIRMED     = 12,   // server -> client: map validated, snapshots will begin
+    N_MSG_EVENT_ACK         = 13,   // client -> server: events received through a tick
+    N_MSG_INFO_REQUEST      = 14,   // connectionless: server browser query
+    N_MSG_INFO_RESPONSE     = 15,   // server -> querier: players, map, tick rate
     N_MSG_COUNT
 };
 
@@ -131,6 +175,7 @@ i32  n_transport_recv(n_transport_t *t, n_address_t *from,
 bool n_platform_init(void);
 void n_platform_shutdown(void);
 f64  n_platform_time(void);
+u64  n_platform_time_us(void);     // same clock, integer microseconds
 
 // --- Bitpacker ---
 
@@ -195,6 +240,53 @@ void n_packet_header_read(const u8 *buf, n_packet_header_t *hdr);
 void n_msg_header_write(n_bitwriter_t *writer, u8 type, u16 length);
 bool n_msg_header_read(n_bitreader_t *reader, n_msg_header_t *hdr);
 
+// --- Outgoing message queue ---
+// Messages for one connection collect here during a tick and go out in as
+// few packets as fit the MTU, highest priority first in each packet. The
+// order matters to the receiver: MAP_CONFIRMED resets the interp buffer,
+// so it must precede the snapshot it travels with.
+
+typedef enum {
+    N_MSG_PRIORITY_CONTROL = 0,     // handshake and map state
+    N_MSG_PRIORITY_STATE,           // input, snapshots
+    N_MSG_PRIORITY_COUNT
+} n_msg_priority_t;
+
+typedef struct {
+    u16     offset;
+    u16     len;
+    u8      type;
+    u8      priority;
+} n_queued_msg_t;
+
+typedef struct {
+    n_queued_msg_t  msgs[N_MSG_QUEUE_MAX];
+    u32             count;
+    u32             bytes_used;
+    u32             dropped;        // refused (queue full) or larger than a packet
+    u8              data[N_MSG_QUEUE_BYTES];
+} n_msg_queue_t;
+
+static inline bool n_msg_queue_empty(const n_msg_queue_t *queue) {
+    return queue->count == 0;
+}
+
+void n_msg_queue_reset(n_msg_queue_t *queue);
+bool n_msg_queue_push(n_msg_queue_t *queue, u8 type, n_msg_priority_t priority,
+                      const u8 *payload, u16 len);
+// Writes hdr and as many queued messages as fit into pkt, removing them.
+// Returns the packet size, or 0 if the queue held nothing sendable.
+u32  n_msg_queue_pack(n_msg_queue_t *queue, const n_packet_header_t *hdr,
+                      u8 *pkt, u32 max_bytes, u32 *out_messages);
+
+u32  n_input_wire_bits(const n_input_t *input);
+u32  n_game_event_wire_bytes(const n_game_event_t *event);  // type and age included
+void n_game_event_write(n_bitwriter_t *writer, const n_game_event_t *event, u8 age);
+bool n_game_event_read(n_bitreader_t *reader, n_game_event_t *out_event, u8 *out_age);
+
+void n_input_write(n_bitwriter_t *writer, const n_input_t *input);
+void n_input_read(n_bitreader_t *reader, n_input_t *out_input);
+
 // --- Reliable channel ---
 
 typedef struct {
@@ -240,23 +332,36 @@ bool n_snapshot_delta_decode(const n_snapshot_t *baseline, n_snapshot_t *out,
                              const u8 *data, u32 data_len,
                              u32 current_tick);
 
+// --- Interpolation kernel ---
+
+// out[i] = Hermite(p0[i], v0[i], p1[i], v1[i]) at t over span seconds, per
+// float lane (flattened x/y/z components); falls back to linear per lane
+void n_hermite_batch(const f32 *p0, const f32 *v0, const f32 *p1, const f32 *v1,
+                     f32 *out, u32 count, f32 t, f32 span);
+
 // --- Clock sync ---
 
 typedef struct {
-    f64     offset_samples[N_CLOCK_SYNC_SAMPLES];
-    f64     rtt_samples[N_CLOCK_SYNC_SAMPLES];
+    i64     lead_us;        // server send time - local arrival time
+    u32     rtt_us;         // N_CLOCK_RTT_UNKNOWN if no echo
+} n_clock_sample_t;
+
+#define N_CLOCK_RTT_UNKNOWN 0xFFFFFFFFu
+
+typedef struct {
+    n_clock_sample_t samples[N_CLOCK_WINDOW];
     u32     sample_count;
     u32     sample_index;
-    f64     smoothed_offset;
-    f64     smoothed_rtt;
-    f64     last_sync_time;
+    i64     offset_us;          // server clock - local clock
+    u32     min_rtt_us;         // window minimum, used for the offset
+    f64     smoothed_offset;    // offset_us in seconds
+    f64     smoothed_rtt;       // EMA of RTT samples in seconds (for display)
     bool    converged;
 } n_clock_state_t;
 
 void n_clock_init(n_clock_state_t *clock_state);
-void n_clock_add_sample(n_clock_state_t *clock_state, f64 rtt, f64 offset);
-bool n_clock_should_sync(const n_clock_state_t *clock_state, f64 now);
-void n_clock_mark_sent(n_clock_state_t *clock_state, f64 now);
+void n_clock_add_sample(n_clock_state_t *clock_state, u64 server_time_us,
+                        u64 local_time_us, u32 rtt_us);
 
 // --- Stats ---
 
@@ -271,8 +376,31 @@ typedef struct {
     u64     inputs_received;
     u64     inputs_duplicated;
     u64     inputs_late;
+    u64     messages_sent;      // messages packed; / packets_sent = coalescing
+    u64     messages_dropped;
+    u64     events_sent;        // including resends
+    u64     events_received;    // new events only
+    u64     snapshots_thinned;  // skipped for low-priority clients
+    u64     snapshots_direct;   // handed to an in-process client unencoded
+    u64     info_answered;      // server browser queries
+    u64     info_limited;       // queries dropped by the per-source limit
 } n_stats_t;
 
+// --- Direct local path ---
+
+// What a snapshot message carries besides the entities. The snapshot
+// itself stays in the server's history ring; an in-process client copies
+// it out on its next tick, the same point a loopback packet would land.
+typedef struct {
+    u32                 tick;
+    u32                 cmd_ack;
+    u32                 echo_time_us;
+    u16                 hold_us;
+    i8                  input_depth;
+    bool                has_player_state;
+    n_player_state_t    player_state;
+} n_direct_frame_t;
+
 // --- Server client slot ---
 
 typedef struct {
@@ -281,6 +409,7 @@ typedef struct {
     n_transport_t   transport;
     u8              client_id;
     bool            is_loopback;
+    bool            is_relay;       // spectator relay: no player, sees every entity
 
     // Protocol state
     u16             outgoing_sequence;
@@ -295,6 +424,11 @@ typedef struct {
 
     // Snapshot delta state
     u32             last_acked_snapshot_tick;
+    // Bit n: the snapshot for sent_mask_tick - n went out. Thinned clients
+    // skip ticks, so a baseline must be one of these (N_SNAPSHOT_HISTORY <= 64)
+    u64             sent_mask;
+    u32             sent_mask_tick;
+    bool            low_priority;   // thinned while low_priority_interval > 1
 
     // Input queue
     n_input_t       input_queue[N_INPUT_QUEUE_SIZE];
@@ -302,21 +436,46 @@ typedef struct {
     u32             input_queue_tail;
     u32             last_input_tick;
     n_input_t       last_input;
+    i8              input_depth_min;        // lowest depth since last snapshot
+    bool            input_depth_valid;
 
     // Reliable channel
     n_reliable_channel_t reliable;
 
-    // Clock sync (server-side)
-    f64             clock_offset;
-    i32             rtt_ms;
+    // Game events through this tick are acked; newer ones ride every snapshot
+    u32             event_ack;
+
+    // Map confirm, connect accept and snapshot, flushed after the broadcast
+    n_msg_queue_t   outgoing;
+
+    // Clock sync: newest input timestamp, echoed back in snapshots
+    u32             echo_time_us;           // client clock, low 32 bits
+    u64             echo_recv_us;           // server clock when it arrived
+    bool            has_echo;
 
     // Disconnect linger
     f64             disconnect_start_time;
 
     // Map handshake: true once client has confirmed map load
     bool            map_ready;
+
+    // In-process client without serialization: snapshots, events and
+    // inputs skip the wire format (control messages still use loopback)
+    bool            direct;
+    n_direct_frame_t direct_frames[N_DIRECT_QUEUE_SIZE];
+    u32             direct_head;    // server writes
+    u32             direct_read;    // client reads
 } n_client_slot_t;
 
+// --- Server info cache ---
+
+// Per-source query budget; sources share a bucket on hash collision
+typedef struct {
+    u32     ip;
+    f32     tokens;
+    f64     last_time;
+} n_info_limit_t;
+
 // --- Server ---
 
 typedef struct {
@@ -332,14 +491,31 @@ typedef struct {
     n_stats_t           stats;
     bool                initialized;
     u16                 server_port;
+
+    // Recent game events in tick order, resent until each client acks them
+    n_game_event_t      events[N_EVENT_RING_SIZE];
+    u32                 event_head;
     u32                 max_clients;
 
+    // Low-priority clients get a snapshot only every this many ticks (0/1 = all)
+    u32                 low_priority_interval;
+
     // Loopback queues (one pair per possible loopback client)
     n_loopback_queue_t  loopback_queues[N_MAX_CLIENTS][2];
 
     // Map handshake
     u32                 map_name_hash;
     char                map_name[128];  // current map name (sent in connect-accepted)
+
+    // Server browser reply, rebuilt when what it says changes. Only the
+    // querier's token is patched in per reply.
+    u8                  info_packet[N_TRANSPORT_MTU];
+    u32                 info_packet_len;    // 0 = stale
+    u32                 info_token_offset;
+    u8                  info_players;
+    u8                  info_spectators;
+    u32                 info_map_hash;
+    n_info_limit_t      info_limits[N_INFO_LIMIT_SLOTS];
 } n_server_t;
 
 // Server API
@@ -353,6 +529,13 @@ i32  n_server_allocate_slot(n_server_t *srv);
 void n_server_disconnect_client(n_server_t *srv, u32 slot);
 void n_server_send_to_client(n_server_t *srv, u32 slot, const u8 *data, u32 len);
 void n_server_broadcast_snapshots(n_server_t *srv);
+void n_server_flush_client(n_server_t *srv, u32 slot);
+// Takes one token from ip's bucket in limits (N_INFO_LIMIT_SLOTS entries)
+bool n_server_info_query_allowed(n_info_limit_t *limits, u32 ip, f64 now);
+void n_server_push_event(n_server_t *srv, const n_game_event_t *event);
+// Inputs [start_tick, start_tick + count) from a client, wire or direct
+void n_server_store_inputs(n_server_t *srv, u32 slot, u32 start_tick,
+                           const n_input_t *inputs, u32 count, u32 client_time_us);
 
 // --- Client ---
 
@@ -370,9 +553,18 @@ typedef struct {
     // Reliable channel
     n_reliable_channel_t reliable;
 
+    // Game events: everything through event_tick has been received
+    n_game_event_t      events[N_EVENT_RING_SIZE];
+    u32                 event_head;
+    u32                 event_read;
+    u32                 event_tick;
+    bool                event_ack_pending;
+
+    // Map-loaded and input, flushed with each input or at the end of a tick
+    n_msg_queue_t       outgoing;
+
     // Clock sync
     n_clock_state_t     clock;
-    f64                 clock_sync_send_time;
 
     // Interpolation
     n_snapshot_t        interp_snapshots[N_INTERP_BUFFER_SIZE];
@@ -384,6 +576,15 @@ typedef struct {
     qk_interp_diag_t   interp_diag;
     f64                 interp_delay;
 
+    // Extrapolation (see n_client_interpolate)
+    f64                 extrap_limit;       // seconds; <= 0 disables
+    u32                 extrap_base_tick;   // snapshot extrapolated from last call, 0 = none
+    f64                 blend_render_tick;  // render tick of the last call
+    vec3_t              blend_offset[N_MAX_ENTITIES];  // shown - computed, decaying
+    bool                blend_shown[N_MAX_ENTITIES];   // active when the offset was captured
+    qk_net_extrap_trace_fn extrap_trace;
+    void               *extrap_trace_user;
+
     // Input
     n_input_t           input_history[N_INPUT_QUEUE_SIZE];
     u32                 input_history_head;
@@ -392,12 +593,18 @@ typedef struct {
     // Prediction reconciliation
     u32                 last_server_cmd_ack;
 
+    // Time dilation from server-reported input buffer depth
+    f32                 input_depth;        // smoothed, in ticks
+    bool                has_input_depth;
+    f32                 time_scale;         // command clock rate, ~1.0
+
     // Timing
     f64                 last_packet_recv_time;
     f64                 connect_start_time;
     f64                 last_connect_retry_time;
     u32                 client_challenge;
     u32                 server_challenge;
+    u8                  connect_flags;      // N_CONNECT_FLAG_*, sent with the request
 
     // Packet buffer
     u8                  packet_buffer[N_TRANSPORT_MTU];
@@ -405,6 +612,7 @@ typedef struct {
     n_stats_t           stats;
     bool                initialized;
     bool                is_loopback;
+    bool                local_direct;       // connect_local takes the direct path
 
     // Full-precision player state from server (for reconciliation)
     bool                has_server_player_state;
@@ -419,7 +627,7 @@ typedef struct {
 } n_client_t;
 
 // Client API
-void n_client_init(n_client_t *client, f64 interp_delay);
+void n_client_init(n_client_t *client, f64 interp_delay, f64 extrap_limit);
 void n_client_tick(n_client_t *client, f64 now);
 void n_client_shutdown(n_client_t *client);
 void n_client_connect_remote(n_client_t *client, const char *address, u16 port);
@@ -427,8 +635,108 @@ void n_client_connect_local(n_client_t *client, n_server_t *srv);
 void n_client_disconnect(n_client_t *client);
 void n_client_interpolate(n_client_t *client, f64 render_time);
 void n_client_send_input(n_client_t *client, const n_input_t *input, f64 now);
+void n_client_send_map_loaded(n_client_t *client, u32 map_hash);
+void n_client_flush(n_client_t *client);
+u32  n_client_poll_events(n_client_t *client, n_game_event_t *out, u32 max);
 void n_client_process_packet(n_client_t *client, const u8 *data, u32 len, f64 now);
 
+// --- Relay ---
+
+// Downstream viewer: a normal client connected to the relay. Holds only
+// what the handshake, acks and clock echo need.
+typedef struct {
+    n_conn_state_t  state;
+    n_address_t     address;
+
+    u16             outgoing_sequence;
+    u16             incoming_sequence;
+    u32             ack_bitfield;
+
+    f64             last_packet_recv_time;
+    f64             connect_start_time;
+    u32             client_challenge;
+    u32             server_challenge;
+
+    u32             last_acked_snapshot_tick;
+    u32             first_snapshot_tick;    // acks older than this predate the stream
+    u32             last_input_tick;
+
+    u32             echo_time_us;
+    u64             echo_recv_us;
+    bool            has_echo;
+
+    bool            map_ready;
+} n_viewer_t;
+
+// One delta encode, shared by every viewer on the same baseline
+typedef struct {
+    u32     base_tick;          // 0 = full snapshot
+    u32     len;
+    u8      data[N_TRANSPORT_MTU];
+} n_relay_encode_t;
+
+typedef struct {
+    n_client_t          upstream;           // connected with N_CONNECT_FLAG_RELAY
+    u32                 upstream_map_hash;
+    f64                 last_map_loaded_time;
+    f64                 last_keepalive_time;
+    u32                 captured_tick;      // newest upstream snapshot queued
+
+    // Delay queue: upstream snapshots in arrival order, released after delay
+    n_snapshot_t       *queue;
+    f64                *queue_arrival;
+    u32                 queue_capacity;
+    u32                 queue_head;
+    u32                 queue_count;
+    f64                 delay;
+
+    // Released snapshots, the baselines viewers ack against
+    n_snapshot_buffer_t history;
+    u32                 tick;               // newest released tick, 0 = none yet
+
+    // Downstream
+    n_transport_t       transport;
+    u16                 listen_port;
+    n_viewer_t         *viewers;
+    u64                *viewer_keys;        // ip << 16 | port, 0 = free; scanned per packet
+    u32                 max_viewers;
+    u32                 viewer_count;
+
+    n_relay_encode_t    encodes[N_RELAY_ENCODE_CACHE];
+    u32                 encode_count;       // valid for the current broadcast only
+
+    u8                  packet_buffer[N_TRANSPORT_MTU];
+    n_stats_t           stats;              // downstream traffic
+    u64                 encodes_done;
+    u64                 encodes_shared;
+    bool                initialized;
+} n_relay_t;
+
+// Relay API
+bool n_relay_init(n_relay_t *relay, u16 listen_port, u32 max_viewers, f64 delay);
+void n_relay_connect(n_relay_t *relay, const char *address, u16 port);
+void n_relay_tick(n_relay_t *relay, f64 now);
+void n_relay_shutdown(n_relay_t *relay);
+
+// --- Server query ---
+
+// Connectionless status queries to one server. Replies are matched to
+// requests by token, so several may be in flight for ping samples.
+typedef struct {
+    n_transport_t       transport;
+    n_address_t         server_address;
+    u32                 token_base;
+    u32                 sent_count;
+    u64                 sent_us[N_QUERY_PENDING];
+    bool                open;
+} n_query_t;
+
+bool n_query_open(n_query_t *query, const char *address, u16 port);
+bool n_query_send(n_query_t *query);
+// Next reply, if one has arrived; false when none is waiting
+bool n_query_poll(n_query_t *query, qk_net_server_info_t *out_info);
+void n_query_close(n_query_t *query);
+
 // --- Simple PRNG for challenge generation ---
 u32 n_random_u32(void);
 
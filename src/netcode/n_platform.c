@@ -42,7 +42,7 @@ static bool   s_timer_initialized = false;
 static LARGE_INTEGER s_timer_freq;
 static LARGE_INTEGER s_timer_start;
 
-f64 n_platform_time(void) {
+static u64 platform_elapsed_ticks(void) {
     if (!s_timer_initialized) {
         QueryPerformanceFrequency(&s_timer_freq);
         QueryPerformanceCounter(&s_timer_start);
@@ -50,7 +50,20 @@ f64 n_platform_time(void) {
     }
     LARGE_INTEGER now;
     QueryPerformanceCounter(&now);
-    return (f64)(now.QuadPart - s_timer_start.QuadPart) / (f64)s_timer_freq.QuadPart;
+    return (u64)(now.QuadPart - s_timer_start.QuadPart);
+}
+
+f64 n_platform_time(void) {
+    // Ticks first: the call initializes s_timer_freq on first use
+    u64 ticks = platform_elapsed_ticks();
+    return (f64)ticks / (f64)s_timer_freq.QuadPart;
+}
+
+u64 n_platform_time_us(void) {
+    u64 ticks = platform_elapsed_ticks();
+    u64 freq = (u64)s_timer_freq.QuadPart;
+    // Split to avoid overflowing ticks * 1e6
+    return ticks / freq * 1000000 + ticks % freq * 1000000 / freq;
 }
 
 #else // Linux
@@ -67,16 +80,26 @@ void n_platform_shutdown(void) {
 static bool            s_linux_timer_initialized = false;
 static struct timespec s_linux_timer_start;
 
-f64 n_platform_time(void) {
+static struct timespec platform_elapsed(void) {
     if (!s_linux_timer_initialized) {
         clock_gettime(CLOCK_MONOTONIC, &s_linux_timer_start);
         s_linux_timer_initialized = true;
     }
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
-    f64 sec  = (f64)(ts.tv_sec  - s_linux_timer_start.tv_sec);
-    f64 nsec = (f64)(ts.tv_nsec - s_linux_timer_start.tv_nsec);
-    return sec + nsec * 1e-9;
+    ts.tv_sec  -= s_linux_timer_start.tv_sec;
+    ts.tv_nsec -= s_linux_timer_start.tv_nsec;
+    return ts;
+}
+
+f64 n_platform_time(void) {
+    struct timespec ts = platform_elapsed();
+    return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+}
+
+u64 n_platform_time_us(void) {
+    struct timespec ts = platform_elapsed();
+    return (u64)((i64)ts.tv_sec * 1000000 + (i64)ts.tv_nsec / 1000);
 }
 
 #endif
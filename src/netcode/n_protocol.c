@@ -3,6 +3,8 @@
  *
  * Packet header encode/decode (8 bytes: sequence, ack, ack_bitfield).
  * Message framing: 4-bit type + 12-bit length prefix.
+ * Per-connection outgoing queue that coalesces messages into packets.
+ * Input and game-event encoding shared by both ends.
  */
 
 #include "n_internal.h"
@@ -47,3 +49,233 @@ bool n_msg_header_read(n_bitreader_t *reader, n_msg_header_t *hdr) {
     hdr->length = (u16)((combined >> 4) & 0xFFF);
     return true;
 }
+
+// --- Outgoing message queue ---
+
+static const u32 N_MSG_HEADER_BYTES = 2;
+
+void n_msg_queue_reset(n_msg_queue_t *queue) {
+    queue->count = 0;
+    queue->bytes_used = 0;
+}
+
+bool n_msg_queue_push(n_msg_queue_t *queue, u8 type, n_msg_priority_t priority,
+                      const u8 *payload, u16 len) {
+    if (queue->count >= N_MSG_QUEUE_MAX || queue->bytes_used + len > N_MSG_QUEUE_BYTES) {
+        queue->dropped++;
+        return false;
+    }
+
+    n_queued_msg_t *msg = &queue->msgs[queue->count++];
+    msg->offset = (u16)queue->bytes_used;
+    msg->len = len;
+    msg->type = type;
+    msg->priority = (u8)priority;
+    if (len > 0) memcpy(queue->data + queue->bytes_used, payload, len);
+    queue->bytes_used += len;
+    return true;
+}
+
+u32 n_msg_queue_pack(n_msg_queue_t *queue, const n_packet_header_t *hdr,
+                     u8 *pkt, u32 max_bytes, u32 *out_messages) {
+    n_packet_header_write(pkt, hdr);
+
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE, max_bytes - N_PACKET_HEADER_SIZE);
+
+    // Room for messages once the NOP terminator is reserved
+    u32 capacity = max_bytes - N_PACKET_HEADER_SIZE - N_MSG_HEADER_BYTES;
+    u32 room = capacity;
+    bool packed[N_MSG_QUEUE_MAX] = {0};
+    u32 packed_count = 0;
+
+    for (u32 prio = 0; prio < N_MSG_PRIORITY_COUNT; prio++) {
+        for (u32 i = 0; i < queue->count; i++) {
+            const n_queued_msg_t *msg = &queue->msgs[i];
+            if (msg->priority != prio) continue;
+
+            u32 need = N_MSG_HEADER_BYTES + msg->len;
+            if (need > capacity) {
+                packed[i] = true;   // can never fit: drop rather than stall the queue
+                queue->dropped++;
+                continue;
+            }
+            if (need > room) continue;
+
+            n_msg_header_write(&writer, msg->type, msg->len);
+            const u8 *payload = queue->data + msg->offset;
+            for (u32 b = 0; b < msg->len; b++) {
+                n_write_u8(&writer, payload[b]);
+            }
+            room -= need;
+            packed[i] = true;
+            packed_count++;
+        }
+    }
+
+    // Compact what is left, keeping push order within each priority
+    u32 kept = 0;
+    u32 bytes = 0;
+    for (u32 i = 0; i < queue->count; i++) {
+        if (packed[i]) continue;
+        n_queued_msg_t msg = queue->msgs[i];
+        if (msg.offset != bytes) memmove(queue->data + bytes, queue->data + msg.offset, msg.len);
+        msg.offset = (u16)bytes;
+        bytes += msg.len;
+        queue->msgs[kept++] = msg;
+    }
+    queue->count = kept;
+    queue->bytes_used = bytes;
+
+    if (out_messages) *out_messages = packed_count;
+    if (packed_count == 0) return 0;
+
+    n_msg_header_write(&writer, N_MSG_NOP, 0);
+    return N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
+}
+
+// --- Input encoding ---
+// 72 fixed bits, then a presence bit per press edge. An attack edge adds its
+// sub-tick and view angles (40 bits), a jump edge its sub-tick (8 bits).
+
+u32 n_input_wire_bits(const n_input_t *input) {
+    u32 bits = 72 + 2;
+    if (input->attack_subtick != QK_SUBTICK_NONE) bits += 40;
+    if (input->jump_subtick != QK_SUBTICK_NONE)   bits += 8;
+    return bits;
+}
+
+void n_input_write(n_bitwriter_t *writer, const n_input_t *input) {
+    n_write_u8(writer, (u8)input->forward_move);
+    n_write_u8(writer, (u8)input->side_move);
+    n_write_u16(writer, input->yaw);
+    n_write_u16(writer, input->pitch);
+    n_write_u16(writer, input->buttons);
+    n_write_u8(writer, input->weapon_select);
+
+    bool has_attack = input->attack_subtick != QK_SUBTICK_NONE;
+    n_write_bool(writer, has_attack);
+    if (has_attack) {
+        n_write_u8(writer, input->attack_subtick);
+        n_write_u16(writer, input->attack_yaw);
+        n_write_u16(writer, input->attack_pitch);
+    }
+
+    bool has_jump = input->jump_subtick != QK_SUBTICK_NONE;
+    n_write_bool(writer, has_jump);
+    if (has_jump) {
+        n_write_u8(writer, input->jump_subtick);
+    }
+}
+
+void n_input_read(n_bitreader_t *reader, n_input_t *out_input) {
+    *out_input = (n_input_t){
+        .forward_move = (i8)n_read_u8(reader),
+        .side_move = (i8)n_read_u8(reader),
+        .yaw = n_read_u16(reader),
+        .pitch = n_read_u16(reader),
+        .buttons = n_read_u16(reader),
+        .weapon_select = n_read_u8(reader),
+    };
+
+    if (n_read_bool(reader)) {
+        out_input->attack_subtick = n_read_u8(reader);
+        out_input->attack_yaw = n_read_u16(reader);
+        out_input->attack_pitch = n_read_u16(reader);
+    }
+    if (n_read_bool(reader)) {
+        out_input->jump_subtick = n_read_u8(reader);
+    }
+}
+
+// --- Game event encoding ---
+// Type and age (ticks before the message's through-tick), then only the
+// fields that type uses: 2 to 12 bytes per event.
+
+static const u8 s_event_field_bytes[N_GEVT_COUNT] = {
+    [N_GEVT_KILL]        = 3,
+    [N_GEVT_HIT]         = 4,
+    [N_GEVT_ROUND_START] = 1,
+    [N_GEVT_ROUND_END]   = 3,
+    [N_GEVT_MATCH_END]   = 1,
+    [N_GEVT_EXPLOSION]   = 10,
+};
+
+u32 n_game_event_wire_bytes(const n_game_event_t *event) {
+    if (event->type >= N_GEVT_COUNT) return 0;
+    return 2 + s_event_field_bytes[event->type];
+}
+
+void n_game_event_write(n_bitwriter_t *writer, const n_game_event_t *event, u8 age) {
+    n_write_u8(writer, event->type);
+    n_write_u8(writer, age);
+
+    switch (event->type) {
+        case N_GEVT_KILL:
+            n_write_u8(writer, event->data.kill.attacker);
+            n_write_u8(writer, event->data.kill.victim);
+            n_write_u8(writer, event->data.kill.weapon);
+            break;
+        case N_GEVT_HIT:
+            n_write_u8(writer, event->data.hit.target);
+            n_write_u8(writer, event->data.hit.attacker);
+            n_write_i16(writer, event->data.hit.damage);
+            break;
+        case N_GEVT_ROUND_START:
+            n_write_u8(writer, event->data.round_start.round_number);
+            break;
+        case N_GEVT_ROUND_END:
+            n_write_u8(writer, event->data.round_end.winner_team);
+            n_write_u8(writer, event->data.round_end.score_a);
+            n_write_u8(writer, event->data.round_end.score_b);
+            break;
+        case N_GEVT_MATCH_END:
+            n_write_u8(writer, event->data.match_end.winner_team);
+            break;
+        case N_GEVT_EXPLOSION:
+            for (u32 k = 0; k < 3; k++) n_write_i16(writer, event->data.explosion.pos[k]);
+            for (u32 k = 0; k < 3; k++) n_write_u8(writer, (u8)event->data.explosion.dir[k]);
+            n_write_u8(writer, event->data.explosion.radius);
+            break;
+        default:
+            break;
+    }
+}
+
+bool n_game_event_read(n_bitreader_t *reader, n_game_event_t *out_event, u8 *out_age) {
+    memset(out_event, 0, sizeof(*out_event));
+    out_event->type = n_read_u8(reader);
+    *out_age = n_read_u8(reader);
+
+    switch (out_event->type) {
+        case N_GEVT_KILL:
+            out_event->data.kill.attacker = n_read_u8(reader);
+            out_event->data.kill.victim = n_read_u8(reader);
+            out_event->data.kill.weapon = n_read_u8(reader);
+            break;
+        case N_GEVT_HIT:
+            out_event->data.hit.target = n_read_u8(reader);
+            out_event->data.hit.attacker = n_read_u8(reader);
+            out_event->data.hit.damage = n_read_i16(reader);
+            break;
+        case N_GEVT_ROUND_START:
+            out_event->data.round_start.round_number = n_read_u8(reader);
+            break;
+        case N_GEVT_ROUND_END:
+            out_event->data.round_end.winner_team = n_read_u8(reader);
+            out_event->data.round_end.score_a = n_read_u8(reader);
+            out_event->data.round_end.score_b = n_read_u8(reader);
+            break;
+        case N_GEVT_MATCH_END:
+            out_event->data.match_end.winner_team = n_read_u8(reader);
+            break;
+        case N_GEVT_EXPLOSION:
+            for (u32 k = 0; k < 3; k++) out_event->data.explosion.pos[k] = n_read_i16(reader);
+            for (u32 k = 0; k < 3; k++) out_event->data.explosion.dir[k] = (i8)n_read_u8(reader);
+            out_event->data.explosion.radius = n_read_u8(reader);
+            break;
+        default:
+            return false;   // unknown size: the rest of the message is unreadable
+    }
+    return !n_bitreader_overflowed(reader);
+}
@@ -0,0 +1,112 @@
+/*
+ * QUICKEN Engine - Server Query
+ *
+ * Server-browser side of the connectionless info query. One UDP socket,
+ * one server; each request carries a token the server echoes, so replies
+ * are matched to their send time for a ping without any connection state.
+ *
+ * Request:  packet header (zeroed) + INFO_REQUEST { u32 token }
+ * Reply:    packet header (zeroed) + INFO_RESPONSE { u32 token, u8 players,
+ *           u8 spectators, u8 max_clients, u16 tick_rate, u8 map_len, map }
+ */
+
+#include "n_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef QUICKEN_DEBUG
+#define N_DBG(fmt, ...) fprintf(stderr, "[NET-QY] " fmt "\n", ##__VA_ARGS__)
+#else
+#define N_DBG(fmt, ...) ((void)0)
+#endif
+
+#ifdef QK_PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+bool n_query_open(n_query_t *query, const char *address, u16 port) {
+    memset(query, 0, sizeof(*query));
+    n_platform_init();
+
+    struct in_addr addr;
+    if (inet_pton(AF_INET, address, &addr) != 1) return false;
+    query->server_address.ip = ntohl(addr.s_addr);
+    query->server_address.port = port;
+
+    if (!n_transport_open_udp(&query->transport, 0)) return false;
+
+    query->token_base = n_random_u32();
+    query->open = true;
+    return true;
+}
+
+bool n_query_send(n_query_t *query) {
+    if (!query->open) return false;
+
+    u8 pkt[N_PACKET_HEADER_SIZE + 8];
+    n_packet_header_t hdr = {0};
+    n_packet_header_write(pkt, &hdr);
+
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE, sizeof(pkt) - N_PACKET_HEADER_SIZE);
+    n_msg_header_write(&writer, N_MSG_INFO_REQUEST, 4);
+    n_write_u32(&writer, query->token_base + query->sent_count);
+    n_msg_header_write(&writer, N_MSG_NOP, 0);
+
+    query->sent_us[query->sent_count % N_QUERY_PENDING] = n_platform_time_us();
+    query->sent_count++;
+
+    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
+    return n_transport_send(&query->transport, &query->server_address, pkt, total) > 0;
+}
+
+bool n_query_poll(n_query_t *query, qk_net_server_info_t *out_info) {
+    if (!query->open) return false;
+
+    u8 buf[N_TRANSPORT_MTU];
+    n_address_t from;
+    i32 len;
+    while ((len = n_transport_recv(&query->transport, &from, buf, sizeof(buf))) > 0) {
+        u64 now_us = n_platform_time_us();
+        if (from.ip != query->server_address.ip || from.port != query->server_address.port) continue;
+        if ((u32)len < N_PACKET_HEADER_SIZE) continue;
+
+        n_bitreader_t reader;
+        n_bitreader_init(&reader, buf + N_PACKET_HEADER_SIZE, (u32)len - N_PACKET_HEADER_SIZE);
+        n_msg_header_t msg;
+        if (!n_msg_header_read(&reader, &msg) || msg.type != N_MSG_INFO_RESPONSE) continue;
+
+        // Only tokens still in the send-time ring
+        u32 seq = n_read_u32(&reader) - query->token_base;
+        if (seq >= query->sent_count || query->sent_count - seq > N_QUERY_PENDING) continue;
+
+        memset(out_info, 0, sizeof(*out_info));
+        out_info->players = n_read_u8(&reader);
+        out_info->spectators = n_read_u8(&reader);
+        out_info->max_clients = n_read_u8(&reader);
+        out_info->tick_rate = n_read_u16(&reader);
+        u32 map_len = n_read_u8(&reader);
+        if (map_len >= sizeof(out_info->map_name)) map_len = sizeof(out_info->map_name) - 1;
+        for (u32 i = 0; i < map_len; i++) {
+            out_info->map_name[i] = (char)n_read_u8(&reader);
+        }
+        if (n_bitreader_overflowed(&reader)) continue;
+
+        out_info->ping_us = (u32)(now_us - query->sent_us[seq % N_QUERY_PENDING]);
+        N_DBG("reply: seq=%u players=%u/%u ping=%uus", seq, (u32)out_info->players,
+              (u32)out_info->max_clients, out_info->ping_us);
+        return true;
+    }
+    return false;
+}
+
+void n_query_close(n_query_t *query) {
+    if (query->open) n_transport_close(&query->transport);
+    query->open = false;
+}
@@ -0,0 +1,580 @@
+/*
+ * QUICKEN Engine - Spectator Relay
+ *
+ * One upstream connection to a game server (flagged as a relay, so it gets
+ * no player and costs the server one ordinary slot), fanned out to many
+ * downstream viewers. Viewers are normal clients: they see the usual
+ * handshake and snapshot stream, minus the private player state.
+ *
+ * Upstream snapshots are decoded by an embedded n_client_t, held in a delay
+ * queue, then released into a history ring and re-encoded per viewer
+ * baseline. Viewers that acked the same tick share one delta encode.
+ */
+
+#include "n_internal.h"
+#include "core/qk_prof.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef QUICKEN_DEBUG
+#define N_DBG(fmt, ...) fprintf(stderr, "[NET-RL] " fmt "\n", ##__VA_ARGS__)
+#else
+#define N_DBG(fmt, ...) ((void)0)
+#endif
+
+// --- Helpers ---
+
+static u64 viewer_key(const n_address_t *addr) {
+    // Bit 48 marks the key as live so a zeroed address never matches
+    return ((u64)1 << 48) | ((u64)addr->ip << 16) | addr->port;
+}
+
+static i32 relay_find_viewer(const n_relay_t *relay, const n_address_t *addr) {
+    u64 key = viewer_key(addr);
+    for (u32 i = 0; i < relay->max_viewers; i++) {
+        if (relay->viewer_keys[i] == key) return (i32)i;
+    }
+    return -1;
+}
+
+static void viewer_update_ack(n_viewer_t *viewer, u16 remote_seq) {
+    if (viewer->incoming_sequence == 0 && viewer->ack_bitfield == 0) {
+        viewer->incoming_sequence = remote_seq;
+        return;
+    }
+
+    if (n_sequence_more_recent(remote_seq, viewer->incoming_sequence)) {
+        u16 diff = remote_seq - viewer->incoming_sequence;
+        if (diff <= 32) {
+            viewer->ack_bitfield = (viewer->ack_bitfield << diff) | (1u << (diff - 1));
+        } else {
+            viewer->ack_bitfield = 0;
+        }
+        viewer->incoming_sequence = remote_seq;
+    } else {
+        u16 diff = viewer->incoming_sequence - remote_seq;
+        if (diff > 0 && diff <= 32) {
+            viewer->ack_bitfield |= (1u << (diff - 1));
+        }
+    }
+}
+
+// Packet header + writer over the rest of the relay's packet buffer
+static void viewer_begin_packet(n_relay_t *relay, n_viewer_t *viewer, n_bitwriter_t *writer) {
+    n_packet_header_t hdr = {
+        .sequence = viewer->outgoing_sequence++,
+        .ack = viewer->incoming_sequence,
+        .ack_bitfield = viewer->ack_bitfield,
+    };
+    n_packet_header_write(relay->packet_buffer, &hdr);
+    n_bitwriter_init(writer, relay->packet_buffer + N_PACKET_HEADER_SIZE,
+                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
+}
+
+static void viewer_send_packet(n_relay_t *relay, const n_viewer_t *viewer,
+                               n_bitwriter_t *writer) {
+    n_msg_header_write(writer, N_MSG_NOP, 0);
+
+    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(writer);
+    n_transport_send(&relay->transport, &viewer->address, relay->packet_buffer, total);
+
+    relay->stats.packets_sent++;
+    relay->stats.bytes_sent += total;
+    QK_PROF_COUNTER("rl_packets_sent", 1);
+    QK_PROF_COUNTER("rl_bytes_sent", total);
+}
+
+static void relay_drop_viewer(n_relay_t *relay, u32 index, bool notify) {
+    n_viewer_t *viewer = &relay->viewers[index];
+    if (viewer->state == N_CONN_DISCONNECTED) return;
+
+    N_DBG("drop_viewer: %u notify=%d", index, notify);
+
+    if (notify && viewer->state == N_CONN_CONNECTED) {
+        n_bitwriter_t writer;
+        viewer_begin_packet(relay, viewer, &writer);
+        n_msg_header_write(&writer, N_MSG_DISCONNECT, 0);
+        viewer_send_packet(relay, viewer, &writer);
+    }
+
+    memset(viewer, 0, sizeof(*viewer));
+    viewer->state = N_CONN_DISCONNECTED;
+    relay->viewer_keys[index] = 0;
+    if (relay->viewer_count > 0) relay->viewer_count--;
+}
+
+// --- Lifecycle ---
+
+bool n_relay_init(n_relay_t *relay, u16 listen_port, u32 max_viewers, f64 delay) {
+    memset(relay, 0, sizeof(*relay));
+
+    if (max_viewers == 0) max_viewers = N_RELAY_MAX_VIEWERS_DEFAULT;
+    if (delay < 0.0) delay = 0.0;
+    if (delay > N_RELAY_DELAY_MAX) delay = N_RELAY_DELAY_MAX;
+
+    relay->max_viewers = max_viewers;
+    relay->delay = delay;
+    relay->queue_capacity = (u32)(delay * (f64)N_TICK_RATE) + N_RELAY_QUEUE_SLACK;
+    relay->listen_port = listen_port;
+
+    relay->queue = (n_snapshot_t *)calloc(relay->queue_capacity, sizeof(n_snapshot_t));
+    relay->queue_arrival = (f64 *)calloc(relay->queue_capacity, sizeof(f64));
+    relay->viewers = (n_viewer_t *)calloc(max_viewers, sizeof(n_viewer_t));
+    relay->viewer_keys = (u64 *)calloc(max_viewers, sizeof(u64));
+    if (!relay->queue || !relay->queue_arrival || !relay->viewers || !relay->viewer_keys) {
+        N_DBG("init: FAILED to allocate (%u queue slots, %u viewers)",
+              relay->queue_capacity, max_viewers);
+        n_relay_shutdown(relay);
+        return false;
+    }
+
+    n_client_init(&relay->upstream, 0.0, 0.0);
+    relay->upstream.connect_flags = N_CONNECT_FLAG_RELAY;
+
+    n_platform_init();
+    if (!n_transport_open_udp(&relay->transport, listen_port)) {
+        N_DBG("init: FAILED to bind UDP port=%u", (u32)listen_port);
+        n_relay_shutdown(relay);
+        return false;
+    }
+
+    relay->initialized = true;
+    N_DBG("init: port=%u max_viewers=%u delay=%.1fs queue=%u",
+          (u32)listen_port, max_viewers, delay, relay->queue_capacity);
+    return true;
+}
+
+void n_relay_shutdown(n_relay_t *relay) {
+    if (relay->initialized) {
+        for (u32 i = 0; i < relay->max_viewers; i++) {
+            relay_drop_viewer(relay, i, true);
+        }
+        n_client_shutdown(&relay->upstream);
+        n_transport_close(&relay->transport);
+    }
+
+    free(relay->queue);
+    free(relay->queue_arrival);
+    free(relay->viewers);
+    free(relay->viewer_keys);
+    relay->queue = NULL;
+    relay->queue_arrival = NULL;
+    relay->viewers = NULL;
+    relay->viewer_keys = NULL;
+    relay->initialized = false;
+}
+
+void n_relay_connect(n_relay_t *relay, const char *address, u16 port) {
+    if (!relay->initialized) return;
+
+    // A new upstream may be a different server, map and tick base:
+    // viewers have to start over
+    for (u32 i = 0; i < relay->max_viewers; i++) {
+        relay_drop_viewer(relay, i, true);
+    }
+    relay->queue_head = 0;
+    relay->queue_count = 0;
+    relay->captured_tick = 0;
+    relay->tick = 0;
+    memset(&relay->history, 0, sizeof(relay->history));
+    relay->last_map_loaded_time = 0.0;
+    relay->last_keepalive_time = 0.0;
+
+    n_client_disconnect(&relay->upstream);
+    n_client_connect_remote(&relay->upstream, address, port);
+}
+
+// --- Upstream ---
+
+static void relay_upstream_tick(n_relay_t *relay, f64 now) {
+    n_client_t *up = &relay->upstream;
+    if (up->conn_state != N_CONN_CONNECTED) return;
+
+    // The relay never loads the map; it vouches for whatever the server named
+    // so the server starts streaming, and hands the same name to viewers
+    if (!up->map_ready && now - relay->last_map_loaded_time >= N_CONNECT_RETRY_SEC) {
+        relay->upstream_map_hash = n_hash_map_name(up->server_map_name);
+        n_client_send_map_loaded(up, relay->upstream_map_hash);
+        relay->last_map_loaded_time = now;
+    }
+
+    // Idle input once per tick: keeps the connection alive and, through the
+    // server's input-tick ack, acks the newest snapshot we hold
+    if (now - relay->last_keepalive_time >= N_TICK_INTERVAL) {
+        n_input_t idle = {0};
+        up->input_tick = relay->captured_tick + N_INPUT_ACK_LAG;
+        n_client_send_input(up, &idle, now);
+        relay->last_keepalive_time = now;
+    }
+}
+
+static void relay_release(n_relay_t *relay);
+
+static void relay_capture(n_relay_t *relay, f64 now) {
+    const n_client_t *up = &relay->upstream;
+
+    // Oldest to newest; anything at or below the last captured tick is
+    // either already queued or arrived out of order
+    for (u32 i = up->interp_count; i > 0; i--) {
+        u32 idx = (up->interp_write + N_INTERP_BUFFER_SIZE - i) % N_INTERP_BUFFER_SIZE;
+        const n_snapshot_t *snap = &up->interp_snapshots[idx];
+        if (snap->tick <= relay->captured_tick) continue;
+
+        if (relay->queue_count == relay->queue_capacity) {
+            relay_release(relay);   // never drop: release early instead
+        }
+
+        u32 slot = (relay->queue_head + relay->queue_count) % relay->queue_capacity;
+        relay->queue[slot] = *snap;
+        relay->queue_arrival[slot] = now;
+        relay->queue_count++;
+        relay->captured_tick = snap->tick;
+    }
+}
+
+// --- Downstream broadcast ---
+
+static const n_snapshot_t *relay_find_baseline(const n_relay_t *relay,
+                                               const n_viewer_t *viewer) {
+    // The implicit ack runs off the viewer's input clock, which starts at
+    // MAP_CONFIRMED and can name ticks it was never sent
+    u32 ack_tick = viewer->last_acked_snapshot_tick;
+    if (ack_tick == 0 || ack_tick < viewer->first_snapshot_tick) return NULL;
+
+    // Same rules as the server: the ack must still be in history and older
+    // than the snapshot being sent
+    const n_snapshot_t *candidate = &relay->history.snapshots[ack_tick % N_SNAPSHOT_HISTORY];
+    if (candidate->tick != ack_tick) return NULL;
+    u32 age = relay->tick - ack_tick;
+    if (age == 0 || age >= N_SNAPSHOT_HISTORY) return NULL;
+    return candidate;
+}
+
+static const n_relay_encode_t *relay_encode(n_relay_t *relay, const n_snapshot_t *baseline,
+                                            const n_snapshot_t *current,
+                                            n_relay_encode_t *spill) {
+    u32 base_tick = baseline ? baseline->tick : 0;
+    for (u32 i = 0; i < relay->encode_count; i++) {
+        if (relay->encodes[i].base_tick == base_tick) {
+            relay->encodes_shared++;
+            return &relay->encodes[i];
+        }
+    }
+
+    // Cache full (viewers spread over many baselines): encode uncached
+    n_relay_encode_t *enc = relay->encode_count < N_RELAY_ENCODE_CACHE
+                          ? &relay->encodes[relay->encode_count++] : spill;
+    enc->base_tick = base_tick;
+    enc->len = n_snapshot_delta_encode(baseline, current, enc->data, sizeof(enc->data));
+    relay->encodes_done++;
+    return enc;
+}
+
+static void relay_send_snapshot(n_relay_t *relay, n_viewer_t *viewer,
+                                const n_relay_encode_t *enc) {
+    n_bitwriter_t writer;
+    viewer_begin_packet(relay, viewer, &writer);
+
+    // Same layout as the server's: header (19) + player_state_flag (1) + delta.
+    // Viewers own no player, so the flag is always 0.
+    n_msg_header_write(&writer, N_MSG_SNAPSHOT, (u16)(19 + 1 + enc->len));
+    n_write_u32(&writer, enc->base_tick);
+    n_write_u32(&writer, relay->tick);
+    n_write_u32(&writer, viewer->last_input_tick);
+    n_write_u8(&writer, (u8)N_INPUT_DEPTH_UNKNOWN);
+
+    u16 hold_us = N_CLOCK_HOLD_UNKNOWN;
+    if (viewer->has_echo) {
+        u64 held = n_platform_time_us() - viewer->echo_recv_us;
+        if (held < N_CLOCK_HOLD_UNKNOWN) hold_us = (u16)held;
+    }
+    n_write_u32(&writer, viewer->echo_time_us);
+    n_write_u16(&writer, hold_us);
+    n_write_u8(&writer, 0);
+
+    for (u32 b = 0; b < enc->len; b++) {
+        n_write_u8(&writer, enc->data[b]);
+    }
+
+    viewer_send_packet(relay, viewer, &writer);
+
+    if (enc->base_tick) {
+        relay->stats.snapshots_delta++;
+    } else {
+        relay->stats.snapshots_full++;
+    }
+}
+
+static void relay_release(n_relay_t *relay) {
+    const n_snapshot_t *queued = &relay->queue[relay->queue_head];
+    relay->queue_head = (relay->queue_head + 1) % relay->queue_capacity;
+    relay->queue_count--;
+
+    u32 hist_idx = queued->tick % N_SNAPSHOT_HISTORY;
+    relay->history.snapshots[hist_idx] = *queued;
+    relay->history.current_index = hist_idx;
+    relay->tick = queued->tick;
+
+    const n_snapshot_t *current = &relay->history.snapshots[hist_idx];
+    n_relay_encode_t spill;
+    relay->encode_count = 0;
+
+    for (u32 i = 0; i < relay->max_viewers; i++) {
+        n_viewer_t *viewer = &relay->viewers[i];
+        if (viewer->state != N_CONN_CONNECTED || !viewer->map_ready) continue;
+
+        if (viewer->first_snapshot_tick == 0) viewer->first_snapshot_tick = relay->tick;
+        const n_snapshot_t *baseline = relay_find_baseline(relay, viewer);
+        relay_send_snapshot(relay, viewer, relay_encode(relay, baseline, current, &spill));
+    }
+}
+
+// --- Downstream packets ---
+
+static void relay_handle_connect_request(n_relay_t *relay, const u8 *payload, u32 len,
+                                         const n_address_t *from, f64 now) {
+    if (len < 4) return;
+
+    // Nothing to offer until the upstream has a map: stay silent, the
+    // viewer keeps retrying
+    if (!relay->upstream.map_ready) return;
+
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, payload, len);
+    u32 client_challenge = n_read_u32(&reader);
+
+    i32 index = relay_find_viewer(relay, from);
+    if (index < 0) {
+        for (u32 i = 0; i < relay->max_viewers; i++) {
+            if (relay->viewer_keys[i] == 0) {
+                index = (i32)i;
+                break;
+            }
+        }
+
+        if (index < 0) {
+            u8 resp[N_TRANSPORT_MTU];
+            n_packet_header_t hdr = {0};
+            n_packet_header_write(resp, &hdr);
+
+            n_bitwriter_t writer;
+            n_bitwriter_init(&writer, resp + N_PACKET_HEADER_SIZE,
+                             N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
+            n_msg_header_write(&writer, N_MSG_CONNECT_REJECTED, 1);
+            n_write_u8(&writer, 1); // reason: full
+            n_msg_header_write(&writer, N_MSG_NOP, 0);
+
+            u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
+            n_transport_send(&relay->transport, from, resp, total);
+            return;
+        }
+
+        n_viewer_t *viewer = &relay->viewers[index];
+        memset(viewer, 0, sizeof(*viewer));
+        viewer->state = N_CONN_CONNECTING;
+        viewer->address = *from;
+        viewer->client_challenge = client_challenge;
+        viewer->server_challenge = n_random_u32();
+        viewer->connect_start_time = now;
+        viewer->last_packet_recv_time = now;
+        relay->viewer_keys[index] = viewer_key(from);
+        relay->viewer_count++;
+    }
+
+    n_viewer_t *viewer = &relay->viewers[index];
+    if (viewer->state != N_CONN_CONNECTING) return;
+
+    n_bitwriter_t writer;
+    viewer_begin_packet(relay, viewer, &writer);
+    n_msg_header_write(&writer, N_MSG_CONNECT_CHALLENGE, 8);
+    n_write_u32(&writer, viewer->server_challenge);
+    n_write_u32(&writer, client_challenge);
+    viewer_send_packet(relay, viewer, &writer);
+}
+
+static void relay_handle_connect_response(n_relay_t *relay, n_viewer_t *viewer,
+                                          const u8 *payload, u32 len, f64 now) {
+    if (viewer->state != N_CONN_CONNECTING) return;
+    if (len < 8) return;
+
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, payload, len);
+    u32 server_challenge = n_read_u32(&reader);
+    u32 client_challenge = n_read_u32(&reader);
+
+    if (server_challenge != viewer->server_challenge) return;
+    if (client_challenge != viewer->client_challenge) return;
+
+    viewer->state = N_CONN_CONNECTED;
+    viewer->last_packet_recv_time = now;
+
+    // Every viewer gets the relay's own upstream id: the server has no
+    // player there, so a stock client's local player never shows up in
+    // the stream and it simply watches
+    const char *map_name = relay->upstream.server_map_name;
+    u32 map_name_len = (u32)strlen(map_name);
+
+    n_bitwriter_t writer;
+    viewer_begin_packet(relay, viewer, &writer);
+    n_msg_header_write(&writer, N_MSG_CONNECT_ACCEPTED, (u16)(5 + 1 + map_name_len));
+    n_write_u8(&writer, relay->upstream.client_id);
+    n_write_u32(&writer, relay->tick);
+    n_write_u8(&writer, (u8)map_name_len);
+    for (u32 mi = 0; mi < map_name_len; mi++) {
+        n_write_u8(&writer, (u8)map_name[mi]);
+    }
+    viewer_send_packet(relay, viewer, &writer);
+
+    N_DBG("viewer connected: %u viewers", relay->viewer_count);
+}
+
+static void relay_handle_input(n_viewer_t *viewer, const u8 *payload, u32 len) {
+    // Only the header matters: the newest tick is the snapshot ack and the
+    // timestamp is echoed for the viewer's clock
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, payload, len);
+    u32 input_count = n_read_bits(&reader, 2) + 1;
+    u32 start_tick = n_read_u32(&reader);
+    u32 client_time_us = n_read_u32(&reader);
+    if (n_bitreader_overflowed(&reader)) return;
+
+    viewer->echo_time_us = client_time_us;
+    viewer->echo_recv_us = n_platform_time_us();
+    viewer->has_echo = true;
+
+    u32 newest = start_tick + input_count - 1;
+    if (newest > viewer->last_input_tick) viewer->last_input_tick = newest;
+
+    u32 ack_tick = viewer->last_input_tick > N_INPUT_ACK_LAG
+                 ? viewer->last_input_tick - N_INPUT_ACK_LAG : 1;
+    if (ack_tick > viewer->last_acked_snapshot_tick) {
+        viewer->last_acked_snapshot_tick = ack_tick;
+    }
+}
+
+static void relay_handle_map_loaded(n_relay_t *relay, n_viewer_t *viewer,
+                                    const u8 *payload, u32 len) {
+    if (viewer->state != N_CONN_CONNECTED) return;
+    if (len < 4) return;
+
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, payload, len);
+    u32 map_hash = n_read_u32(&reader);
+    if (map_hash != relay->upstream_map_hash) {
+        N_DBG("map_loaded: viewer hash mismatch (0x%08x vs 0x%08x)",
+              map_hash, relay->upstream_map_hash);
+        return;
+    }
+
+    viewer->map_ready = true;
+    viewer->last_acked_snapshot_tick = 0;
+    viewer->first_snapshot_tick = 0;
+
+    n_bitwriter_t writer;
+    viewer_begin_packet(relay, viewer, &writer);
+    n_msg_header_write(&writer, N_MSG_MAP_CONFIRMED, 4);
+    n_write_u32(&writer, relay->tick);
+    viewer_send_packet(relay, viewer, &writer);
+}
+
+static void relay_process_packet(n_relay_t *relay, const u8 *data, u32 len,
+                                 const n_address_t *from, f64 now) {
+    if (len < N_PACKET_HEADER_SIZE) {
+        relay->stats.packets_dropped++;
+        return;
+    }
+
+    n_packet_header_t hdr;
+    n_packet_header_read(data, &hdr);
+
+    i32 index = relay_find_viewer(relay, from);
+
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, data + N_PACKET_HEADER_SIZE, len - N_PACKET_HEADER_SIZE);
+
+    while (!n_bitreader_overflowed(&reader)) {
+        n_msg_header_t msg;
+        if (!n_msg_header_read(&reader, &msg)) break;
+        if (msg.type == N_MSG_NOP) break;
+
+        u8 payload_buf[256];
+        u32 payload_bytes = msg.length < sizeof(payload_buf) ? msg.length : sizeof(payload_buf);
+        for (u32 b = 0; b < payload_bytes; b++) {
+            payload_buf[b] = n_read_u8(&reader);
+        }
+        for (u32 b = payload_bytes; b < msg.length; b++) {
+            n_read_u8(&reader);
+        }
+
+        if (msg.type == N_MSG_CONNECT_REQUEST) {
+            relay_handle_connect_request(relay, payload_buf, payload_bytes, from, now);
+            index = relay_find_viewer(relay, from);
+            continue;
+        }
+        if (index < 0) continue;
+
+        n_viewer_t *viewer = &relay->viewers[index];
+        viewer_update_ack(viewer, hdr.sequence);
+        viewer->last_packet_recv_time = now;
+
+        switch (msg.type) {
+            case N_MSG_CONNECT_RESPONSE:
+                relay_handle_connect_response(relay, viewer, payload_buf, payload_bytes, now);
+                break;
+            case N_MSG_INPUT:
+                if (viewer->state == N_CONN_CONNECTED) {
+                    relay_handle_input(viewer, payload_buf, payload_bytes);
+                }
+                break;
+            case N_MSG_MAP_LOADED:
+                relay_handle_map_loaded(relay, viewer, payload_buf, payload_bytes);
+                break;
+            case N_MSG_DISCONNECT:
+                relay_drop_viewer(relay, (u32)index, false);
+                return;
+            default:
+                break;
+        }
+    }
+
+    relay->stats.packets_received++;
+    relay->stats.bytes_received += len;
+}
+
+// --- Relay tick ---
+
+void n_relay_tick(n_relay_t *relay, f64 now) {
+    if (!relay->initialized) return;
+
+    n_client_tick(&relay->upstream, now);
+    relay_upstream_tick(relay, now);
+    if (relay->upstream.conn_state == N_CONN_CONNECTED) {
+        relay_capture(relay, now);
+    }
+
+    // Viewer acks first, so releases below pick the freshest baselines
+    u8 recv_buf[N_TRANSPORT_MTU];
+    n_address_t from;
+    i32 recv_len;
+    while ((recv_len = n_transport_recv(&relay->transport, &from,
+                                        recv_buf, sizeof(recv_buf))) > 0) {
+        relay_process_packet(relay, recv_buf, (u32)recv_len, &from, now);
+    }
+
+    while (relay->queue_count > 0 &&
+           now - relay->queue_arrival[relay->queue_head] >= relay->delay) {
+        relay_release(relay);
+    }
+
+    for (u32 i = 0; i < relay->max_viewers; i++) {
+        n_viewer_t *viewer = &relay->viewers[i];
+        if (viewer->state == N_CONN_DISCONNECTED) continue;
+
+        if (viewer->state == N_CONN_CONNECTING &&
+            now - viewer->connect_start_time > N_CONNECT_TIMEOUT_SEC) {
+            relay_drop_viewer(relay, i, false);
+        } else if (now - viewer->last_packet_recv_time > N_TIMEOUT_SEC) {
+            relay_drop_viewer(relay, i, false);
+        }
+    }
+}
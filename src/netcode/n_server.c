@@ -177,6 +177,30 @@ void n_server_send_to_client(n_server_t *srv, u32 slot, const u8 *data, u32 len)
     QK_PROF_COUNTER("sv_bytes_sent", len);
 }
 
+// Everything queued for this client, in as few packets as fit
+void n_server_flush_client(n_server_t *srv, u32 slot) {
+    n_client_slot_t *client = &srv->clients[slot];
+    u8 pkt[N_TRANSPORT_MTU];
+
+    while (!n_msg_queue_empty(&client->outgoing)) {
+        n_packet_header_t hdr = {
+            .sequence = client->outgoing_sequence,
+            .ack = client->incoming_sequence,
+            .ack_bitfield = client->ack_bitfield,
+        };
+        u32 messages = 0;
+        u32 total = n_msg_queue_pack(&client->outgoing, &hdr, pkt, sizeof(pkt), &messages);
+        if (total == 0) continue;   // only oversize messages were left
+
+        client->outgoing_sequence++;
+        n_server_send_to_client(srv, slot, pkt, total);
+        srv->stats.messages_sent += messages;
+    }
+
+    srv->stats.messages_dropped += client->outgoing.dropped;
+    client->outgoing.dropped = 0;
+}
+
 // --- Full-precision player state packing ---
 
 static void n_pack_player_state(const qk_player_state_t *ps, n_player_state_t *out) {
@@ -208,8 +232,98 @@ static void n_pack_player_state(const qk_player_state_t *ps, n_player_state_t *o
     memcpy(out->ammo, ps->ammo, sizeof(out->ammo));
 }
 
+// --- Game events ---
+
+// Stamped with the tick of the snapshot it will first travel with
+void n_server_push_event(n_server_t *srv, const n_game_event_t *event) {
+    n_game_event_t *slot = &srv->events[srv->event_head % N_EVENT_RING_SIZE];
+    *slot = *event;
+    slot->tick = srv->tick + 1;
+    srv->event_head++;
+}
+
+// Every event this client has not acked, oldest first. Redundant resends
+// instead of a reliable channel: a lost packet delays nothing behind it,
+// and the next snapshot carries the event again. Returns the payload length.
+static u32 write_events_message(n_server_t *srv, const n_client_slot_t *client, u8 *out) {
+    u32 oldest = srv->event_head > N_EVENT_RING_SIZE ? srv->event_head - N_EVENT_RING_SIZE : 0;
+    u32 floor_tick = srv->tick > N_EVENT_RESEND_TICKS ? srv->tick - N_EVENT_RESEND_TICKS : 0;
+    if (client->event_ack > floor_tick) floor_tick = client->event_ack;
+
+    u32 first = srv->event_head;
+    while (first > oldest && srv->events[(first - 1) % N_EVENT_RING_SIZE].tick > floor_tick) {
+        first--;
+    }
+
+    // Size pass: stop at a tick boundary so through_tick stays exact. A
+    // single tick too big for one message is cut short and the rest given up.
+    u32 through_tick = srv->tick;
+    u32 bytes = 5;
+    u32 end = first;
+    u32 tick_start = first;
+    for (u32 seq = first; seq != srv->event_head; seq++) {
+        const n_game_event_t *evt = &srv->events[seq % N_EVENT_RING_SIZE];
+        if (evt->tick > srv->tick) break;   // pushed after this tick's game step
+        if (evt->tick != srv->events[tick_start % N_EVENT_RING_SIZE].tick) tick_start = seq;
+        u32 need = n_game_event_wire_bytes(evt);
+        if (bytes + need > N_EVENT_MSG_MAX_BYTES || end - first == 255) {
+            if (tick_start == first) {
+                through_tick = evt->tick;
+            } else {
+                end = tick_start;
+                through_tick = evt->tick - 1;
+            }
+            break;
+        }
+        bytes += need;
+        end = seq + 1;
+    }
+    if (end == first) return 0;
+
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, out, N_EVENT_MSG_MAX_BYTES);
+    n_write_u32(&writer, through_tick);
+    n_write_u8(&writer, (u8)(end - first));
+    for (u32 seq = first; seq != end; seq++) {
+        const n_game_event_t *evt = &srv->events[seq % N_EVENT_RING_SIZE];
+        n_game_event_write(&writer, evt, (u8)(through_tick - evt->tick));
+    }
+    srv->stats.events_sent += end - first;
+    return n_bitwriter_bytes_written(&writer);
+}
+
 // --- Snapshot broadcast ---
 
+// Everything a snapshot message would carry except the entities, which the
+// client copies straight out of the history ring
+static void queue_direct_frame(n_server_t *srv, n_client_slot_t *client) {
+    // A client that stopped ticking loses its oldest frames, like packets
+    if (client->direct_head - client->direct_read >= N_DIRECT_QUEUE_SIZE) {
+        client->direct_read = client->direct_head - N_DIRECT_QUEUE_SIZE + 1;
+    }
+
+    n_direct_frame_t *frame = &client->direct_frames[client->direct_head % N_DIRECT_QUEUE_SIZE];
+    frame->tick = srv->tick;
+    frame->cmd_ack = client->last_input_tick;
+    frame->input_depth = client->input_depth_valid ? client->input_depth_min
+                                                   : N_INPUT_DEPTH_UNKNOWN;
+    client->input_depth_valid = false;
+
+    frame->echo_time_us = client->echo_time_us;
+    frame->hold_us = N_CLOCK_HOLD_UNKNOWN;
+    if (client->has_echo) {
+        u64 held = n_platform_time_us() - client->echo_recv_us;
+        if (held < N_CLOCK_HOLD_UNKNOWN) frame->hold_us = (u16)held;
+    }
+
+    const qk_player_state_t *auth_ps = qk_game_get_player_state(client->client_id);
+    frame->has_player_state = auth_ps != NULL;
+    if (auth_ps) n_pack_player_state(auth_ps, &frame->player_state);
+
+    client->direct_head++;
+    srv->stats.snapshots_direct++;
+}
+
 void n_server_broadcast_snapshots(n_server_t *srv) {
     // Store current snapshot in history ring buffer
     u32 hist_idx = srv->tick % N_SNAPSHOT_HISTORY;
@@ -222,26 +336,46 @@ void n_server_broadcast_snapshots(n_server_t *srv) {
     for (u32 i = 0; i < srv->max_clients; i++) {
         n_client_slot_t *client = &srv->clients[i];
         if (client->state != N_CONN_CONNECTED) continue;
-        if (!client->map_ready) continue;   // wait for map handshake
+        if (!client->map_ready) {
+            n_server_flush_client(srv, i);  // handshake replies
+            continue;
+        }
+
+        // Age the sent history up to this tick
+        u32 shift = srv->tick - client->sent_mask_tick;
+        client->sent_mask = shift >= 64 ? 0 : client->sent_mask << shift;
+        client->sent_mask_tick = srv->tick;
+
+        if (client->low_priority && srv->low_priority_interval > 1 &&
+            srv->tick % srv->low_priority_interval != 0) {
+            srv->stats.snapshots_thinned++;
+            n_server_flush_client(srv, i);
+            continue;
+        }
 
-        // Find baseline snapshot for this client
+        if (client->direct) {
+            queue_direct_frame(srv, client);
+            n_server_flush_client(srv, i);  // control messages still use loopback
+            continue;
+        }
+
+        // Find baseline snapshot for this client: the newest tick at or
+        // before its ack that was actually sent to it
         const n_snapshot_t *baseline = NULL;
-        if (client->last_acked_snapshot_tick > 0) {
-            u32 base_idx = client->last_acked_snapshot_tick % N_SNAPSHOT_HISTORY;
-            n_snapshot_t *candidate = &srv->snapshot_buffer.snapshots[base_idx];
-            if (candidate->tick == client->last_acked_snapshot_tick) {
-                // Verify baseline hasn't been overwritten and isn't
-                // the current tick (self-reference).  Self-reference
-                // happens when a multi-tick batch inflates ack_tick
-                // to match srv->tick.  The client can't have received
-                // the current tick's snapshot yet, so delta-encoding
-                // against it causes a client-side drop and cascading
-                // failures.  Fall back to full snapshot instead.
-                u32 age = srv->tick - client->last_acked_snapshot_tick;
-                if (age > 0 && age < N_SNAPSHOT_HISTORY) {
-                    baseline = candidate;
-                }
-            }
+        for (u32 base_tick = client->last_acked_snapshot_tick; base_tick > 0; base_tick--) {
+            // Self-reference (age 0) happens when a multi-tick batch
+            // inflates ack_tick to match srv->tick.  The client can't
+            // have received the current tick's snapshot yet, so
+            // delta-encoding against it causes a client-side drop and
+            // cascading failures.  Look further back instead.
+            u32 age = srv->tick - base_tick;
+            if (age == 0) continue;
+            if (age >= N_SNAPSHOT_HISTORY) break;  // overwritten
+            if (!(client->sent_mask & ((u64)1 << age))) continue;
+
+            n_snapshot_t *candidate = &srv->snapshot_buffer.snapshots[base_tick % N_SNAPSHOT_HISTORY];
+            if (candidate->tick == base_tick) baseline = candidate;
+            break;
         }
 
         // Delta encode
@@ -249,37 +383,38 @@ void n_server_broadcast_snapshots(n_server_t *srv) {
         u32 delta_len = n_snapshot_delta_encode(baseline, &srv->current_snapshot,
                                                 delta_buf, sizeof(delta_buf));
 
-        // Build packet with snapshot message
-        u8 *pkt = srv->packet_buffer;
-        n_packet_header_t hdr = {
-            .sequence = client->outgoing_sequence++,
-            .ack = client->incoming_sequence,
-            .ack_bitfield = client->ack_bitfield,
-        };
-        n_packet_header_write(pkt, &hdr);
-
-        n_bitwriter_t writer;
-        n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE,
-                         N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-
         // Pack full-precision player state for this client (if available)
         n_player_state_t ps_wire;
         u8 has_player_state = 0;
-        const qk_player_state_t *auth_ps = qk_game_get_player_state(client->client_id);
+        const qk_player_state_t *auth_ps = client->is_relay ? NULL
+                                         : qk_game_get_player_state(client->client_id);
         if (auth_ps) {
             n_pack_player_state(auth_ps, &ps_wire);
             has_player_state = 1;
         }
 
-        // Snapshot message: header (12) + player_state_flag (1) + [player_state] + delta
-        u16 ps_size = has_player_state ? (u16)sizeof(n_player_state_t) : 0;
-        u16 msg_payload_len = (u16)(12 + 1 + ps_size + delta_len);
-        n_msg_header_write(&writer, N_MSG_SNAPSHOT, msg_payload_len);
+        // Snapshot message: header (19) + player_state_flag (1) + [player_state] + delta
+        u8 *payload = srv->packet_buffer;
+        n_bitwriter_t writer;
+        n_bitwriter_init(&writer, payload, N_TRANSPORT_MTU);
 
         u32 base_tick = baseline ? baseline->tick : 0;
         n_write_u32(&writer, base_tick);
         n_write_u32(&writer, srv->tick);
         n_write_u32(&writer, client->last_input_tick);
+        n_write_u8(&writer, (u8)(client->input_depth_valid ? client->input_depth_min
+                                                           : N_INPUT_DEPTH_UNKNOWN));
+        client->input_depth_valid = false;
+
+        // Echo the newest input timestamp and how long it sat here, so the
+        // client can take an RTT sample from every snapshot
+        u16 hold_us = N_CLOCK_HOLD_UNKNOWN;
+        if (client->has_echo) {
+            u64 held = n_platform_time_us() - client->echo_recv_us;
+            if (held < N_CLOCK_HOLD_UNKNOWN) hold_us = (u16)held;
+        }
+        n_write_u32(&writer, client->echo_time_us);
+        n_write_u16(&writer, hold_us);
 
         // Write player state flag + data (before delta, so client can parse deterministically)
         n_write_u8(&writer, has_player_state);
@@ -295,11 +430,19 @@ void n_server_broadcast_snapshots(n_server_t *srv) {
             n_write_u8(&writer, delta_buf[b]);
         }
 
-        // Terminate with NOP
-        n_msg_header_write(&writer, N_MSG_NOP, 0);
+        if (n_msg_queue_push(&client->outgoing, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE,
+                             payload, (u16)n_bitwriter_bytes_written(&writer))) {
+            client->sent_mask |= 1;
+        }
 
-        u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-        n_server_send_to_client(srv, i, pkt, total);
+        if (!client->is_relay) {
+            u32 events_len = write_events_message(srv, client, payload);
+            if (events_len > 0) {
+                n_msg_queue_push(&client->outgoing, N_MSG_EVENTS, N_MSG_PRIORITY_STATE,
+                                 payload, (u16)events_len);
+            }
+        }
+        n_server_flush_client(srv, i);
 
         if (baseline) {
             srv->stats.snapshots_delta++;
@@ -309,6 +452,96 @@ void n_server_broadcast_snapshots(n_server_t *srv) {
     }
 }
 
+// --- Server info query ---
+
+// Rebuild the cached browser reply if anything it reports has changed.
+// Called once per tick, so queries in between cost one sendto each.
+static void refresh_info_packet(n_server_t *srv) {
+    u8 players = 0;
+    u8 spectators = 0;
+    for (u32 i = 0; i < srv->max_clients; i++) {
+        const n_client_slot_t *client = &srv->clients[i];
+        if (client->state != N_CONN_CONNECTED) continue;
+        if (client->is_relay) spectators++;
+        else players++;
+    }
+
+    if (srv->info_packet_len > 0 && players == srv->info_players &&
+        spectators == srv->info_spectators && srv->map_name_hash == srv->info_map_hash) {
+        return;
+    }
+    srv->info_players = players;
+    srv->info_spectators = spectators;
+    srv->info_map_hash = srv->map_name_hash;
+
+    u32 map_len = (u32)strlen(srv->map_name);
+    if (map_len > 127) map_len = 127;
+    u32 payload_len = 4 + 1 + 1 + 1 + 2 + 1 + map_len;
+
+    n_packet_header_t hdr = {0};
+    n_packet_header_write(srv->info_packet, &hdr);
+
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, srv->info_packet + N_PACKET_HEADER_SIZE,
+                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
+    n_msg_header_write(&writer, N_MSG_INFO_RESPONSE, (u16)payload_len);
+    srv->info_token_offset = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
+    n_write_u32(&writer, 0);   // token, patched per reply
+    n_write_u8(&writer, players);
+    n_write_u8(&writer, spectators);
+    n_write_u8(&writer, (u8)srv->max_clients);
+    n_write_u16(&writer, (u16)(1.0 / srv->tick_interval + 0.5));
+    n_write_u8(&writer, (u8)map_len);
+    for (u32 i = 0; i < map_len; i++) {
+        n_write_u8(&writer, (u8)srv->map_name[i]);
+    }
+    n_msg_header_write(&writer, N_MSG_NOP, 0);
+
+    srv->info_packet_len = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
+    N_DBG("info: rebuilt players=%u spectators=%u map=%s",
+          (u32)players, (u32)spectators, srv->map_name);
+}
+
+// Token bucket per source IP; ports are ignored so one host cannot
+// multiply its budget with more sockets
+bool n_server_info_query_allowed(n_info_limit_t *limits, u32 ip, f64 now) {
+    n_info_limit_t *limit = &limits[((ip * 2654435761u) >> 16) % N_INFO_LIMIT_SLOTS];
+    if (limit->ip != ip) {
+        // A colliding source takes the slot over only once its bucket would
+        // have refilled anyway; until then both draw on the same tokens
+        if (limit->ip == 0 || now - limit->last_time >= N_INFO_QUERY_BURST / N_INFO_QUERY_RATE) {
+            limit->ip = ip;
+            limit->tokens = N_INFO_QUERY_BURST;
+            limit->last_time = now;
+        }
+    }
+
+    limit->tokens += (f32)(now - limit->last_time) * N_INFO_QUERY_RATE;
+    if (limit->tokens > N_INFO_QUERY_BURST) limit->tokens = N_INFO_QUERY_BURST;
+    limit->last_time = now;
+
+    if (limit->tokens < 1.0f) return false;
+    limit->tokens -= 1.0f;
+    return true;
+}
+
+static void handle_info_request(n_server_t *srv, n_bitreader_t *reader,
+                                const n_address_t *from) {
+    u32 token = n_read_u32(reader);
+    if (n_bitreader_overflowed(reader) || srv->info_packet_len == 0) return;
+
+    if (!n_server_info_query_allowed(srv->info_limits, from->ip, n_platform_time())) {
+        srv->stats.info_limited++;
+        return;
+    }
+
+    n_bitwriter_t writer;
+    n_bitwriter_init(&writer, srv->info_packet + srv->info_token_offset, 4);
+    n_write_u32(&writer, token);
+    n_transport_send(&srv->transport, from, srv->info_packet, srv->info_packet_len);
+    srv->stats.info_answered++;
+}
+
 // --- Handle incoming packets ---
 
 static void handle_connect_request(n_server_t *srv, const u8 *payload, u32 len,
@@ -319,6 +552,7 @@ static void handle_connect_request(n_server_t *srv, const u8 *payload, u32 len,
     n_bitreader_t reader;
     n_bitreader_init(&reader, payload, len);
     u32 client_challenge = n_read_u32(&reader);
+    u8 connect_flags = len >= 5 ? n_read_u8(&reader) : 0;
 
     // Check if already connecting from this address
     i32 existing = -1;
@@ -381,6 +615,7 @@ static void handle_connect_request(n_server_t *srv, const u8 *payload, u32 len,
     client->connect_start_time = n_platform_time();
     client->last_packet_recv_time = n_platform_time();
     client->is_loopback = is_loopback;
+    client->is_relay = (connect_flags & N_CONNECT_FLAG_RELAY) != 0;
 
     // Send challenge
     u8 resp[N_TRANSPORT_MTU];
@@ -423,59 +658,35 @@ static void handle_connect_response(n_server_t *srv, u32 slot,
     client->last_packet_recv_time = n_platform_time();
     srv->client_count++;
 
-    // Send CONNECT_ACCEPTED
-    u8 resp[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = client->outgoing_sequence++;
-    hdr.ack = client->incoming_sequence;
-    hdr.ack_bitfield = client->ack_bitfield;
-    n_packet_header_write(resp, &hdr);
-
+    // Queue CONNECT_ACCEPTED (goes out with the end-of-tick flush)
+    u8 accept[N_TRANSPORT_MTU];
     n_bitwriter_t writer;
-    n_bitwriter_init(&writer, resp + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
+    n_bitwriter_init(&writer, accept, sizeof(accept));
     u32 map_name_len = (u32)strlen(srv->map_name);
     if (map_name_len > 127) map_name_len = 127;
-    u16 accept_payload_len = (u16)(5 + 1 + map_name_len);
-    n_msg_header_write(&writer, N_MSG_CONNECT_ACCEPTED, accept_payload_len);
     n_write_u8(&writer, client->client_id);
     n_write_u32(&writer, srv->tick);
     n_write_u8(&writer, (u8)map_name_len);
     for (u32 mi = 0; mi < map_name_len; mi++) {
         n_write_u8(&writer, (u8)srv->map_name[mi]);
     }
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
-
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_server_send_to_client(srv, slot, resp, total);
+    n_msg_queue_push(&client->outgoing, N_MSG_CONNECT_ACCEPTED, N_MSG_PRIORITY_CONTROL,
+                     accept, (u16)n_bitwriter_bytes_written(&writer));
 }
 
-static void handle_input_message(n_server_t *srv, u32 slot,
-                                  const u8 *payload, u32 len) {
+void n_server_store_inputs(n_server_t *srv, u32 slot, u32 start_tick,
+                           const n_input_t *inputs, u32 count, u32 client_time_us) {
     n_client_slot_t *client = &srv->clients[slot];
     if (client->state != N_CONN_CONNECTED) return;
 
-    n_bitreader_t reader;
-    n_bitreader_init(&reader, payload, len);
-
-    u32 input_count = n_read_bits(&reader, 2) + 1; // 1..3 stored as 0..2
-    u32 start_tick = n_read_u32(&reader);
+    client->echo_time_us = client_time_us;
+    client->echo_recv_us = n_platform_time_us();
+    client->has_echo = true;
 
     N_DBG("input: slot=%u count=%u start_tick=%u srv_tick=%u",
-          slot, input_count, start_tick, srv->tick);
-
-    for (u32 i = 0; i < input_count; i++) {
-        n_input_t input = {
-            .forward_move = (i8)n_read_u8(&reader),
-            .side_move = (i8)n_read_u8(&reader),
-            .yaw = n_read_u16(&reader),
-            .pitch = n_read_u16(&reader),
-            .buttons = n_read_u16(&reader),
-            .weapon_select = n_read_u8(&reader),
-        };
-
-        if (n_bitreader_overflowed(&reader)) break;
+          slot, count, start_tick, srv->tick);
 
+    for (u32 i = 0; i < count; i++) {
         u32 input_tick = start_tick + i;
 
         // Discard if too old (already simulated)
@@ -492,43 +703,47 @@ static void handle_input_message(n_server_t *srv, u32 slot,
 
         // Store in ring buffer
         u32 idx = input_tick % N_INPUT_QUEUE_SIZE;
-        client->input_queue[idx] = input;
+        client->input_queue[idx] = inputs[i];
         if (input_tick > client->last_input_tick) {
             client->last_input_tick = input_tick;
         }
-        client->last_input = input;
+        client->last_input = inputs[i];
         srv->stats.inputs_received++;
     }
-}
 
-static void handle_clock_sync_message(n_server_t *srv, u32 slot,
-                                       const u8 *payload, u32 len) {
-    n_client_slot_t *client = &srv->clients[slot];
-    if (client->state != N_CONN_CONNECTED) return;
-    if (len < 8) return;
+    // Use the most recent input tick as implicit snapshot ack.
+    // The client sends inputs timestamped with server ticks it knows about,
+    // meaning it has received snapshots up to around that tick.
+    if (client->last_input_tick > client->last_acked_snapshot_tick) {
+        // Client must have tick - interp_buffer_ticks as baseline.
+        // Conservative: ack = last_input_tick - a few ticks.
+        u32 ack_tick = client->last_input_tick > N_INPUT_ACK_LAG
+                     ? client->last_input_tick - N_INPUT_ACK_LAG : 1;
+        if (ack_tick > client->last_acked_snapshot_tick) {
+            client->last_acked_snapshot_tick = ack_tick;
+        }
+    }
+}
 
+static void handle_input_message(n_server_t *srv, u32 slot,
+                                  const u8 *payload, u32 len) {
     n_bitreader_t reader;
     n_bitreader_init(&reader, payload, len);
-    f64 client_send_time = n_read_f64(&reader);
 
-    // Send response with server time
-    u8 resp[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = client->outgoing_sequence++;
-    hdr.ack = client->incoming_sequence;
-    hdr.ack_bitfield = client->ack_bitfield;
-    n_packet_header_write(resp, &hdr);
+    u32 input_count = n_read_bits(&reader, 2) + 1; // 1..3 stored as 0..2
+    u32 start_tick = n_read_u32(&reader);
+    u32 client_time_us = n_read_u32(&reader);
+    if (n_bitreader_overflowed(&reader)) return;
 
-    n_bitwriter_t writer;
-    n_bitwriter_init(&writer, resp + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-    n_msg_header_write(&writer, N_MSG_CLOCK_SYNC, 16);
-    n_write_f64(&writer, client_send_time);
-    n_write_f64(&writer, n_platform_time());
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
+    n_input_t inputs[4];
+    u32 count = 0;
+    for (u32 i = 0; i < input_count; i++) {
+        n_input_read(&reader, &inputs[count]);
+        if (n_bitreader_overflowed(&reader)) break;
+        count++;
+    }
 
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_server_send_to_client(srv, slot, resp, total);
+    n_server_store_inputs(srv, slot, start_tick, inputs, count, client_time_us);
 }
 
 static void handle_map_loaded_message(n_server_t *srv, u32 slot,
@@ -553,25 +768,19 @@ static void handle_map_loaded_message(n_server_t *srv, u32 slot,
     // Reset snapshot baseline so client gets a full snapshot first
     client->last_acked_snapshot_tick = 0;
 
-    N_DBG("map_loaded: slot=%u confirmed (hash=0x%08x)", slot, client_map_hash);
+    // Events from before the map confirm are not this client's business
+    client->event_ack = srv->tick;
 
-    // Send MAP_CONFIRMED with current server tick
-    u8 resp[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = client->outgoing_sequence++;
-    hdr.ack = client->incoming_sequence;
-    hdr.ack_bitfield = client->ack_bitfield;
-    n_packet_header_write(resp, &hdr);
+    N_DBG("map_loaded: slot=%u confirmed (hash=0x%08x)", slot, client_map_hash);
 
+    // Queue MAP_CONFIRMED with the current server tick; it leads the packet
+    // that carries the first full snapshot
+    u8 confirm[4];
     n_bitwriter_t writer;
-    n_bitwriter_init(&writer, resp + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-    n_msg_header_write(&writer, N_MSG_MAP_CONFIRMED, 4);
+    n_bitwriter_init(&writer, confirm, sizeof(confirm));
     n_write_u32(&writer, srv->tick);
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
-
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_server_send_to_client(srv, slot, resp, total);
+    n_msg_queue_push(&client->outgoing, N_MSG_MAP_CONFIRMED, N_MSG_PRIORITY_CONTROL,
+                     confirm, sizeof(confirm));
 }
 
 static void handle_disconnect_message(n_server_t *srv, u32 slot) {
@@ -590,6 +799,17 @@ void n_server_process_packet(n_server_t *srv, u8 *data, u32 len,
 
     bool is_loopback = (via != &srv->transport);
 
+    // Server browser queries are answered before any client lookup
+    if (!is_loopback) {
+        n_bitreader_t peek;
+        n_bitreader_init(&peek, data + N_PACKET_HEADER_SIZE, len - N_PACKET_HEADER_SIZE);
+        n_msg_header_t msg;
+        if (n_msg_header_read(&peek, &msg) && msg.type == N_MSG_INFO_REQUEST) {
+            handle_info_request(srv, &peek, from);
+            return;
+        }
+    }
+
     // Find which client slot this packet belongs to
     i32 slot = -1;
     if (is_loopback) {
@@ -671,38 +891,33 @@ void n_server_process_packet(n_server_t *srv, u8 *data, u32 len,
                     payload_buf[b] = n_read_u8(&reader);
                 }
                 handle_input_message(srv, (u32)slot, payload_buf, payload_bytes);
-
-                // Use the most recent input tick as implicit snapshot ack.
-                // The client sends inputs timestamped with server ticks it knows about,
-                // meaning it has received snapshots up to around that tick.
-                if (client->last_input_tick > client->last_acked_snapshot_tick) {
-                    // Client must have tick - interp_buffer_ticks as baseline.
-                    // Conservative: ack = last_input_tick - a few ticks.
-                    u32 ack_tick = client->last_input_tick > 4 ? client->last_input_tick - 4 : 1;
-                    if (ack_tick > client->last_acked_snapshot_tick) {
-                        client->last_acked_snapshot_tick = ack_tick;
-                    }
-                }
                 break;
             }
 
-            case N_MSG_CLOCK_SYNC: {
+            case N_MSG_MAP_LOADED: {
                 u8 payload_buf[64];
                 u32 payload_bytes = msg.length < 64 ? msg.length : 64;
                 for (u32 b = 0; b < payload_bytes; b++) {
                     payload_buf[b] = n_read_u8(&reader);
                 }
-                handle_clock_sync_message(srv, (u32)slot, payload_buf, payload_bytes);
+                handle_map_loaded_message(srv, (u32)slot, payload_buf, payload_bytes);
                 break;
             }
 
-            case N_MSG_MAP_LOADED: {
-                u8 payload_buf[64];
-                u32 payload_bytes = msg.length < 64 ? msg.length : 64;
-                for (u32 b = 0; b < payload_bytes; b++) {
-                    payload_buf[b] = n_read_u8(&reader);
+            case N_MSG_EVENT_ACK: {
+                u32 ack_tick = 0;
+                u32 b = 0;
+                if (msg.length >= 4) {
+                    ack_tick = n_read_u32(&reader);
+                    b = 4;
+                }
+                for (; b < msg.length; b++) {
+                    n_read_u8(&reader);
+                }
+                // Only forward; an ack past the current tick is bogus
+                if (ack_tick > client->event_ack && ack_tick <= srv->tick) {
+                    client->event_ack = ack_tick;
                 }
-                handle_map_loaded_message(srv, (u32)slot, payload_buf, payload_bytes);
                 break;
             }
 
@@ -735,6 +950,8 @@ void n_server_tick(n_server_t *srv, f64 now) {
 
     // Receive packets from UDP
     if (srv->server_port > 0) {
+        refresh_info_packet(srv);
+
         u8 recv_buf[N_TRANSPORT_MTU];
         n_address_t from;
         i32 recv_len;
@@ -21,7 +21,10 @@
 // --- Global instances (heap-allocated to avoid MB-scale BSS) ---
 
 static n_server_t *s_server;
+static bool        s_server_in_arena;   // not freed on shutdown
 static n_client_t *s_client;
+static n_relay_t  *s_relay;
+static n_query_t   s_query;
 
 // --- Server API ---
 
@@ -30,6 +33,10 @@ qk_result_t qk_net_server_init(const qk_net_server_config_t *config) {
 
     n_platform_init();
 
+    if (!s_server && config->arena) {
+        s_server = (n_server_t *)qk_arena_alloc_aligned(config->arena, sizeof(n_server_t), 64);
+        s_server_in_arena = s_server != NULL;
+    }
     if (!s_server) {
         s_server = (n_server_t *)calloc(1, sizeof(n_server_t));
         if (!s_server) return QK_ERROR_INIT_FAILED;
@@ -59,8 +66,9 @@ void qk_net_server_tick(void) {
 void qk_net_server_shutdown(void) {
     if (!s_server) return;
     n_server_shutdown(s_server);
-    free(s_server);
+    if (!s_server_in_arena) free(s_server);
     s_server = NULL;
+    s_server_in_arena = false;
 }
 
 u32 qk_net_server_get_tick(void) {
@@ -81,12 +89,20 @@ void qk_net_server_remove_entity(u8 entity_id) {
     n_snapshot_remove_entity(&s_server->current_snapshot, entity_id);
 }
 
+void qk_net_server_push_events(const n_game_event_t *events, u32 count) {
+    if (!events || !s_server) return;
+    for (u32 i = 0; i < count; i++) {
+        n_server_push_event(s_server, &events[i]);
+    }
+}
+
 bool qk_net_server_get_input(u8 client_id, qk_usercmd_t *out_cmd) {
     if (!out_cmd || !s_server) return false;
     if (client_id >= s_server->max_clients) return false;
 
     n_client_slot_t *client = &s_server->clients[client_id];
     if (client->state != N_CONN_CONNECTED) return false;
+    if (client->is_relay) return false;    // keepalive inputs only
 
     // Get input for current server tick
     u32 tick = s_server->tick;
@@ -96,9 +112,26 @@ bool qk_net_server_get_input(u8 client_id, qk_usercmd_t *out_cmd) {
     // Check if we have a valid input for this tick
     bool have_input = (client->last_input_tick >= tick);
 
-    // If no input available, repeat last known input
+    // Buffer depth: how many ticks of input were queued past this one
+    // (negative = starved). Reported to the client with the next snapshot.
+    if (client->last_input_tick > 0) {
+        i32 depth = (i32)(client->last_input_tick - tick);
+        if (depth < -127) depth = -127;
+        if (depth > 127) depth = 127;
+        if (!client->input_depth_valid || depth < client->input_depth_min) {
+            client->input_depth_min = (i8)depth;
+            client->input_depth_valid = true;
+        }
+    }
+
+    // If no input available, repeat last known input. Held buttons carry
+    // over; press edges happened once and must not fire again.
+    n_input_t repeated;
     if (!have_input) {
-        input = &client->last_input;
+        repeated = client->last_input;
+        repeated.attack_subtick = QK_SUBTICK_NONE;
+        repeated.jump_subtick = QK_SUBTICK_NONE;
+        input = &repeated;
     }
 
     // Convert n_input_t to qk_usercmd_t
@@ -111,6 +144,10 @@ bool qk_net_server_get_input(u8 client_id, qk_usercmd_t *out_cmd) {
         .pitch = (f32)input->pitch * (360.0f / 65536.0f),
         .buttons = input->buttons,
         .weapon_select = input->weapon_select,
+        .attack_subtick = input->attack_subtick,
+        .jump_subtick = input->jump_subtick,
+        .attack_yaw = (f32)input->attack_yaw * (360.0f / 65536.0f),
+        .attack_pitch = (f32)input->attack_pitch * (360.0f / 65536.0f),
     };
 
     return true;
@@ -129,6 +166,30 @@ bool qk_net_server_is_client_map_ready(u8 client_id) {
     return client->state == N_CONN_CONNECTED && client->map_ready;
 }
 
+bool qk_net_server_is_client_relay(u8 client_id) {
+    if (!s_server) return false;
+    if (client_id >= s_server->max_clients) return false;
+    n_client_slot_t *client = &s_server->clients[client_id];
+    return client->state != N_CONN_DISCONNECTED && client->is_relay;
+}
+
+bool qk_net_server_is_client_player(u8 client_id) {
+    // Relays send MAP_LOADED too, so map_ready alone is not enough
+    return qk_net_server_is_client_map_ready(client_id) &&
+           !qk_net_server_is_client_relay(client_id);
+}
+
+void qk_net_server_set_client_low_priority(u8 client_id, bool low_priority) {
+    if (!s_server) return;
+    if (client_id >= s_server->max_clients) return;
+    s_server->clients[client_id].low_priority = low_priority;
+}
+
+void qk_net_server_set_low_priority_interval(u32 interval) {
+    if (!s_server) return;
+    s_server->low_priority_interval = interval;
+}
+
 // --- Client API ---
 
 qk_result_t qk_net_client_init(const qk_net_client_config_t *config) {
@@ -142,7 +203,8 @@ qk_result_t qk_net_client_init(const qk_net_client_config_t *config) {
     }
 
     f64 interp_delay = config->interp_delay;
-    n_client_init(s_client, interp_delay);
+    n_client_init(s_client, interp_delay, config->extrap_limit);
+    s_client->local_direct = config->local_direct;
 
     if (!s_client->initialized) {
         return QK_ERROR_INIT_FAILED;
@@ -194,6 +256,12 @@ void qk_net_client_interpolate(f64 render_time) {
     n_client_interpolate(s_client, render_time);
 }
 
+void qk_net_client_set_extrap_trace(qk_net_extrap_trace_fn fn, void *user) {
+    if (!s_client) return;
+    s_client->extrap_trace = fn;
+    s_client->extrap_trace_user = user;
+}
+
 void qk_net_client_shutdown(void) {
     if (!s_client) return;
     n_client_shutdown(s_client);
@@ -212,6 +280,10 @@ void qk_net_client_send_input(const qk_usercmd_t *cmd) {
         .pitch = (u16)(cmd->pitch * (65536.0f / 360.0f)),
         .buttons = (u16)cmd->buttons,
         .weapon_select = cmd->weapon_select,
+        .attack_subtick = cmd->attack_subtick,
+        .jump_subtick = cmd->jump_subtick,
+        .attack_yaw = (u16)(cmd->attack_yaw * (65536.0f / 360.0f)),
+        .attack_pitch = (u16)(cmd->attack_pitch * (65536.0f / 360.0f)),
     };
 
     n_client_send_input(s_client, &input, n_platform_time());
@@ -230,6 +302,11 @@ const qk_interp_diag_t *qk_net_client_get_interp_diag(void) {
     return s_client ? &s_client->interp_diag : NULL;
 }
 
+u32 qk_net_client_poll_events(n_game_event_t *out_events, u32 max_events) {
+    if (!out_events || !s_client) return 0;
+    return n_client_poll_events(s_client, out_events, max_events);
+}
+
 qk_conn_state_t qk_net_client_get_state(void) {
     return s_client ? (qk_conn_state_t)s_client->conn_state : QK_CONN_DISCONNECTED;
 }
@@ -238,6 +315,15 @@ i32 qk_net_client_get_rtt(void) {
     return s_client ? (i32)(s_client->clock.smoothed_rtt * 1000.0) : 0;
 }
 
+bool qk_net_client_is_clock_converged(void) {
+    return s_client ? s_client->clock.converged : false;
+}
+
+i32 qk_net_client_get_min_rtt_us(void) {
+    if (!s_client || s_client->clock.min_rtt_us == N_CLOCK_RTT_UNKNOWN) return -1;
+    return (i32)s_client->clock.min_rtt_us;
+}
+
 u8 qk_net_client_get_id(void) {
     return s_client ? s_client->client_id : 0;
 }
@@ -250,6 +336,15 @@ u32 qk_net_client_get_server_cmd_ack(void) {
     return s_client ? s_client->last_server_cmd_ack : 0;
 }
 
+f32 qk_net_client_get_time_scale(void) {
+    if (!s_client || s_client->conn_state != N_CONN_CONNECTED) return 1.0f;
+    return s_client->time_scale;
+}
+
+f32 qk_net_client_get_input_depth(void) {
+    return (s_client && s_client->has_input_depth) ? s_client->input_depth : 0.0f;
+}
+
 void qk_net_client_inject_demo_snapshot(u32 tick, u32 entity_count,
                                          const u64 *entity_mask,
                                          const n_entity_state_t *entities) {
@@ -371,24 +466,7 @@ void qk_net_client_notify_map_loaded(const char *map_name) {
 
     // Remote: send N_MSG_MAP_LOADED to server
     u32 map_hash = n_hash_map_name(map_name);
-
-    u8 pkt[N_TRANSPORT_MTU];
-    n_packet_header_t hdr = {0};
-    hdr.sequence = s_client->outgoing_sequence++;
-    hdr.ack = s_client->incoming_sequence;
-    hdr.ack_bitfield = s_client->ack_bitfield;
-    n_packet_header_write(pkt, &hdr);
-
-    n_bitwriter_t writer;
-    n_bitwriter_init(&writer, pkt + N_PACKET_HEADER_SIZE,
-                     N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE);
-    n_msg_header_write(&writer, N_MSG_MAP_LOADED, 4);
-    n_write_u32(&writer, map_hash);
-    n_msg_header_write(&writer, N_MSG_NOP, 0);
-
-    u32 total = N_PACKET_HEADER_SIZE + n_bitwriter_bytes_written(&writer);
-    n_transport_send(&s_client->transport, &s_client->server_address, pkt, total);
-    s_client->stats.packets_sent++;
+    n_client_send_map_loaded(s_client, map_hash);
 
     N_DBG("map_loaded: sent hash=0x%08x (map=%s)", map_hash, map_name ? map_name : "NULL");
 }
@@ -427,3 +505,86 @@ const char *qk_net_client_get_server_map(void) {
     if (s_client->server_map_name[0] == '\0') return NULL;
     return s_client->server_map_name;
 }
+
+// --- Relay API ---
+
+qk_result_t qk_net_relay_init(const qk_net_relay_config_t *config) {
+    if (!config || config->listen_port == 0) return QK_ERROR_INVALID_PARAM;
+
+    if (!s_relay) {
+        s_relay = (n_relay_t *)calloc(1, sizeof(n_relay_t));
+        if (!s_relay) return QK_ERROR_INIT_FAILED;
+    }
+
+    if (!n_relay_init(s_relay, config->listen_port, config->max_viewers, config->delay)) {
+        return QK_ERROR_SOCKET;
+    }
+
+    return QK_SUCCESS;
+}
+
+qk_result_t qk_net_relay_connect(const char *address, u16 port) {
+    if (!address || port == 0) return QK_ERROR_INVALID_PARAM;
+    if (!s_relay || !s_relay->initialized) return QK_ERROR_INIT_FAILED;
+
+    n_relay_connect(s_relay, address, port);
+
+    if (s_relay->upstream.conn_state == N_CONN_DISCONNECTED) {
+        return QK_ERROR_SOCKET;
+    }
+
+    return QK_SUCCESS;
+}
+
+void qk_net_relay_tick(void) {
+    if (!s_relay) return;
+    n_relay_tick(s_relay, n_platform_time());
+}
+
+void qk_net_relay_shutdown(void) {
+    if (!s_relay) return;
+    n_relay_shutdown(s_relay);
+    free(s_relay);
+    s_relay = NULL;
+}
+
+qk_conn_state_t qk_net_relay_get_upstream_state(void) {
+    return s_relay ? (qk_conn_state_t)s_relay->upstream.conn_state : QK_CONN_DISCONNECTED;
+}
+
+void qk_net_relay_get_stats(qk_net_relay_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!s_relay) return;
+
+    out->viewer_count = s_relay->viewer_count;
+    out->upstream_tick = s_relay->captured_tick;
+    out->broadcast_tick = s_relay->tick;
+    out->queued = s_relay->queue_count;
+    out->encodes = s_relay->encodes_done;
+    out->encodes_shared = s_relay->encodes_shared;
+    out->packets_sent = s_relay->stats.packets_sent;
+    out->bytes_sent = s_relay->stats.bytes_sent;
+}
+
+// --- Server query API ---
+
+qk_result_t qk_net_query_open(const char *address, u16 port) {
+    if (!address || port == 0) return QK_ERROR_INVALID_PARAM;
+    n_query_close(&s_query);
+    if (!n_query_open(&s_query, address, port)) return QK_ERROR_SOCKET;
+    return QK_SUCCESS;
+}
+
+bool qk_net_query_send(void) {
+    return n_query_send(&s_query);
+}
+
+bool qk_net_query_poll(qk_net_server_info_t *out_info) {
+    if (!out_info) return false;
+    return n_query_poll(&s_query, out_info);
+}
+
+void qk_net_query_close(void) {
+    n_query_close(&s_query);
+}
@@ -15,6 +15,7 @@
 struct qk_phys_world {
     qk_collision_model_t *cm;
     bool owns_cm; // true = world frees cm on destroy (test room), false = caller manages cm
+    bool in_arena; // world and its packed cm live in a caller's arena; destroy is a no-op
 };
 
 // --- Internal constants ---
@@ -81,6 +82,7 @@ vec3_t  p_calc_launch_velocity(vec3_t start, vec3_t target, f32 gravity);
 // --- p_world.c ---
 
 qk_phys_world_t *p_world_create(qk_collision_model_t *cm);
+qk_phys_world_t *p_world_create_in(qk_collision_model_t *cm, qk_arena_t *arena);
 void              p_world_destroy(qk_phys_world_t *world);
 
 // --- p_time.c ---
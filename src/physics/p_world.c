@@ -7,6 +7,7 @@
 
 #include "p_internal.h"
 #include <stdlib.h>
+#include <string.h>
 
 // --- Create physics world from collision model ---
 
@@ -18,6 +19,7 @@ qk_phys_world_t *p_world_create(qk_collision_model_t *cm) {
 
     world->cm = cm;
     world->owns_cm = false; // caller manages collision model lifetime
+    world->in_arena = false;
 
     // For each brush: compute AABB, then add bevel planes for correct
     // box tracing against raw .map geometry (no BSP compiler bevels).
@@ -29,10 +31,63 @@ qk_phys_world_t *p_world_create(qk_collision_model_t *cm) {
     return world;
 }
 
+// --- Create physics world packed into an arena ---
+
+/*
+ * Builds the world from cm (bevels are added to cm itself, as above), then
+ * copies the model into the arena: brushes in one array, every brush's
+ * planes back to back after it, in brush order. A trace walks one
+ * contiguous block instead of a malloc per brush, and an arena with
+ * QK_ARENA_HUGE_PAGES puts that block on a few TLB entries. The caller
+ * still owns cm and may free it once this returns.
+ */
+qk_phys_world_t *p_world_create_in(qk_collision_model_t *cm, qk_arena_t *arena) {
+    if (!cm || !arena) return NULL;
+
+    for (u32 i = 0; i < cm->brush_count; i++) {
+        p_brush_compute_aabb(&cm->brushes[i]);
+        p_brush_add_bevels(&cm->brushes[i]);
+    }
+
+    u64 plane_total = 0;
+    for (u32 i = 0; i < cm->brush_count; i++) {
+        plane_total += cm->brushes[i].plane_count;
+    }
+
+    qk_arena_marker_t mark = qk_arena_mark(arena);
+    qk_phys_world_t *world = (qk_phys_world_t *)qk_arena_alloc(arena, sizeof(qk_phys_world_t));
+    qk_collision_model_t *packed = (qk_collision_model_t *)qk_arena_alloc(
+        arena, sizeof(qk_collision_model_t));
+    qk_brush_t *brushes = (qk_brush_t *)qk_arena_alloc_aligned(
+        arena, (u64)cm->brush_count * sizeof(qk_brush_t), 64);
+    qk_plane_t *planes = (qk_plane_t *)qk_arena_alloc(arena, plane_total * sizeof(qk_plane_t));
+    if (!world || !packed || (cm->brush_count && !brushes) || (plane_total && !planes)) {
+        qk_arena_pop(arena, mark);
+        return NULL;
+    }
+
+    qk_plane_t *next = planes;
+    for (u32 i = 0; i < cm->brush_count; i++) {
+        const qk_brush_t *src = &cm->brushes[i];
+        brushes[i] = *src;
+        brushes[i].planes = next;
+        memcpy(next, src->planes, src->plane_count * sizeof(qk_plane_t));
+        next += src->plane_count;
+    }
+
+    packed->brushes = brushes;
+    packed->brush_count = cm->brush_count;
+
+    world->cm = packed;
+    world->owns_cm = false;
+    world->in_arena = true;
+    return world;
+}
+
 // --- Destroy physics world ---
 
 void p_world_destroy(qk_phys_world_t *world) {
-    if (!world) return;
+    if (!world || world->in_arena) return;
     if (world->owns_cm && world->cm) {
         for (u32 i = 0; i < world->cm->brush_count; i++) {
             free(world->cm->brushes[i].planes);
@@ -15,6 +15,10 @@ qk_phys_world_t *qk_physics_world_create(qk_collision_model_t *cm) {
     return p_world_create(cm);
 }
 
+qk_phys_world_t *qk_physics_world_create_in(qk_collision_model_t *cm, qk_arena_t *arena) {
+    return p_world_create_in(cm, arena);
+}
+
 void qk_physics_world_destroy(qk_phys_world_t *world) {
     p_world_destroy(world);
 }
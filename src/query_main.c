@@ -0,0 +1,93 @@
+/*
+ * QUICKEN Engine - Server Query Tool
+ *
+ * Sends connectionless info queries to a server, like a server browser
+ * would, and prints each reply with its ping. No slot is taken on the
+ * server. A short -interval shows the per-source rate limit at work.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "quicken.h"
+#include "qk_types.h"
+#include "core/qk_platform.h"
+#include "netcode/qk_netcode.h"
+
+static const f64 QUERY_TIMEOUT_SEC = 1.0;   // wait after the last send
+
+int main(int argc, char *argv[]) {
+    const char *server_address = "127.0.0.1";
+    u16 server_port = 27960;
+    u32 count = 1;
+    f64 interval = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-server") == 0 && i + 1 < argc) {
+            server_address = argv[++i];
+        } else if (strcmp(argv[i], "-port") == 0 && i + 1 < argc) {
+            server_port = (u16)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-count") == 0 && i + 1 < argc) {
+            count = (u32)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-interval") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: quicken-query [-server 127.0.0.1] [-port %u] "
+                            "[-count 1] [-interval <seconds>]\n", 27960);
+            return 1;
+        }
+    }
+    if (count == 0) count = 1;
+
+    qk_result_t res = qk_net_query_open(server_address, server_port);
+    if (res != QK_SUCCESS) {
+        fprintf(stderr, "FATAL: Bad server address %s:%u (%d)\n",
+                server_address, (u32)server_port, res);
+        return 1;
+    }
+
+    u32 sent = 0;
+    u32 received = 0;
+    u32 ping_min = 0xFFFFFFFFu;
+    u32 ping_max = 0;
+    u64 ping_sum = 0;
+    f64 next_send = qk_platform_time_now();
+    f64 deadline = next_send;
+
+    while (sent < count || qk_platform_time_now() < deadline) {
+        f64 now = qk_platform_time_now();
+        if (sent < count && now >= next_send) {
+            qk_net_query_send();
+            sent++;
+            next_send = now + interval;
+            deadline = now + QUERY_TIMEOUT_SEC;
+        }
+
+        qk_net_server_info_t info;
+        while (qk_net_query_poll(&info)) {
+            printf("%s:%u  map %s  players %u/%u  spectators %u  %u Hz  ping %.2f ms\n",
+                   server_address, (u32)server_port,
+                   info.map_name[0] ? info.map_name : "-",
+                   (u32)info.players, (u32)info.max_clients, (u32)info.spectators,
+                   (u32)info.tick_rate, (f64)info.ping_us / 1000.0);
+            received++;
+            ping_sum += info.ping_us;
+            if (info.ping_us < ping_min) ping_min = info.ping_us;
+            if (info.ping_us > ping_max) ping_max = info.ping_us;
+        }
+
+        qk_platform_sleep(1);
+    }
+
+    qk_net_query_close();
+
+    printf("\n%u sent, %u answered", sent, received);
+    if (received > 0) {
+        printf(", ping min/avg/max %.2f/%.2f/%.2f ms",
+               (f64)ping_min / 1000.0, (f64)ping_sum / received / 1000.0,
+               (f64)ping_max / 1000.0);
+    }
+    printf("\n");
+    return received > 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*
+ * QUICKEN Engine - Spectator Relay Entry Point
+ *
+ * Headless mode: no window, no renderer, no simulation.
+ * Connects to a game server as a spectator relay and re-broadcasts its
+ * snapshot stream, optionally delayed, to viewers running the normal client.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include "quicken.h"
+#include "qk_types.h"
+#include "core/qk_platform.h"
+#include "netcode/qk_netcode.h"
+
+static const f64 RELAY_RECONNECT_SEC = 5.0;
+static const f64 RELAY_STATUS_SEC    = 10.0;
+
+// --- Shutdown signal ---
+
+static volatile int s_running = 1;
+
+#ifdef QK_PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+static BOOL WINAPI console_handler(DWORD type) {
+    QK_UNUSED(type);
+    s_running = 0;
+    return TRUE;
+}
+#else
+static void signal_handler(int sig) {
+    QK_UNUSED(sig);
+    s_running = 0;
+}
+#endif
+
+// --- Main ---
+
+int main(int argc, char *argv[]) {
+    printf("QUICKEN Spectator Relay v%d.%d.%d\n",
+           QUICKEN_VERSION_MAJOR, QUICKEN_VERSION_MINOR, QUICKEN_VERSION_PATCH);
+
+    // --- Parse arguments ---
+    const char *server_address = NULL;
+    u16 server_port = 27960;
+    u16 port = 27970;
+    u32 max_viewers = 0;
+    f64 delay = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-server") == 0 && i + 1 < argc) {
+            server_address = argv[++i];
+        } else if (strcmp(argv[i], "-serverport") == 0 && i + 1 < argc) {
+            server_port = (u16)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-port") == 0 && i + 1 < argc) {
+            port = (u16)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-maxviewers") == 0 && i + 1 < argc) {
+            max_viewers = (u32)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-delay") == 0 && i + 1 < argc) {
+            delay = atof(argv[++i]);
+        }
+    }
+
+    if (!server_address) {
+        fprintf(stderr, "Usage: quicken-relay -server <ip> [-serverport %u] [-port %u] "
+                        "[-maxviewers 256] [-delay <seconds>]\n", 27960, 27970);
+        return 1;
+    }
+
+    // --- Install signal handler ---
+#ifdef QK_PLATFORM_WINDOWS
+    SetConsoleCtrlHandler(console_handler, TRUE);
+#else
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+#endif
+
+    // --- Init relay ---
+    qk_net_relay_config_t rc = {
+        .listen_port = port,
+        .max_viewers = max_viewers,
+        .delay = delay,
+    };
+
+    qk_result_t res = qk_net_relay_init(&rc);
+    if (res != QK_SUCCESS) {
+        fprintf(stderr, "FATAL: Failed to init relay on port %u (%d)\n", (u32)port, res);
+        qk_net_relay_shutdown();
+        return 1;
+    }
+
+    res = qk_net_relay_connect(server_address, server_port);
+    if (res != QK_SUCCESS) {
+        fprintf(stderr, "FATAL: Bad server address %s:%u (%d)\n",
+                server_address, (u32)server_port, res);
+        qk_net_relay_shutdown();
+        return 1;
+    }
+
+    printf("Relaying %s:%u on port %u (delay %.1fs)\n",
+           server_address, (u32)server_port, (u32)port, delay);
+    printf("\nRelay running. Press Ctrl+C to stop.\n\n");
+
+    // --- Relay loop ---
+    f64 last_connect_time = qk_platform_time_now();
+    f64 last_status_time = last_connect_time;
+    qk_conn_state_t prev_state = QK_CONN_CONNECTING;
+
+    while (s_running) {
+        qk_net_relay_tick();
+
+        f64 now = qk_platform_time_now();
+        qk_conn_state_t state = qk_net_relay_get_upstream_state();
+
+        if (state != prev_state) {
+            if (state == QK_CONN_CONNECTED) {
+                printf("Upstream connected.\n");
+            } else if (state == QK_CONN_DISCONNECTED) {
+                printf("Upstream lost, retrying in %.0fs.\n", RELAY_RECONNECT_SEC);
+            }
+            prev_state = state;
+        }
+
+        if (state == QK_CONN_DISCONNECTED &&
+            now - last_connect_time >= RELAY_RECONNECT_SEC) {
+            qk_net_relay_connect(server_address, server_port);
+            last_connect_time = now;
+        }
+
+        if (now - last_status_time >= RELAY_STATUS_SEC) {
+            qk_net_relay_stats_t stats;
+            qk_net_relay_get_stats(&stats);
+            printf("viewers=%u tick=%u/%u queued=%u encodes=%llu shared=%llu "
+                   "sent=%llu KB\n",
+                   stats.viewer_count, stats.broadcast_tick, stats.upstream_tick,
+                   stats.queued, (unsigned long long)stats.encodes,
+                   (unsigned long long)stats.encodes_shared,
+                   (unsigned long long)(stats.bytes_sent / 1024));
+            last_status_time = now;
+        }
+
+        // Snapshots arrive at the tick rate; 1 ms keeps added latency negligible
+        qk_platform_sleep(1);
+    }
+
+    printf("\nShutting down...\n");
+    qk_net_relay_shutdown();
+
+    printf("Clean shutdown.\n");
+    return 0;
+}
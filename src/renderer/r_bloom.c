@@ -170,7 +170,7 @@ static qk_result_t create_bloom_render_passes(void)
     return QK_SUCCESS;
 }
 
-static qk_result_t create_bloom_pipelines(void)
+qk_result_t r_bloom_create_pipelines(void)
 {
     VkShaderModule vert = r_pipeline_load_shader("src/renderer/shaders/compiled/compose.vert.spv");
     VkShaderModule down_frag = r_pipeline_load_shader("src/renderer/shaders/compiled/bloom_downsample.frag.spv");
@@ -470,10 +470,7 @@ qk_result_t r_bloom_init(void)
         vkUpdateDescriptorSets(g_r.device.handle, 1, &write, 0, NULL);
     }
 
-    // Pipelines
-    res = create_bloom_pipelines();
-    if (res != QK_SUCCESS) return res;
-
+    // Pipelines are built by r_pipeline_warmup
     g_r.bloom.initialized = true;
     return QK_SUCCESS;
 }
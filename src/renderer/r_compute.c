@@ -1,14 +1,19 @@
 /*
- * QUICKEN Renderer - Forward+ Compute (Light Culling, SSBOs, Depth Pre-Pass)
+ * QUICKEN Renderer - Clustered Forward+ (Light Assignment, SSBOs, Depth Pre-Pass)
  *
- * Per-tile light culling via compute shader. SSBOs for light data and
- * per-tile light index lists. Depth pre-pass to feed the cull shader.
+ * Per-cluster light assignment via compute shader over a 3D grid of screen
+ * tiles and exponential depth slices. SSBOs for light data and per-cluster
+ * light index lists. Depth pre-pass for zero-overdraw world shading.
+ *
+ * r_compute_init creates resources only; the pre-pass and cull pipelines
+ * are built by r_pipeline_warmup alongside every other pipeline.
  */
 
 #include "r_types.h"
 #include "renderer/qk_renderer.h"
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 // --- Light submission (public API) ---
 
@@ -96,116 +101,22 @@ static qk_result_t depth_prepass_init(void)
                               &g_r.depth_prepass.framebuffer);
     if (vr != VK_SUCCESS) return QK_ERROR_OUT_OF_MEMORY;
 
-    // Depth pre-pass pipeline: same vertex input as world, no fragment shader
-    VkShaderModule vert = r_pipeline_load_shader("src/renderer/shaders/compiled/world.vert.spv");
-    if (!vert) return QK_ERROR_PIPELINE;
-
-    VkPipelineShaderStageCreateInfo stage = {
-        .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-        .stage  = VK_SHADER_STAGE_VERTEX_BIT,
-        .module = vert,
-        .pName  = "main"
-    };
-
-    VkVertexInputBindingDescription binding = {
-        .binding   = 0,
-        .stride    = sizeof(r_world_vertex_t),
-        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-    };
-    VkVertexInputAttributeDescription attrs[] = {
-        { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT,
-          .offset = offsetof(r_world_vertex_t, position) },
-        { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT,
-          .offset = offsetof(r_world_vertex_t, normal) },
-        { .location = 2, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT,
-          .offset = offsetof(r_world_vertex_t, uv) },
-        { .location = 3, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT,
-          .offset = offsetof(r_world_vertex_t, lm_uv) },
-        { .location = 4, .binding = 0, .format = VK_FORMAT_R32_UINT,
-          .offset = offsetof(r_world_vertex_t, texture_id) }
-    };
-    VkPipelineVertexInputStateCreateInfo vertex_input = {
-        .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount   = 1,
-        .pVertexBindingDescriptions      = &binding,
-        .vertexAttributeDescriptionCount = 5,
-        .pVertexAttributeDescriptions    = attrs
-    };
-    VkPipelineInputAssemblyStateCreateInfo input_assembly = {
-        .sType    = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
-    };
-    VkPipelineViewportStateCreateInfo viewport_state = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-        .viewportCount = 1, .scissorCount = 1
-    };
-    VkPipelineRasterizationStateCreateInfo rasterizer = {
-        .sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-        .polygonMode = VK_POLYGON_MODE_FILL,
-        .cullMode    = VK_CULL_MODE_BACK_BIT,
-        .frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE,
-        .lineWidth   = 1.0f
-    };
-    VkPipelineMultisampleStateCreateInfo multisample = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
-    };
-    VkPipelineDepthStencilStateCreateInfo depth_stencil = {
-        .sType            = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-        .depthTestEnable  = VK_TRUE,
-        .depthWriteEnable = VK_TRUE,
-        .depthCompareOp   = VK_COMPARE_OP_LESS
-    };
-    VkPipelineColorBlendStateCreateInfo color_blend = {
-        .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-        .attachmentCount = 0
-    };
-    VkDynamicState dyn_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-    VkPipelineDynamicStateCreateInfo dynamic_state = {
-        .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount = 2,
-        .pDynamicStates    = dyn_states
-    };
-
-    // Layout: only needs view UBO (set 0) for the VP matrix
-    VkPipelineLayoutCreateInfo layout_info = {
-        .sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = 1,
-        .pSetLayouts    = &g_r.view_set_layout
-    };
-    vkCreatePipelineLayout(g_r.device.handle, &layout_info, NULL,
-                           &g_r.depth_prepass.pipeline.layout);
-
-    VkGraphicsPipelineCreateInfo pipeline_info = {
-        .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .stageCount          = 1,
-        .pStages             = &stage,
-        .pVertexInputState   = &vertex_input,
-        .pInputAssemblyState = &input_assembly,
-        .pViewportState      = &viewport_state,
-        .pRasterizationState = &rasterizer,
-        .pMultisampleState   = &multisample,
-        .pDepthStencilState  = &depth_stencil,
-        .pColorBlendState    = &color_blend,
-        .pDynamicState       = &dynamic_state,
-        .layout              = g_r.depth_prepass.pipeline.layout,
-        .renderPass          = g_r.depth_prepass.render_pass,
-        .subpass             = 0
-    };
-
-    vr = vkCreateGraphicsPipelines(g_r.device.handle, g_r.pipeline_cache_handle,
-                                    1, &pipeline_info, NULL,
-                                    &g_r.depth_prepass.pipeline.handle);
-    vkDestroyShaderModule(g_r.device.handle, vert, NULL);
-
-    if (vr != VK_SUCCESS) return QK_ERROR_PIPELINE;
-
     g_r.depth_prepass.initialized = true;
     return QK_SUCCESS;
 }
 
 // --- SSBO Setup ---
 
+static u32 cluster_total_count(void)
+{
+    return g_r.lights.cluster_count_x * g_r.lights.cluster_count_y * R_CLUSTER_SLICES;
+}
+
+static VkDeviceSize cluster_buffer_size(void)
+{
+    return (VkDeviceSize)cluster_total_count() * (R_MAX_LIGHTS_PER_CLUSTER + 1) * sizeof(u32);
+}
+
 static qk_result_t ssbo_init(void)
 {
     // Light SSBO (host-visible, persistently mapped)
@@ -221,46 +132,36 @@ static qk_result_t ssbo_init(void)
     vkMapMemory(g_r.device.handle, g_r.lights.light_memory, 0, light_size, 0,
                 &g_r.lights.light_mapped);
 
-    // Tile SSBO (device-local)
-    u32 tile_x = (g_r.config.render_width + R_TILE_SIZE - 1) / R_TILE_SIZE;
-    u32 tile_y = (g_r.config.render_height + R_TILE_SIZE - 1) / R_TILE_SIZE;
-    g_r.lights.tile_count_x = tile_x;
-    g_r.lights.tile_count_y = tile_y;
+    // Cluster SSBO (device-local)
+    g_r.lights.cluster_count_x = (g_r.config.render_width + R_CLUSTER_TILE_SIZE - 1) / R_CLUSTER_TILE_SIZE;
+    g_r.lights.cluster_count_y = (g_r.config.render_height + R_CLUSTER_TILE_SIZE - 1) / R_CLUSTER_TILE_SIZE;
 
-    VkDeviceSize tile_size = (VkDeviceSize)tile_x * tile_y * (R_MAX_LIGHTS_PER_TILE + 1) * sizeof(u32);
     res = r_memory_create_buffer(
-        tile_size,
+        cluster_buffer_size(),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        &g_r.lights.tile_ssbo, &g_r.lights.tile_memory);
+        &g_r.lights.cluster_ssbo, &g_r.lights.cluster_memory);
     if (res != QK_SUCCESS) return res;
 
     return QK_SUCCESS;
 }
 
-// --- Compute Pipeline ---
+// --- Descriptor Sets ---
 
-static qk_result_t compute_pipeline_init(void)
+static qk_result_t descriptor_init(void)
 {
     /* Descriptor set layout for compute:
-     * binding 0: combined image sampler (depth texture)
-     * binding 1: storage buffer (light buffer, readonly)
-     * binding 2: storage buffer (tile buffer, writeonly) */
-    VkDescriptorSetLayoutBinding bindings[3] = {
+     * binding 0: storage buffer (light buffer, readonly)
+     * binding 1: storage buffer (cluster buffer, writeonly) */
+    VkDescriptorSetLayoutBinding bindings[2] = {
         {
             .binding         = 0,
-            .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
-        },
-        {
-            .binding         = 1,
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .descriptorCount = 1,
             .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
         },
         {
-            .binding         = 2,
+            .binding         = 1,
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .descriptorCount = 1,
             .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
@@ -268,7 +169,7 @@ static qk_result_t compute_pipeline_init(void)
     };
     VkDescriptorSetLayoutCreateInfo layout_info = {
         .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = 3,
+        .bindingCount = 2,
         .pBindings    = bindings
     };
     vkCreateDescriptorSetLayout(g_r.device.handle, &layout_info, NULL,
@@ -276,7 +177,7 @@ static qk_result_t compute_pipeline_init(void)
 
     /* Light SSBO layout for fragment shaders (set 2 for world, set 1 for entity):
      * binding 0: storage buffer (light buffer, readonly)
-     * binding 1: storage buffer (tile buffer, readonly) */
+     * binding 1: storage buffer (cluster buffer, readonly) */
     VkDescriptorSetLayoutBinding light_bindings[2] = {
         {
             .binding         = 0,
@@ -325,52 +226,36 @@ static qk_result_t compute_pipeline_init(void)
 
     // Write compute descriptor set
     VkDeviceSize light_size = 16 + R_MAX_DYNAMIC_LIGHTS * sizeof(r_dynamic_light_t);
-    VkDeviceSize tile_size = (VkDeviceSize)g_r.lights.tile_count_x * g_r.lights.tile_count_y *
-                             (R_MAX_LIGHTS_PER_TILE + 1) * sizeof(u32);
-
-    VkDescriptorImageInfo depth_info = {
-        .sampler     = g_r.textures.sampler_nearest,
-        .imageView   = g_r.world_target.depth_view,
-        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
-    };
     VkDescriptorBufferInfo light_buf_info = {
         .buffer = g_r.lights.light_ssbo,
         .offset = 0,
         .range  = light_size
     };
-    VkDescriptorBufferInfo tile_buf_info = {
-        .buffer = g_r.lights.tile_ssbo,
+    VkDescriptorBufferInfo cluster_buf_info = {
+        .buffer = g_r.lights.cluster_ssbo,
         .offset = 0,
-        .range  = tile_size
+        .range  = cluster_buffer_size()
     };
 
-    VkWriteDescriptorSet writes[3] = {
+    VkWriteDescriptorSet writes[2] = {
         {
             .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .dstSet          = g_r.lights.cull_descriptor_set,
             .dstBinding      = 0,
             .descriptorCount = 1,
-            .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .pImageInfo      = &depth_info
-        },
-        {
-            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet          = g_r.lights.cull_descriptor_set,
-            .dstBinding      = 1,
-            .descriptorCount = 1,
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .pBufferInfo     = &light_buf_info
         },
         {
             .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .dstSet          = g_r.lights.cull_descriptor_set,
-            .dstBinding      = 2,
+            .dstBinding      = 1,
             .descriptorCount = 1,
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .pBufferInfo     = &tile_buf_info
+            .pBufferInfo     = &cluster_buf_info
         }
     };
-    vkUpdateDescriptorSets(g_r.device.handle, 3, writes, 0, NULL);
+    vkUpdateDescriptorSets(g_r.device.handle, 2, writes, 0, NULL);
 
     // Write fragment light descriptor set
     VkWriteDescriptorSet frag_writes[2] = {
@@ -388,11 +273,127 @@ static qk_result_t compute_pipeline_init(void)
             .dstBinding      = 1,
             .descriptorCount = 1,
             .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .pBufferInfo     = &tile_buf_info
+            .pBufferInfo     = &cluster_buf_info
         }
     };
     vkUpdateDescriptorSets(g_r.device.handle, 2, frag_writes, 0, NULL);
 
+    return QK_SUCCESS;
+}
+
+// --- Pipelines (created by r_pipeline_warmup, possibly on a worker thread) ---
+
+qk_result_t r_compute_create_prepass_pipeline(void)
+{
+    // Depth pre-pass pipeline: same vertex input as world, no fragment shader
+    VkShaderModule vert = r_pipeline_load_shader("src/renderer/shaders/compiled/world.vert.spv");
+    if (!vert) return QK_ERROR_PIPELINE;
+
+    VkPipelineShaderStageCreateInfo stage = {
+        .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .stage  = VK_SHADER_STAGE_VERTEX_BIT,
+        .module = vert,
+        .pName  = "main"
+    };
+
+    VkVertexInputBindingDescription binding = {
+        .binding   = 0,
+        .stride    = sizeof(r_world_vertex_t),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+    VkVertexInputAttributeDescription attrs[] = {
+        { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT,
+          .offset = offsetof(r_world_vertex_t, position) },
+        { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT,
+          .offset = offsetof(r_world_vertex_t, normal) },
+        { .location = 2, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT,
+          .offset = offsetof(r_world_vertex_t, uv) },
+        { .location = 3, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT,
+          .offset = offsetof(r_world_vertex_t, lm_uv) },
+        { .location = 4, .binding = 0, .format = VK_FORMAT_R32_UINT,
+          .offset = offsetof(r_world_vertex_t, texture_id) }
+    };
+    VkPipelineVertexInputStateCreateInfo vertex_input = {
+        .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount   = 1,
+        .pVertexBindingDescriptions      = &binding,
+        .vertexAttributeDescriptionCount = 5,
+        .pVertexAttributeDescriptions    = attrs
+    };
+    VkPipelineInputAssemblyStateCreateInfo input_assembly = {
+        .sType    = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+    VkPipelineViewportStateCreateInfo viewport_state = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1, .scissorCount = 1
+    };
+    VkPipelineRasterizationStateCreateInfo rasterizer = {
+        .sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode    = VK_CULL_MODE_BACK_BIT,
+        .frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .lineWidth   = 1.0f
+    };
+    VkPipelineMultisampleStateCreateInfo multisample = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    };
+    VkPipelineDepthStencilStateCreateInfo depth_stencil = {
+        .sType            = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable  = VK_TRUE,
+        .depthWriteEnable = VK_TRUE,
+        .depthCompareOp   = VK_COMPARE_OP_LESS
+    };
+    VkPipelineColorBlendStateCreateInfo color_blend = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .attachmentCount = 0
+    };
+    VkDynamicState dyn_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamic_state = {
+        .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = 2,
+        .pDynamicStates    = dyn_states
+    };
+
+    // Layout: only needs view UBO (set 0) for the VP matrix
+    VkPipelineLayoutCreateInfo layout_info = {
+        .sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts    = &g_r.view_set_layout
+    };
+    vkCreatePipelineLayout(g_r.device.handle, &layout_info, NULL,
+                           &g_r.depth_prepass.pipeline.layout);
+
+    VkGraphicsPipelineCreateInfo pipeline_info = {
+        .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount          = 1,
+        .pStages             = &stage,
+        .pVertexInputState   = &vertex_input,
+        .pInputAssemblyState = &input_assembly,
+        .pViewportState      = &viewport_state,
+        .pRasterizationState = &rasterizer,
+        .pMultisampleState   = &multisample,
+        .pDepthStencilState  = &depth_stencil,
+        .pColorBlendState    = &color_blend,
+        .pDynamicState       = &dynamic_state,
+        .layout              = g_r.depth_prepass.pipeline.layout,
+        .renderPass          = g_r.depth_prepass.render_pass,
+        .subpass             = 0
+    };
+
+    VkResult vr = vkCreateGraphicsPipelines(g_r.device.handle, g_r.pipeline_cache_handle,
+                                             1, &pipeline_info, NULL,
+                                             &g_r.depth_prepass.pipeline.handle);
+    vkDestroyShaderModule(g_r.device.handle, vert, NULL);
+
+    if (vr != VK_SUCCESS) return QK_ERROR_PIPELINE;
+
+    return QK_SUCCESS;
+}
+
+qk_result_t r_compute_create_cull_pipeline(void)
+{
     // Compute pipeline layout
     VkPushConstantRange push_range = {
         .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
@@ -447,7 +448,7 @@ qk_result_t r_compute_init(void)
     res = ssbo_init();
     if (res != QK_SUCCESS) return res;
 
-    res = compute_pipeline_init();
+    res = descriptor_init();
     if (res != QK_SUCCESS) return res;
 
     g_r.lights.initialized = true;
@@ -488,8 +489,8 @@ void r_compute_shutdown(void)
         vkUnmapMemory(dev, g_r.lights.light_memory);
         vkFreeMemory(dev, g_r.lights.light_memory, NULL);
     }
-    if (g_r.lights.tile_ssbo) vkDestroyBuffer(dev, g_r.lights.tile_ssbo, NULL);
-    if (g_r.lights.tile_memory) vkFreeMemory(dev, g_r.lights.tile_memory, NULL);
+    if (g_r.lights.cluster_ssbo) vkDestroyBuffer(dev, g_r.lights.cluster_ssbo, NULL);
+    if (g_r.lights.cluster_memory) vkFreeMemory(dev, g_r.lights.cluster_memory, NULL);
 
     memset(&g_r.lights, 0, sizeof(g_r.lights));
 }
@@ -567,21 +568,12 @@ void r_depth_prepass_record(VkCommandBuffer cmd, u32 frame_index)
 
     vkCmdEndRenderPass(cmd);
 
-    r_debug_end_label(cmd);
-}
-
-void r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_projection)
-{
-    if (!g_r.lights.initialized) return;
-    if (!g_r.lights.cull_pipeline) return;
-
-    r_debug_begin_label(cmd, "Light Cull", 0.8f, 0.8f, 0.2f);
-
-    // Barrier: depth attachment -> shader read
+    // Barrier: pre-pass depth writes -> world pass depth test (LOAD_OP_LOAD)
     VkImageMemoryBarrier depth_barrier = {
         .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
         .srcAccessMask       = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-        .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+        .dstAccessMask       = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
         .oldLayout           = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
         .newLayout           = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -598,35 +590,55 @@ void r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_projection)
 
     vkCmdPipelineBarrier(cmd,
         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
         0, 0, NULL, 0, NULL, 1, &depth_barrier);
 
+    r_debug_end_label(cmd);
+}
+
+void r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_view_projection)
+{
+    if (!g_r.lights.initialized) return;
+    if (!g_r.lights.cull_pipeline) return;
+
+    /* Light assignment runs once per frame over the whole cluster grid. It
+     * only depends on the camera and the light list, not on the depth
+     * buffer, so it is recorded ahead of the depth pre-pass. */
+    r_debug_begin_label(cmd, "Light Cluster Assign", 0.8f, 0.8f, 0.2f);
+
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, g_r.lights.cull_pipeline);
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
                             g_r.lights.cull_layout,
                             0, 1, &g_r.lights.cull_descriptor_set, 0, NULL);
 
-    r_light_cull_push_constants_t pc;
-    memcpy(pc.inv_projection, inv_projection, sizeof(f32) * 16);
-    pc.screen_width     = g_r.config.render_width;
-    pc.screen_height    = g_r.config.render_height;
-    pc.tile_count_x     = g_r.lights.tile_count_x;
-    pc.light_count      = g_r.lights.light_count;
+    r_light_cull_push_constants_t pc = {
+        .cluster_count_x = g_r.lights.cluster_count_x,
+        .cluster_count_y = g_r.lights.cluster_count_y,
+        .screen_width    = g_r.config.render_width,
+        .screen_height   = g_r.config.render_height,
+        .z_near          = g_r.lights.z_near,
+        .z_far           = g_r.lights.z_far,
+        .light_count     = g_r.lights.light_count,
+        ._pad            = 0
+    };
+    memcpy(pc.inv_view_projection, inv_view_projection, sizeof(f32) * 16);
 
     vkCmdPushConstants(cmd, g_r.lights.cull_layout,
                        VK_SHADER_STAGE_COMPUTE_BIT,
                        0, sizeof(pc), &pc);
 
-    vkCmdDispatch(cmd, g_r.lights.tile_count_x, g_r.lights.tile_count_y, 1);
+    u32 group_count = (cluster_total_count() + R_CLUSTER_CULL_GROUP_SIZE - 1) /
+                      R_CLUSTER_CULL_GROUP_SIZE;
+    vkCmdDispatch(cmd, group_count, 1, 1);
 
-    // Barrier: tile SSBO write -> fragment shader read
-    VkBufferMemoryBarrier tile_barrier = {
+    // Barrier: cluster SSBO write -> fragment shader read
+    VkBufferMemoryBarrier cluster_barrier = {
         .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
         .srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT,
         .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .buffer              = g_r.lights.tile_ssbo,
+        .buffer              = g_r.lights.cluster_ssbo,
         .offset              = 0,
         .size                = VK_WHOLE_SIZE
     };
@@ -634,7 +646,17 @@ void r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_projection)
     vkCmdPipelineBarrier(cmd,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, NULL, 1, &tile_barrier, 0, NULL);
+        0, 0, NULL, 1, &cluster_barrier, 0, NULL);
 
     r_debug_end_label(cmd);
 }
+
+// --- Cluster slice mapping (shared with the view UBO) ---
+
+void r_compute_cluster_slice_params(f32 z_near, f32 z_far,
+                                    f32 *out_scale, f32 *out_bias)
+{
+    f32 log_ratio = logf(z_far / z_near);
+    *out_scale = (f32)R_CLUSTER_SLICES / log_ratio;
+    *out_bias  = -(f32)R_CLUSTER_SLICES * logf(z_near) / log_ratio;
+}
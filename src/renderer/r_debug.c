@@ -2,9 +2,16 @@
  * QUICKEN Renderer - Debug Support
  *
  * Validation layers, debug messenger, GPU timestamp queries.
+ *
+ * GPU timing is scoped: R_GPU_SCOPE_BEGIN/END bracket a named region with
+ * two timestamps, regions nest, and each frame in flight records into its
+ * own query pool. A frame's results are read when its slot comes around
+ * again and handed to qk_prof as zones of the same name.
  */
 
 #include "r_types.h"
+#include "core/qk_prof.h"
+#include <stdlib.h>
 #include <string.h>
 
 // --- Debug Labels ---
@@ -60,62 +67,169 @@ void r_debug_timers_init(void)
         return;
     }
 
+    // Timestamps wrap at the queue's valid bits; 0 means no timestamps
+    u32 family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(g_r.device.physical, &family_count, NULL);
+    VkQueueFamilyProperties *families = malloc(family_count * sizeof(VkQueueFamilyProperties));
+    if (!families) return;
+    vkGetPhysicalDeviceQueueFamilyProperties(g_r.device.physical, &family_count, families);
+    u32 valid_bits = 0;
+    if (g_r.device.families.graphics < family_count) {
+        valid_bits = families[g_r.device.families.graphics].timestampValidBits;
+    }
+    free(families);
+    if (valid_bits == 0) return;
+    g_r.gpu_timers.timestamp_mask = valid_bits >= 64 ? ~(u64)0 : (((u64)1 << valid_bits) - 1);
+
     VkQueryPoolCreateInfo pool_info = {
         .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
         .queryType  = VK_QUERY_TYPE_TIMESTAMP,
         .queryCount = R_TIMESTAMP_COUNT
     };
 
-    vkCreateQueryPool(g_r.device.handle, &pool_info, NULL, &g_r.gpu_timers.pool);
+    for (u32 i = 0; i < R_FRAMES_IN_FLIGHT; i++) {
+        if (vkCreateQueryPool(g_r.device.handle, &pool_info, NULL,
+                              &g_r.gpu_timers.frames[i].pool) != VK_SUCCESS) {
+            r_debug_timers_shutdown();
+            return;
+        }
+    }
 }
 
 void r_debug_timers_shutdown(void)
 {
-    if (g_r.gpu_timers.pool) {
-        vkDestroyQueryPool(g_r.device.handle, g_r.gpu_timers.pool, NULL);
-        g_r.gpu_timers.pool = VK_NULL_HANDLE;
+    for (u32 i = 0; i < R_FRAMES_IN_FLIGHT; i++) {
+        r_gpu_timer_frame_t *tf = &g_r.gpu_timers.frames[i];
+        if (tf->pool) {
+            vkDestroyQueryPool(g_r.device.handle, tf->pool, NULL);
+            tf->pool = VK_NULL_HANDLE;
+        }
+        tf->pending = false;
     }
+    g_r.gpu_timers.recording = NULL;
+}
+
+// First command of the frame: the pool's last use finished at the fence wait
+void r_debug_timers_begin_frame(VkCommandBuffer cmd, u32 frame_index, u64 frame_number)
+{
+    r_gpu_timer_frame_t *tf = &g_r.gpu_timers.frames[frame_index];
+    g_r.gpu_timers.recording = NULL;
+    if (!tf->pool) return;
+
+    vkCmdResetQueryPool(cmd, tf->pool, 0, R_TIMESTAMP_COUNT);
+    tf->region_count = 0;
+    tf->stack_depth = 0;
+    tf->overflow_depth = 0;
+    tf->frame_number = frame_number;
+    tf->pending = false;
+    g_r.gpu_timers.recording = tf;
 }
 
-void r_debug_timestamp_write(VkCommandBuffer cmd, VkPipelineStageFlagBits stage, u32 query)
+void r_debug_timers_end_frame(void)
 {
-    if (g_r.gpu_timers.pool && query < R_TIMESTAMP_COUNT) {
-        vkCmdWriteTimestamp(cmd, stage, g_r.gpu_timers.pool, query);
+    r_gpu_timer_frame_t *tf = g_r.gpu_timers.recording;
+    if (!tf) return;
+
+    // Unbalanced scopes would leave unwritten queries; drop the frame
+    tf->pending = tf->region_count > 0 && tf->stack_depth == 0 && tf->overflow_depth == 0;
+    g_r.gpu_timers.recording = NULL;
+}
+
+void r_debug_region_begin(VkCommandBuffer cmd, const char *name)
+{
+    r_gpu_timer_frame_t *tf = g_r.gpu_timers.recording;
+    if (!tf) return;
+
+    // Too deep: untimed, but counted so the matching end pops nothing
+    if (tf->stack_depth >= R_GPU_REGION_DEPTH) {
+        tf->overflow_depth++;
+        return;
     }
+
+    // Too many regions: a placeholder keeps the stack balanced
+    if (tf->region_count >= R_GPU_REGION_MAX) {
+        tf->stack[tf->stack_depth++] = -1;
+        return;
+    }
+
+    i8 parent = -1;
+    for (u32 d = tf->stack_depth; d > 0 && parent < 0; d--) {
+        parent = tf->stack[d - 1];
+    }
+
+    u32 idx = tf->region_count++;
+    tf->regions[idx] = (r_gpu_region_t){
+        .name   = name,
+        .parent = parent,
+        .depth  = (u8)tf->stack_depth,
+    };
+    tf->stack[tf->stack_depth++] = (i8)idx;
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, tf->pool, idx * 2);
+}
+
+void r_debug_region_end(VkCommandBuffer cmd)
+{
+    r_gpu_timer_frame_t *tf = g_r.gpu_timers.recording;
+    if (!tf) return;
+    if (tf->overflow_depth > 0) {
+        tf->overflow_depth--;
+        return;
+    }
+    if (tf->stack_depth == 0) return;
+
+    i8 idx = tf->stack[--tf->stack_depth];
+    if (idx < 0) return;
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, tf->pool, (u32)idx * 2 + 1);
 }
 
-void r_debug_timers_read(void)
+static f64 r_debug_region_ms(const char *name)
 {
-    if (!g_r.gpu_timers.pool) return;
+    for (u32 i = 0; i < g_r.gpu_timers.resolved_count; i++) {
+        if (strcmp(g_r.gpu_timers.resolved[i].name, name) == 0) {
+            return g_r.gpu_timers.resolved_ms[i];
+        }
+    }
+    return 0.0;
+}
 
+// After the fence wait for frame_index: its queries are complete, and they
+// are from R_FRAMES_IN_FLIGHT frames ago, never the frame being recorded
+void r_debug_timers_read(u32 frame_index)
+{
+    r_gpu_timer_frame_t *tf = &g_r.gpu_timers.frames[frame_index];
+    if (!tf->pool || !tf->pending) return;
+    tf->pending = false;
+
+    u32 query_count = tf->region_count * 2;
     VkResult vr = vkGetQueryPoolResults(
-        g_r.device.handle, g_r.gpu_timers.pool,
-        0, R_TIMESTAMP_COUNT,
-        sizeof(g_r.gpu_timers.results), g_r.gpu_timers.results,
+        g_r.device.handle, tf->pool,
+        0, query_count,
+        query_count * sizeof(u64), g_r.gpu_timers.results,
         sizeof(u64), VK_QUERY_RESULT_64_BIT);
 
-    if (vr != VK_SUCCESS && vr != VK_NOT_READY) return;
-    if (vr == VK_NOT_READY) return;
+    if (vr != VK_SUCCESS) return;
 
     f64 period = (f64)g_r.device.properties.limits.timestampPeriod; // nanoseconds
+    u64 mask = g_r.gpu_timers.timestamp_mask;
 
-    // Timestamps: 0=frame start, 1=world end, 2=ui end, 3=compose end
-    if (g_r.gpu_timers.results[0] > 0 && g_r.gpu_timers.results[3] > 0) {
-        g_r.gpu_timers.gpu_frame_ms = (f64)(g_r.gpu_timers.results[3] - g_r.gpu_timers.results[0])
-                                    * period / 1000000.0;
-    }
-    if (g_r.gpu_timers.results[0] > 0 && g_r.gpu_timers.results[1] > 0) {
-        g_r.gpu_timers.world_pass_ms = (f64)(g_r.gpu_timers.results[1] - g_r.gpu_timers.results[0])
-                                     * period / 1000000.0;
-    }
-    if (g_r.gpu_timers.results[1] > 0 && g_r.gpu_timers.results[2] > 0) {
-        g_r.gpu_timers.ui_pass_ms = (f64)(g_r.gpu_timers.results[2] - g_r.gpu_timers.results[1])
-                                   * period / 1000000.0;
-    }
-    if (g_r.gpu_timers.results[2] > 0 && g_r.gpu_timers.results[3] > 0) {
-        g_r.gpu_timers.compose_pass_ms = (f64)(g_r.gpu_timers.results[3] - g_r.gpu_timers.results[2])
-                                        * period / 1000000.0;
+    for (u32 i = 0; i < tf->region_count; i++) {
+        u64 begin = g_r.gpu_timers.results[i * 2];
+        u64 end   = g_r.gpu_timers.results[i * 2 + 1];
+        f64 ms = (f64)((end - begin) & mask) * period / 1000000.0;
+
+        g_r.gpu_timers.resolved[i] = tf->regions[i];
+        g_r.gpu_timers.resolved_ms[i] = ms;
+        QK_PROF_ZONE_ADD(tf->regions[i].name, ms);
     }
+    g_r.gpu_timers.resolved_count = tf->region_count;
+    g_r.gpu_timers.resolved_frame = tf->frame_number;
+
+    g_r.gpu_timers.gpu_frame_ms    = r_debug_region_ms("gpu_frame");
+    g_r.gpu_timers.world_pass_ms   = r_debug_region_ms("gpu_world");
+    g_r.gpu_timers.ui_pass_ms      = r_debug_region_ms("gpu_ui");
+    g_r.gpu_timers.compose_pass_ms = r_debug_region_ms("gpu_compose");
 }
 
 qk_result_t r_debug_init(void)
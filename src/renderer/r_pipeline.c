@@ -1,8 +1,15 @@
 /*
  * QUICKEN Renderer - Pipeline Creation, Shader Loading, Pipeline Cache
+ *
+ * Every pipeline is built up front by r_pipeline_warmup, in parallel on
+ * the job system's workers, against a persistent pipeline cache that is
+ * validated against the device and driver before use.
  */
 
 #include "r_types.h"
+#include "core/qk_hash.h"
+#include "core/qk_job.h"
+#include <SDL3/SDL_timer.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -56,6 +63,81 @@ static void r_pipeline_cache_build_path(void)
     }
 }
 
+/* On-disk layout: our own header, then the driver's opaque cache blob.
+ * The header pins the blob to one device + driver build so a driver
+ * update or GPU swap rebuilds the cache instead of feeding stale (or
+ * corrupt) data to vkCreatePipelineCache, which some drivers crash on. */
+#define PIPELINE_CACHE_MAGIC    0x4350514Bu     // "KQPC"
+#define PIPELINE_CACHE_VERSION  1u
+
+typedef struct r_pipeline_cache_file_header {
+    u32     magic;
+    u32     version;
+    u32     vendor_id;
+    u32     device_id;
+    u32     driver_version;
+    u32     data_size;
+    u32     data_hash;      // FNV-1a over the driver blob
+    u32     _pad;
+    u8      cache_uuid[VK_UUID_SIZE];
+} r_pipeline_cache_file_header_t;
+
+_Static_assert(sizeof(r_pipeline_cache_file_header_t) == 48,
+               "pipeline cache header layout changed — bump PIPELINE_CACHE_VERSION");
+
+static const char *s_cache_status = "cold";
+
+static void pipeline_cache_fill_header(r_pipeline_cache_file_header_t *out_header,
+                                       const u8 *data, size_t size)
+{
+    const VkPhysicalDeviceProperties *props = &g_r.device.properties;
+    *out_header = (r_pipeline_cache_file_header_t){
+        .magic          = PIPELINE_CACHE_MAGIC,
+        .version        = PIPELINE_CACHE_VERSION,
+        .vendor_id      = props->vendorID,
+        .device_id      = props->deviceID,
+        .driver_version = props->driverVersion,
+        .data_size      = (u32)size,
+        .data_hash      = qk_hash_bytes(data, size),
+    };
+    memcpy(out_header->cache_uuid, props->pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+/* Returns NULL if valid, otherwise a short reason for the rebuild. */
+static const char *pipeline_cache_validate(const u8 *file, size_t file_size)
+{
+    if (file_size < sizeof(r_pipeline_cache_file_header_t)) return "truncated";
+
+    r_pipeline_cache_file_header_t header;
+    memcpy(&header, file, sizeof(header));
+    if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_VERSION)
+        return "unknown format";
+
+    const VkPhysicalDeviceProperties *props = &g_r.device.properties;
+    if (header.vendor_id != props->vendorID || header.device_id != props->deviceID)
+        return "GPU changed";
+    if (header.driver_version != props->driverVersion ||
+        memcmp(header.cache_uuid, props->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        return "driver changed";
+
+    const u8 *blob = file + sizeof(header);
+    size_t blob_size = file_size - sizeof(header);
+    if (header.data_size != blob_size) return "truncated";
+    if (header.data_hash != qk_hash_bytes(blob, blob_size)) return "corrupt";
+
+    // The driver's own header (VkPipelineCacheHeaderVersionOne) must agree too
+    if (blob_size < 16 + VK_UUID_SIZE) return "corrupt";
+    u32 vk_header[4];
+    memcpy(vk_header, blob, sizeof(vk_header));
+    if (vk_header[0] < 16 + VK_UUID_SIZE ||
+        vk_header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        vk_header[2] != props->vendorID || vk_header[3] != props->deviceID ||
+        memcmp(blob + 16, props->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        return "driver changed";
+
+    return NULL;
+}
+
 qk_result_t r_pipeline_cache_init(void)
 {
     r_pipeline_cache_build_path();
@@ -65,18 +147,24 @@ qk_result_t r_pipeline_cache_init(void)
     };
 
     // Try to load existing cache
+    s_cache_status = "cold";
     FILE *f = fopen(s_cache_path, "rb");
-    void *cache_data = NULL;
+    u8 *file_data = NULL;
     if (f) {
         fseek(f, 0, SEEK_END);
         long size = ftell(f);
         fseek(f, 0, SEEK_SET);
         if (size > 0) {
-            cache_data = malloc((size_t)size);
-            if (cache_data) {
-                if (fread(cache_data, 1, (size_t)size, f) == (size_t)size) {
-                    cache_info.initialDataSize = (size_t)size;
-                    cache_info.pInitialData = cache_data;
+            file_data = malloc((size_t)size);
+            if (file_data && fread(file_data, 1, (size_t)size, f) == (size_t)size) {
+                const char *reject = pipeline_cache_validate(file_data, (size_t)size);
+                if (!reject) {
+                    cache_info.initialDataSize = (size_t)size - sizeof(r_pipeline_cache_file_header_t);
+                    cache_info.pInitialData = file_data + sizeof(r_pipeline_cache_file_header_t);
+                    s_cache_status = "warm";
+                } else {
+                    fprintf(stderr, "[Renderer] Pipeline cache rejected (%s), rebuilding\n", reject);
+                    s_cache_status = "rebuilt";
                 }
             }
         }
@@ -85,12 +173,13 @@ qk_result_t r_pipeline_cache_init(void)
 
     VkResult vr = vkCreatePipelineCache(g_r.device.handle, &cache_info, NULL,
                                          &g_r.pipeline_cache_handle);
-    free(cache_data);
+    free(file_data);
 
     if (vr != VK_SUCCESS) {
         // Try without initial data
         cache_info.initialDataSize = 0;
         cache_info.pInitialData = NULL;
+        s_cache_status = "rebuilt";
         vr = vkCreatePipelineCache(g_r.device.handle, &cache_info, NULL,
                                     &g_r.pipeline_cache_handle);
         if (vr != VK_SUCCESS) return QK_ERROR_PIPELINE;
@@ -107,14 +196,27 @@ void r_pipeline_cache_save(void)
     vkGetPipelineCacheData(g_r.device.handle, g_r.pipeline_cache_handle, &size, NULL);
     if (size == 0) return;
 
-    void *data = malloc(size);
+    u8 *data = malloc(size);
     if (!data) return;
 
     if (vkGetPipelineCacheData(g_r.device.handle, g_r.pipeline_cache_handle, &size, data) == VK_SUCCESS) {
-        FILE *f = fopen(s_cache_path, "wb");
+        r_pipeline_cache_file_header_t header;
+        pipeline_cache_fill_header(&header, data, size);
+
+        // Write to a temp file and swap it in, so a crash mid-write never
+        // leaves a half-written cache behind
+        char tmp_path[sizeof(s_cache_path) + 8];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", s_cache_path);
+        FILE *f = fopen(tmp_path, "wb");
         if (f) {
-            fwrite(data, 1, size, f);
-            fclose(f);
+            bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                      fwrite(data, 1, size, f) == size;
+            ok = (fclose(f) == 0) && ok;
+            if (ok) {
+                remove(s_cache_path);
+                ok = rename(tmp_path, s_cache_path) == 0;
+            }
+            if (!ok) remove(tmp_path);
         }
     }
 
@@ -763,11 +865,11 @@ qk_result_t r_pipeline_create_ui(void)
         .pDynamicStates    = dynamic_states
     };
 
-    // Push constants for screen size
+    // Push constants: screen size (vertex), SDF flag (fragment)
     VkPushConstantRange push_range = {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
         .offset     = 0,
-        .size       = sizeof(f32) * 2
+        .size       = sizeof(r_ui_push_constants_t)
     };
 
     VkPipelineLayoutCreateInfo layout_info = {
@@ -901,7 +1003,8 @@ qk_result_t r_pipeline_create_overlay_ui(void)
     };
 
     VkPushConstantRange push_range = {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT, .offset = 0, .size = sizeof(f32) * 2
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .offset = 0, .size = sizeof(r_ui_push_constants_t)
     };
 
     VkPipelineLayoutCreateInfo layout_info = {
@@ -1106,3 +1209,83 @@ void r_pipeline_destroy_all(void)
     if (g_r.compose_pipeline.layout) vkDestroyPipelineLayout(dev, g_r.compose_pipeline.layout, NULL);
     memset(&g_r.compose_pipeline, 0, sizeof(g_r.compose_pipeline));
 }
+
+// --- Warmup ---
+
+/* All pipelines are compiled here, at init and after a resolution change,
+ * so nothing is ever compiled mid-match. Creation functions touch disjoint
+ * g_r fields and vkCreate*Pipelines does not require external sync on the
+ * pipeline cache, so tasks run on any thread. Heaviest pipelines first. */
+
+typedef struct r_warmup_task {
+    const char   *name;
+    qk_result_t (*create)(void);
+    qk_result_t   result;
+    f64           compile_ms;
+} r_warmup_task_t;
+
+static r_warmup_task_t s_warmup_tasks[] = {
+    { .name = "world",        .create = r_pipeline_create_world },
+    { .name = "entity",       .create = r_pipeline_create_entity },
+    { .name = "bloom",        .create = r_bloom_create_pipelines },
+    { .name = "depth_prepass",.create = r_compute_create_prepass_pipeline },
+    { .name = "light_cull",   .create = r_compute_create_cull_pipeline },
+    { .name = "fx",           .create = r_pipeline_create_fx },
+    { .name = "compose",      .create = r_pipeline_create_compose },
+    { .name = "ui",           .create = r_pipeline_create_ui },
+    { .name = "overlay_ui",   .create = r_pipeline_create_overlay_ui },
+};
+
+#define R_WARMUP_TASK_COUNT (sizeof(s_warmup_tasks) / sizeof(s_warmup_tasks[0]))
+
+static void warmup_range(void *data, u32 begin, u32 end)
+{
+    QK_UNUSED(data);
+    f64 freq = (f64)SDL_GetPerformanceFrequency();
+
+    for (u32 i = begin; i < end; i++) {
+        r_warmup_task_t *task = &s_warmup_tasks[i];
+        u64 t0 = SDL_GetPerformanceCounter();
+        task->result = task->create();
+        u64 t1 = SDL_GetPerformanceCounter();
+        task->compile_ms = (f64)(t1 - t0) / freq * 1000.0;
+    }
+}
+
+qk_result_t r_pipeline_warmup(void)
+{
+    u64 start = SDL_GetPerformanceCounter();
+
+    for (u32 i = 0; i < R_WARMUP_TASK_COUNT; i++) {
+        s_warmup_tasks[i].result = QK_SUCCESS;
+        s_warmup_tasks[i].compile_ms = 0.0;
+    }
+
+    /* One task per chunk. The caller runs the first chunk and idle job
+     * workers steal the rest; without qk_job_init everything runs inline. */
+    qk_job_parallel_for((u32)R_WARMUP_TASK_COUNT, 1, warmup_range, NULL);
+
+    f64 total_ms = (f64)(SDL_GetPerformanceCounter() - start) /
+                   (f64)SDL_GetPerformanceFrequency() * 1000.0;
+
+    fprintf(stderr, "[Renderer] Pipeline warmup: %u pipelines in %.1f ms on %u threads (cache %s)\n",
+            (u32)R_WARMUP_TASK_COUNT, total_ms, qk_job_worker_count(), s_cache_status);
+
+    qk_result_t first_error = QK_SUCCESS;
+    for (u32 i = 0; i < R_WARMUP_TASK_COUNT; i++) {
+        const r_warmup_task_t *task = &s_warmup_tasks[i];
+        fprintf(stderr, "[Renderer]   %-14s %7.2f ms%s\n", task->name, task->compile_ms,
+                task->result == QK_SUCCESS ? "" : "  FAILED");
+        if (task->result != QK_SUCCESS && first_error == QK_SUCCESS) {
+            first_error = task->result;
+        }
+    }
+
+    // Persist right away so a crash later in the session keeps the warm cache
+    if (first_error == QK_SUCCESS) {
+        r_pipeline_cache_save();
+        s_cache_status = "warm";
+    }
+
+    return first_error;
+}
@@ -285,6 +285,7 @@ texture_create_view:
     tex->height = height;
     tex->format = format;
     tex->in_use = true;
+    tex->sdf    = false;
 
     // Find next free slot
     g_r.textures.next_free = id + 1;
@@ -304,3 +305,9 @@ VkDescriptorSet r_texture_get_descriptor(u32 texture_id)
     }
     return g_r.textures.textures[texture_id].descriptor_set;
 }
+
+bool r_texture_is_sdf(u32 texture_id)
+{
+    return texture_id < R_MAX_TEXTURES && g_r.textures.textures[texture_id].in_use &&
+           g_r.textures.textures[texture_id].sdf;
+}
@@ -31,7 +31,9 @@
 #define R_FRAMES_IN_FLIGHT      2
 #define R_MAX_TEXTURES          256
 #define R_UI_MAX_QUADS          8192
-#define R_TIMESTAMP_COUNT       8
+#define R_GPU_REGION_MAX        32
+#define R_GPU_REGION_DEPTH      8
+#define R_TIMESTAMP_COUNT       (R_GPU_REGION_MAX * 2)
 #define R_ENTITY_MAX_DRAWS      512
 
 enum {
@@ -207,6 +209,13 @@ typedef struct r_ui_quad {
     u32     texture_id;
 } r_ui_quad_t;
 
+// Both stages see the block; ui.frag reads sdf (per texture batch)
+typedef struct r_ui_push_constants {
+    f32     screen_size[2];
+    u32     sdf;            // 1 = texture alpha is a distance field
+    u32     pad;
+} r_ui_push_constants_t;
+
 // --- Texture ---
 
 typedef struct r_texture {
@@ -218,6 +227,7 @@ typedef struct r_texture {
     u32             height;
     VkFormat        format;
     bool            in_use;
+    bool            sdf;        // alpha holds distance, 0.5 = glyph edge
 } r_texture_t;
 
 typedef struct r_texture_manager {
@@ -233,13 +243,17 @@ typedef struct r_view_uniforms {
     f32     view_projection[16];
     f32     camera_pos[3];
     f32     time;
-    u32     tile_count_x;
+    u32     cluster_count_x;
+    u32     cluster_count_y;
     u32     screen_width;
     u32     screen_height;
-    u32     _pad;
+    f32     z_near;
+    f32     z_far;
+    f32     cluster_slice_scale;    // slice = log(view_depth) * scale + bias
+    f32     cluster_slice_bias;
 } r_view_uniforms_t;
 
-_Static_assert(sizeof(r_view_uniforms_t) == 96,
+_Static_assert(sizeof(r_view_uniforms_t) == 112,
                "UBO struct size changed — update descriptor");
 
 // --- Entity Types ---
@@ -334,11 +348,17 @@ typedef struct r_bloom_state {
     bool            initialized;
 } r_bloom_state_t;
 
-// --- Forward+ Light Culling Types ---
+// --- Clustered Light Culling Types ---
 
-#define R_MAX_DYNAMIC_LIGHTS    256
-#define R_TILE_SIZE             16
-#define R_MAX_LIGHTS_PER_TILE   64
+/* The frustum is divided into R_CLUSTER_TILE_SIZE pixel screen tiles times
+ * R_CLUSTER_SLICES exponential depth slices. Each cluster stores
+ * [count, idx0 .. idx(R_MAX_LIGHTS_PER_CLUSTER-1)]. These values are
+ * mirrored as literals in light_cull.comp, world.frag and entity.frag. */
+#define R_MAX_DYNAMIC_LIGHTS        256
+#define R_CLUSTER_TILE_SIZE         64
+#define R_CLUSTER_SLICES            24
+#define R_MAX_LIGHTS_PER_CLUSTER    64
+#define R_CLUSTER_CULL_GROUP_SIZE   64
 
 typedef struct r_dynamic_light {
     f32     position[3];
@@ -348,13 +368,20 @@ typedef struct r_dynamic_light {
 } r_dynamic_light_t;
 
 typedef struct r_light_cull_push_constants {
-    f32     inv_projection[16];
+    f32     inv_view_projection[16];
+    u32     cluster_count_x;
+    u32     cluster_count_y;
     u32     screen_width;
     u32     screen_height;
-    u32     tile_count_x;
+    f32     z_near;
+    f32     z_far;
     u32     light_count;
+    u32     _pad;
 } r_light_cull_push_constants_t;
 
+_Static_assert(sizeof(r_light_cull_push_constants_t) <= 128,
+               "light cull push constants exceed guaranteed 128-byte minimum");
+
 typedef struct r_light_state {
     r_dynamic_light_t   lights[R_MAX_DYNAMIC_LIGHTS];
     u32                 light_count;
@@ -363,8 +390,8 @@ typedef struct r_light_state {
     VkDeviceMemory      light_memory;
     void               *light_mapped;
 
-    VkBuffer            tile_ssbo;
-    VkDeviceMemory      tile_memory;
+    VkBuffer            cluster_ssbo;
+    VkDeviceMemory      cluster_memory;
 
     VkPipeline          cull_pipeline;
     VkPipelineLayout    cull_layout;
@@ -375,8 +402,12 @@ typedef struct r_light_state {
     VkDescriptorSetLayout light_set_layout;
     VkDescriptorSet       light_descriptor_set;
 
-    u32                 tile_count_x;
-    u32                 tile_count_y;
+    u32                 cluster_count_x;
+    u32                 cluster_count_y;
+
+    // Camera depth range for the current frame (slice distribution)
+    f32                 z_near;
+    f32                 z_far;
     bool                initialized;
 } r_light_state_t;
 
@@ -400,9 +431,39 @@ typedef struct r_compose_push_constants {
 
 // --- GPU Timers ---
 
-typedef struct r_gpu_timers {
+// A named span of one frame's command buffer, bracketed by two timestamps.
+// Regions nest; parent is the enclosing region (-1 at the root).
+typedef struct r_gpu_region {
+    const char     *name;       // string literal: also the qk_prof zone name
+    i8              parent;
+    u8              depth;
+} r_gpu_region_t;
+
+// One query pool per frame in flight. The pool is read after the fence
+// wait that makes its frame reusable, so results never mix frames.
+typedef struct r_gpu_timer_frame {
     VkQueryPool     pool;
+    r_gpu_region_t  regions[R_GPU_REGION_MAX];
+    u32             region_count;
+    i8              stack[R_GPU_REGION_DEPTH];     // open regions, -1 = untimed
+    u32             stack_depth;
+    u32             overflow_depth;                 // opens past R_GPU_REGION_DEPTH
+    u64             frame_number;
+    bool            pending;        // recorded, not yet read back
+} r_gpu_timer_frame_t;
+
+typedef struct r_gpu_timers {
+    r_gpu_timer_frame_t frames[R_FRAMES_IN_FLIGHT];
+    r_gpu_timer_frame_t *recording;     // NULL outside a frame or without timestamps
     u64             results[R_TIMESTAMP_COUNT];
+    u64             timestamp_mask;     // timestampValidBits of the graphics queue
+
+    // Newest resolved frame
+    r_gpu_region_t  resolved[R_GPU_REGION_MAX];
+    f64             resolved_ms[R_GPU_REGION_MAX];
+    u32             resolved_count;
+    u64             resolved_frame;
+
     f64             gpu_frame_ms;
     f64             world_pass_ms;
     f64             ui_pass_ms;
@@ -487,7 +548,7 @@ typedef struct r_state {
     f32                     ambient;
     f32                     bloom_strength;
 
-    // Cached inverse VP for light culling compute
+    // Cached inverse VP for cluster light assignment
     f32                     inv_view_projection[16];
 
     bool                    initialized;
@@ -540,6 +601,7 @@ qk_result_t r_pipeline_create_fx(void);
 qk_result_t r_pipeline_create_ui(void);
 qk_result_t r_pipeline_create_overlay_ui(void);
 qk_result_t r_pipeline_create_compose(void);
+qk_result_t r_pipeline_warmup(void);
 void        r_pipeline_destroy_all(void);
 
 // r_world.c
@@ -565,14 +627,19 @@ void        r_ui_record_overlay_commands(VkCommandBuffer cmd, u32 frame_index);
 
 // r_bloom.c
 qk_result_t r_bloom_init(void);
+qk_result_t r_bloom_create_pipelines(void);
 void        r_bloom_shutdown(void);
 void        r_bloom_record_commands(VkCommandBuffer cmd);
 
 // r_compute.c
 qk_result_t r_compute_init(void);
+qk_result_t r_compute_create_prepass_pipeline(void);
+qk_result_t r_compute_create_cull_pipeline(void);
 void        r_compute_shutdown(void);
 void        r_compute_upload_lights(void);
-void        r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_projection);
+void        r_compute_record_cull(VkCommandBuffer cmd, const f32 *inv_view_projection);
+void        r_compute_cluster_slice_params(f32 z_near, f32 z_far,
+                                           f32 *out_scale, f32 *out_bias);
 void        r_depth_prepass_record(VkCommandBuffer cmd, u32 frame_index);
 
 // r_compose.c
@@ -586,6 +653,7 @@ qk_result_t r_texture_init(void);
 void        r_texture_shutdown(void);
 u32         r_texture_upload(const u8 *pixels, u32 width, u32 height, u32 channels, bool nearest);
 VkDescriptorSet r_texture_get_descriptor(u32 texture_id);
+bool        r_texture_is_sdf(u32 texture_id);
 
 // r_debug.c
 qk_result_t r_debug_init(void);
@@ -594,8 +662,24 @@ void        r_debug_begin_label(VkCommandBuffer cmd, const char *name, float r,
 void        r_debug_end_label(VkCommandBuffer cmd);
 void        r_debug_timers_init(void);
 void        r_debug_timers_shutdown(void);
-void        r_debug_timestamp_write(VkCommandBuffer cmd, VkPipelineStageFlagBits stage, u32 query);
-void        r_debug_timers_read(void);
+void        r_debug_timers_begin_frame(VkCommandBuffer cmd, u32 frame_index, u64 frame_number);
+void        r_debug_timers_end_frame(void);
+void        r_debug_timers_read(u32 frame_index);
+void        r_debug_region_begin(VkCommandBuffer cmd, const char *name);
+void        r_debug_region_end(VkCommandBuffer cmd);
+
+// Debug label plus GPU timing for one scope. name must be a string literal;
+// it becomes the qk_prof zone the resolved time is reported under.
+#define R_GPU_SCOPE_BEGIN(cmd, name, r, g, b) \
+    do { \
+        r_debug_begin_label((cmd), (name), (r), (g), (b)); \
+        r_debug_region_begin((cmd), (name)); \
+    } while (0)
+#define R_GPU_SCOPE_END(cmd) \
+    do { \
+        r_debug_region_end(cmd); \
+        r_debug_end_label(cmd); \
+    } while (0)
 
 // Render target helpers
 qk_result_t r_create_render_targets(void);
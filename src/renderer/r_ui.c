@@ -3,9 +3,23 @@
  */
 
 #include "r_types.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#define R_UI_PUSH_STAGES (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+
+// Distance-field textures (the font atlas) are thresholded in ui.frag
+static void ui_push_sdf_flag(VkCommandBuffer cmd, VkPipelineLayout layout,
+                             r_ui_push_constants_t *push, u32 texture_id)
+{
+    u32 sdf = r_texture_is_sdf(texture_id) ? 1 : 0;
+    if (sdf == push->sdf) return;
+    push->sdf = sdf;
+    vkCmdPushConstants(cmd, layout, R_UI_PUSH_STAGES,
+                       offsetof(r_ui_push_constants_t, sdf), sizeof(u32), &push->sdf);
+}
+
 qk_result_t r_ui_init(void)
 {
     /* Build pre-computed index buffer for quads:
@@ -134,13 +148,13 @@ void r_ui_record_commands(VkCommandBuffer cmd, u32 frame_index)
     };
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-    // Push screen size
-    f32 screen_size[2] = {
-        (f32)g_r.config.render_width,
-        (f32)g_r.config.render_height
+    // Push screen size; the SDF flag is re-pushed per texture batch
+    r_ui_push_constants_t push = {
+        .screen_size = { (f32)g_r.config.render_width, (f32)g_r.config.render_height },
+        .sdf = 0
     };
-    vkCmdPushConstants(cmd, g_r.ui_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT,
-                       0, sizeof(screen_size), screen_size);
+    vkCmdPushConstants(cmd, g_r.ui_pipeline.layout, R_UI_PUSH_STAGES,
+                       0, sizeof(push), &push);
 
     // Bind vertex/index buffers
     VkDeviceSize vb_offset = 0;
@@ -160,6 +174,7 @@ void r_ui_record_commands(VkCommandBuffer cmd, u32 frame_index)
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                     g_r.ui_pipeline.layout, 0, 1,
                                     &tex_desc, 0, NULL);
+            ui_push_sdf_flag(cmd, g_r.ui_pipeline.layout, &push, current_texture);
 
             u32 quad_count = i - batch_start;
             u32 first_index = batch_start * 6;
@@ -231,13 +246,13 @@ void r_ui_record_overlay_commands(VkCommandBuffer cmd, u32 frame_index)
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
     // Push swapchain dimensions as screen size
-    f32 screen_size[2] = {
-        (f32)g_r.swapchain.extent.width,
-        (f32)g_r.swapchain.extent.height
+    r_ui_push_constants_t push = {
+        .screen_size = { (f32)g_r.swapchain.extent.width,
+                         (f32)g_r.swapchain.extent.height },
+        .sdf = 0
     };
-    vkCmdPushConstants(cmd, g_r.overlay_ui_pipeline.layout,
-                       VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(screen_size),
-                       screen_size);
+    vkCmdPushConstants(cmd, g_r.overlay_ui_pipeline.layout, R_UI_PUSH_STAGES,
+                       0, sizeof(push), &push);
 
     // Bind vertex/index buffers
     VkDeviceSize vb_offset = 0;
@@ -257,6 +272,7 @@ void r_ui_record_overlay_commands(VkCommandBuffer cmd, u32 frame_index)
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                     g_r.overlay_ui_pipeline.layout, 0, 1,
                                     &tex_desc, 0, NULL);
+            ui_push_sdf_flag(cmd, g_r.overlay_ui_pipeline.layout, &push, current_texture);
 
             u32 quad_count = i - batch_start;
             u32 first_index = batch_start * 6;
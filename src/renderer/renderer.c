@@ -80,31 +80,12 @@ qk_result_t qk_renderer_init(const qk_renderer_config_t *config)
     res = r_pipeline_cache_init();
     if (res != QK_SUCCESS) return res;
 
-    /* Forward+ compute (SSBOs, depth pre-pass, light culling).
-     * MUST be before pipeline creation: world and entity pipeline layouts
+    /* Clustered Forward+ compute (SSBOs, depth pre-pass, light assignment).
+     * MUST be before pipeline warmup: world and entity pipeline layouts
      * reference g_r.lights.light_set_layout created here. */
     res = r_compute_init();
     if (res != QK_SUCCESS) return res;
 
-    // Pipelines
-    res = r_pipeline_create_world();
-    if (res != QK_SUCCESS) return res;
-
-    res = r_pipeline_create_entity();
-    if (res != QK_SUCCESS) return res;
-
-    res = r_pipeline_create_fx();
-    if (res != QK_SUCCESS) return res;
-
-    res = r_pipeline_create_ui();
-    if (res != QK_SUCCESS) return res;
-
-    res = r_pipeline_create_compose();
-    if (res != QK_SUCCESS) return res;
-
-    res = r_pipeline_create_overlay_ui();
-    if (res != QK_SUCCESS) return res;
-
     // UI index buffer
     res = r_ui_init();
     if (res != QK_SUCCESS) return res;
@@ -128,6 +109,11 @@ qk_result_t qk_renderer_init(const qk_renderer_config_t *config)
     res = r_bloom_init();
     if (res != QK_SUCCESS) return res;
 
+    /* Build every pipeline now, in parallel, so nothing compiles mid-match.
+     * After all set layouts exist (bloom's is created by r_bloom_init). */
+    res = r_pipeline_warmup();
+    if (res != QK_SUCCESS) return res;
+
     // Debug timers
     r_debug_init();
 
@@ -209,16 +195,10 @@ void qk_renderer_set_render_resolution(u32 width, u32 height)
     // Forward+ compute (needs render targets for depth pre-pass)
     r_compute_init();
 
-    // Re-create pipelines that reference render targets
+    // Re-create pipelines that reference render targets (cache is warm by now)
     r_pipeline_destroy_all();
-    r_pipeline_create_world();
-    r_pipeline_create_entity();
-    r_pipeline_create_fx();
-    r_pipeline_create_ui();
-    r_pipeline_create_compose();
-    r_pipeline_create_overlay_ui();
-
     r_bloom_init();
+    r_pipeline_warmup();
     r_compose_update_descriptors();
 }
 
@@ -356,6 +336,15 @@ qk_texture_id_t qk_renderer_upload_texture(
     return r_texture_upload(pixels, width, height, channels, nearest);
 }
 
+qk_texture_id_t qk_renderer_upload_sdf_texture(const u8 *pixels, u32 width, u32 height)
+{
+    if (!g_r.initialized) return 0;
+    r_staging_reset();
+    u32 id = r_texture_upload(pixels, width, height, 4, false);
+    if (id != 0) g_r.textures.textures[id].sdf = true;
+    return id;
+}
+
 qk_result_t qk_renderer_upload_lightmap_atlas(const u8 *pixels, u32 w, u32 h)
 {
     if (!g_r.initialized || !pixels || w == 0 || h == 0)
@@ -412,6 +401,10 @@ static void mat4_inverse(const f32 *m, f32 *out)
 
 static u64 s_start_ticks = 0;
 
+// Fallback depth range when the camera leaves z_near/z_far unset
+static const f32 R_DEFAULT_Z_NEAR = 0.1f;
+static const f32 R_DEFAULT_Z_FAR  = 4096.0f;
+
 void qk_renderer_begin_frame(const qk_camera_t *camera)
 {
     if (!g_r.initialized) return;
@@ -429,8 +422,8 @@ void qk_renderer_begin_frame(const qk_camera_t *camera)
     u64 fence_t1 = SDL_GetPerformanceCounter();
     g_r.stats_fence_wait_ms = (f32)((f64)(fence_t1 - fence_t0) / (f64)SDL_GetPerformanceFrequency() * 1000.0);
 
-    // Read GPU timers from previous frame
-    r_debug_timers_read();
+    // GPU timings recorded the last time this slot was used
+    r_debug_timers_read(fi);
 
     /* Recreate swapchain BEFORE acquire if flagged (vsync change, etc).
        Must happen after fence wait but before acquire to avoid
@@ -467,13 +460,22 @@ void qk_renderer_begin_frame(const qk_camera_t *camera)
         memcpy(uniforms.camera_pos, camera->position, sizeof(f32) * 3);
         u64 now = SDL_GetPerformanceCounter();
         uniforms.time = (f32)((f64)(now - s_start_ticks) / (f64)SDL_GetPerformanceFrequency());
-        uniforms.tile_count_x  = g_r.lights.tile_count_x;
-        uniforms.screen_width  = g_r.config.render_width;
-        uniforms.screen_height = g_r.config.render_height;
-        uniforms._pad = 0;
+        uniforms.cluster_count_x = g_r.lights.cluster_count_x;
+        uniforms.cluster_count_y = g_r.lights.cluster_count_y;
+        uniforms.screen_width    = g_r.config.render_width;
+        uniforms.screen_height   = g_r.config.render_height;
+
+        // Depth range drives the exponential cluster slices
+        g_r.lights.z_near = camera->z_near > 0.0f ? camera->z_near : R_DEFAULT_Z_NEAR;
+        g_r.lights.z_far  = camera->z_far > g_r.lights.z_near ? camera->z_far : R_DEFAULT_Z_FAR;
+        uniforms.z_near = g_r.lights.z_near;
+        uniforms.z_far  = g_r.lights.z_far;
+        r_compute_cluster_slice_params(g_r.lights.z_near, g_r.lights.z_far,
+                                       &uniforms.cluster_slice_scale,
+                                       &uniforms.cluster_slice_bias);
         memcpy(frame->view_ubo_mapped, &uniforms, sizeof(uniforms));
 
-        // Cache inverse VP for compute light culling
+        // Cache inverse VP for cluster light assignment
         mat4_inverse(camera->view_projection, g_r.inv_view_projection);
     }
 
@@ -523,6 +525,29 @@ void qk_renderer_push_ui_quad(const qk_ui_quad_t *quad)
     dst->texture_id = quad->texture_id;
 }
 
+_Static_assert(sizeof(r_ui_quad_t) == sizeof(qk_ui_quad_t),
+               "public and internal UI quads must share a layout");
+
+void qk_renderer_push_ui_quads(const qk_ui_quad_t *quads, u32 count)
+{
+    r_ui_quad_t *dst;
+    u32 room;
+
+    if (g_r.ui_overlay_active) {
+        room = R_UI_MAX_QUADS - g_r.overlay_quad_count;
+        dst = &g_r.overlay_quads[g_r.overlay_quad_count];
+    } else {
+        room = R_UI_MAX_QUADS - g_r.ui_quad_count;
+        dst = &g_r.ui_quads[g_r.ui_quad_count];
+    }
+    if (count > room) count = room;
+
+    memcpy(dst, quads, count * sizeof(*dst));
+
+    if (g_r.ui_overlay_active) g_r.overlay_quad_count += count;
+    else g_r.ui_quad_count += count;
+}
+
 void qk_renderer_end_frame(void)
 {
     if (!g_r.initialized) return;
@@ -540,25 +565,25 @@ void qk_renderer_end_frame(void)
     };
     vkBeginCommandBuffer(cmd, &begin_info);
 
-    // Reset GPU timestamp queries
-    if (g_r.gpu_timers.pool) {
-        vkCmdResetQueryPool(cmd, g_r.gpu_timers.pool, 0, R_TIMESTAMP_COUNT);
-    }
-
-    // Timestamp: frame start
-    r_debug_timestamp_write(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0);
+    // Reset this slot's GPU timestamp queries
+    r_debug_timers_begin_frame(cmd, fi, g_r.frame_index);
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_frame", 0.8f, 0.8f, 0.8f);
 
     // Upload dynamic lights to GPU SSBO
     r_compute_upload_lights();
 
+    // --- Cluster Light Assignment (always dispatch to keep cluster SSBO valid) ---
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_light_cull", 0.8f, 0.6f, 0.2f);
+    r_compute_record_cull(cmd, g_r.inv_view_projection);
+    R_GPU_SCOPE_END(cmd);
+
     // --- Depth Pre-Pass ---
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_depth_prepass", 0.5f, 0.5f, 0.5f);
     r_depth_prepass_record(cmd, fi);
-
-    // --- Light Cull Compute (always dispatch to keep tile SSBO valid) ---
-    r_compute_record_cull(cmd, g_r.inv_view_projection);
+    R_GPU_SCOPE_END(cmd);
 
     // --- Pass 1: World + UI ---
-    r_debug_begin_label(cmd, "World Pass", 0.2f, 0.8f, 0.2f);
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_world", 0.2f, 0.8f, 0.2f);
     {
         VkClearValue clears[2] = {
             { .color = { .float32 = { 0.1f, 0.1f, 0.15f, 1.0f } } },
@@ -575,30 +600,34 @@ void qk_renderer_end_frame(void)
         };
 
         vkCmdBeginRenderPass(cmd, &rp_info, VK_SUBPASS_CONTENTS_INLINE);
+        R_GPU_SCOPE_BEGIN(cmd, "gpu_world_geo", 0.2f, 0.7f, 0.2f);
         r_world_record_commands(cmd, fi);
+        R_GPU_SCOPE_END(cmd);
+        R_GPU_SCOPE_BEGIN(cmd, "gpu_entities", 0.2f, 0.7f, 0.5f);
         r_entity_record_commands(cmd, fi);
+        R_GPU_SCOPE_END(cmd);
+        R_GPU_SCOPE_BEGIN(cmd, "gpu_fx", 0.9f, 0.5f, 0.1f);
         r_fx_record_commands(cmd, fi);
+        R_GPU_SCOPE_END(cmd);
+        R_GPU_SCOPE_BEGIN(cmd, "gpu_ui", 0.7f, 0.7f, 0.2f);
         r_ui_record_commands(cmd, fi);
+        R_GPU_SCOPE_END(cmd);
         vkCmdEndRenderPass(cmd);
     }
-    r_debug_end_label(cmd);
-
-    // Timestamp: after world + UI
-    r_debug_timestamp_write(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 1);
+    R_GPU_SCOPE_END(cmd);
 
     // --- Bloom pass ---
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_bloom", 0.9f, 0.3f, 0.6f);
     r_bloom_record_commands(cmd);
-
-    // Timestamp: after bloom
-    r_debug_timestamp_write(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 2);
+    R_GPU_SCOPE_END(cmd);
 
     // --- Pass 2: Composition ---
-    r_debug_begin_label(cmd, "Compose Pass", 0.2f, 0.2f, 0.8f);
+    R_GPU_SCOPE_BEGIN(cmd, "gpu_compose", 0.2f, 0.2f, 0.8f);
     r_compose_record_commands(cmd, g_r.current_image_index, fi);
-    r_debug_end_label(cmd);
+    R_GPU_SCOPE_END(cmd);
 
-    // Timestamp: after compose
-    r_debug_timestamp_write(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 3);
+    R_GPU_SCOPE_END(cmd);
+    r_debug_timers_end_frame();
 
     vkEndCommandBuffer(cmd);
 
@@ -655,3 +684,20 @@ void qk_renderer_get_stats(qk_gpu_stats_t *out_stats)
     out_stats->fence_wait_ms  = g_r.stats_fence_wait_ms;
     out_stats->acquire_ms     = g_r.stats_acquire_ms;
 }
+
+u32 qk_renderer_get_gpu_regions(qk_gpu_region_t *out_regions, u32 max_regions,
+                                u64 *out_frame)
+{
+    const r_gpu_timers_t *t = &g_r.gpu_timers;
+    u32 count = t->resolved_count < max_regions ? t->resolved_count : max_regions;
+    for (u32 i = 0; i < count; i++) {
+        out_regions[i] = (qk_gpu_region_t){
+            .name   = t->resolved[i].name,
+            .parent = t->resolved[i].parent,
+            .depth  = t->resolved[i].depth,
+            .ms     = t->resolved_ms[i],
+        };
+    }
+    if (out_frame) *out_frame = t->resolved_frame;
+    return count;
+}
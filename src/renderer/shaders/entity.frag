@@ -8,10 +8,14 @@ layout(set = 0, binding = 0) uniform ViewUniforms {
     mat4 view_projection;
     vec3 camera_pos;
     float time;
-    uint tile_count_x;
+    uint cluster_count_x;
+    uint cluster_count_y;
     uint screen_width;
     uint screen_height;
-    uint _pad;
+    float z_near;
+    float z_far;
+    float cluster_slice_scale;
+    float cluster_slice_bias;
 } view;
 
 /* Dynamic light SSBOs (set 1 for entity pipeline) */
@@ -30,12 +34,25 @@ layout(set = 1, binding = 0, std430) readonly buffer LightBuffer {
     DynamicLight lights[];
 } light_buf;
 
-layout(set = 1, binding = 1, std430) readonly buffer TileBuffer {
+layout(set = 1, binding = 1, std430) readonly buffer ClusterBuffer {
     uint data[];
-} tile_buf;
+} cluster_buf;
 
 layout(location = 0) out vec4 out_color;
 
+/* Cluster lookup: 64x64 pixel tile plus exponential depth slice.
+ * View depth is recovered from the [0,1] window depth. */
+uint cluster_index() {
+    float a = view.z_far / (view.z_near - view.z_far);
+    float b = (view.z_near * view.z_far) / (view.z_near - view.z_far);
+    float view_depth = b / (gl_FragCoord.z + a);
+    uint slice = uint(clamp(log(view_depth) * view.cluster_slice_scale + view.cluster_slice_bias,
+                            0.0, 23.0));
+    uvec2 tile = min(uvec2(gl_FragCoord.xy) / 64u,
+                     uvec2(view.cluster_count_x - 1u, view.cluster_count_y - 1u));
+    return (slice * view.cluster_count_y + tile.y) * view.cluster_count_x + tile.x;
+}
+
 void main() {
     vec3 light_dir = normalize(vec3(0.5, 1.0, 0.3));
     vec3 n = normalize(frag_normal);
@@ -43,15 +60,13 @@ void main() {
     float ambient = 0.25;
     float diffuse = ndotl * 0.75;
 
-    // Dynamic light accumulation from Forward+ tile
-    ivec2 tile = ivec2(gl_FragCoord.xy) / 16;
-    uint tile_idx = uint(tile.y) * view.tile_count_x + uint(tile.x);
-    uint base = tile_idx * 65u;
-    uint n_lights = tile_buf.data[base];
+    // Dynamic light accumulation from this fragment's light cluster
+    uint base = cluster_index() * 65u;
+    uint n_lights = cluster_buf.data[base];
 
     vec3 dynamic_lighting = vec3(0.0);
     for (uint i = 0u; i < n_lights; i++) {
-        uint light_idx = tile_buf.data[base + 1u + i];
+        uint light_idx = cluster_buf.data[base + 1u + i];
         DynamicLight light = light_buf.lights[light_idx];
 
         vec3 to_light = light.position - frag_world_pos;
@@ -7,10 +7,14 @@ layout(set = 0, binding = 0) uniform ViewUniforms {
     mat4 view_projection;
     vec3 camera_pos;
     float time;
-    uint tile_count_x;
+    uint cluster_count_x;
+    uint cluster_count_y;
     uint screen_width;
     uint screen_height;
-    uint _pad;
+    float z_near;
+    float z_far;
+    float cluster_slice_scale;
+    float cluster_slice_bias;
 } view;
 
 layout(push_constant) uniform EntityPush {
@@ -5,9 +5,21 @@ layout(location = 1) in vec4 frag_color;
 
 layout(set = 0, binding = 0) uniform sampler2D ui_texture;
 
+layout(push_constant) uniform UIParams {
+    layout(offset = 8) uint sdf;    // texture alpha is a distance field
+} params;
+
 layout(location = 0) out vec4 out_color;
 
 void main() {
     vec4 tex = texture(ui_texture, frag_uv);
+    if (params.sdf != 0u) {
+        // Edge at 0.5, antialiased over one screen pixel at any scale
+        float dist = tex.a;
+        float w = max(fwidth(dist) * 0.5, 1.0 / 255.0);
+        float coverage = smoothstep(0.5 - w, 0.5 + w, dist);
+        out_color = vec4(coverage) * frag_color;
+        return;
+    }
     out_color = tex * frag_color;
 }
@@ -20,7 +20,20 @@
 #include "gameplay/qk_gameplay.h"
 #include "core/qk_prof.h"
 #include "core/qk_cpuid.h"
+#include "core/qk_job.h"
+#include "core/qk_scratch.h"
 #include "core/qk_simd_dispatch.h"
+#include "core/qk_tick_budget.h"
+
+// Deferred housekeeping still runs at least this often
+static const f64 SERVER_HOUSEKEEPING_MAX_DEFER_SEC = 1.0;
+// Server arena: game and netcode state (~4 MB) plus the packed collision
+// model (brush + planes with bevels, well under 512 bytes per brush)
+static const u64 SERVER_ARENA_BASE_SIZE = (u64)8 * 1024 * 1024;
+static const u64 SERVER_ARENA_PER_BRUSH = 512;
+// Job workers run short leaf jobs; a bounded stack keeps -mlock from
+// pinning the default 8 MB per worker
+static const u64 SERVER_JOB_STACK_SIZE = (u64)256 * 1024;
 
 // --- Shutdown signal ---
 
@@ -49,7 +62,8 @@ static bool s_client_ready[QK_MAX_PLAYERS];
 
 static void detect_remote_players(void) {
     for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
-        bool ready = qk_net_server_is_client_map_ready(i);
+        // Spectator relays only watch: no player for them
+        bool ready = qk_net_server_is_client_player(i);
         if (ready && !s_client_ready[i]) {
             printf("Player %u connected.\n", (u32)i);
             qk_game_player_connect(i, "Player", QK_TEAM_ALPHA);
@@ -68,7 +82,20 @@ static void detect_remote_players(void) {
 
 // --- Server tick ---
 
+static qk_tick_budget_t s_budget;
+
+// Spectators can live with a coarser view when the server is over budget
+static void update_snapshot_priority(void) {
+    for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
+        const qk_player_state_t *ps = s_client_ready[i] ? qk_game_get_player_state(i) : NULL;
+        qk_net_server_set_client_low_priority(i, ps && ps->alive_state == QK_PSTATE_SPECTATING);
+    }
+}
+
 static void server_tick(qk_phys_world_t *phys_world) {
+    qk_tick_budget_begin_tick(&s_budget, qk_platform_time_now());
+    qk_scratch_advance(QK_SCRATCH_TICK);
+
     // Read inputs from all connected clients
     for (u8 i = 0; i < QK_MAX_PLAYERS; i++) {
         qk_usercmd_t cmd;
@@ -76,9 +103,16 @@ static void server_tick(qk_phys_world_t *phys_world) {
             qk_game_player_command(i, &cmd);
         }
     }
+    qk_tick_budget_mark(&s_budget, QK_TICK_PHASE_INPUT, qk_platform_time_now());
 
     // Run gameplay tick
     qk_game_tick(phys_world, QK_TICK_DT);
+    qk_tick_budget_mark(&s_budget, QK_TICK_PHASE_SIM, qk_platform_time_now());
+
+    // Game events ride the snapshots
+    n_game_event_t net_events[QK_GAME_MAX_TICK_EVENTS];
+    u32 net_count = qk_game_pack_events(net_events, QK_GAME_MAX_TICK_EVENTS);
+    qk_net_server_push_events(net_events, net_count);
 
     // Pack entity states for netcode
     for (u32 i = 0; i < qk_game_get_entity_count(); i++) {
@@ -90,9 +124,34 @@ static void server_tick(qk_phys_world_t *phys_world) {
             qk_net_server_set_entity((u8)i, &net_state);
         }
     }
+    update_snapshot_priority();
+    qk_tick_budget_mark(&s_budget, QK_TICK_PHASE_SNAPSHOT, qk_platform_time_now());
 
     // Netcode broadcasts snapshots
     qk_net_server_tick();
+    qk_tick_budget_mark(&s_budget, QK_TICK_PHASE_SEND, qk_platform_time_now());
+    qk_tick_budget_end_tick(&s_budget, qk_platform_time_now());
+}
+
+// --- Housekeeping ---
+
+static void report_tick_budget(void) {
+    qk_degrade_event_t ev;
+    while (qk_tick_budget_pop_event(&s_budget, &ev)) {
+        printf("Tick budget: %s -> %s (load %.2f, tick %llu, dropped %llu)\n",
+               qk_degrade_level_name(ev.from), qk_degrade_level_name(ev.to), ev.load,
+               (unsigned long long)ev.tick, (unsigned long long)s_budget.ticks_dropped);
+    }
+    QK_PROF_COUNTER("tick_degrade_level", (u32)s_budget.level);
+    QK_PROF_COUNTER("game_events_lost", qk_game_get_events_lost());
+}
+
+static void flush_housekeeping(void) {
+    QK_PROF_ZONE_ADD("tick_input", s_budget.phase_ms[QK_TICK_PHASE_INPUT]);
+    QK_PROF_ZONE_ADD("tick_sim", s_budget.phase_ms[QK_TICK_PHASE_SIM]);
+    QK_PROF_ZONE_ADD("tick_snapshot", s_budget.phase_ms[QK_TICK_PHASE_SNAPSHOT]);
+    QK_PROF_ZONE_ADD("tick_send", s_budget.phase_ms[QK_TICK_PHASE_SEND]);
+    qk_job_prof_flush();
 }
 
 // --- Main ---
@@ -110,12 +169,18 @@ int main(int argc, char *argv[]) {
 #endif
     qk_cpuid_print();
     printf("SIMD tier: %s\n", qk_simd_tier_name(qk_simd_get_tier()));
+    qk_job_init(&(qk_job_config_t){ .worker_count = 0, .pin = QK_JOB_PIN_NONE,
+                                     .stack_size = SERVER_JOB_STACK_SIZE });
     printf("\n");
 
     // --- Parse arguments ---
     const char *map_name = NULL;
     u16 port = 27960;
     u32 max_clients = QK_MAX_PLAYERS;
+    i32 pin_core = -1;
+    u32 rt_priority = 0;
+    bool lock_memory = false;
+    bool huge_pages = false;
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-map") == 0 && i + 1 < argc) {
@@ -126,11 +191,20 @@ int main(int argc, char *argv[]) {
             max_clients = (u32)atoi(argv[++i]);
             if (max_clients > QK_MAX_PLAYERS) max_clients = QK_MAX_PLAYERS;
             if (max_clients == 0) max_clients = 1;
+        } else if (strcmp(argv[i], "-pin") == 0 && i + 1 < argc) {
+            pin_core = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-rt") == 0 && i + 1 < argc) {
+            rt_priority = (u32)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-mlock") == 0) {
+            lock_memory = true;
+        } else if (strcmp(argv[i], "-hugepages") == 0) {
+            huge_pages = true;
         }
     }
 
     if (!map_name) {
-        fprintf(stderr, "Usage: quicken-server -map <name> [-port %u] [-maxclients %u]\n",
+        fprintf(stderr, "Usage: quicken-server -map <name> [-port %u] [-maxclients %u]\n"
+                        "                      [-pin <core>] [-rt <1-99>] [-mlock] [-hugepages]\n",
                 27960, QK_MAX_PLAYERS);
         return 1;
     }
@@ -178,16 +252,33 @@ int main(int argc, char *argv[]) {
     }
     printf("Map loaded: %s\n", path);
 
+    // --- Server arena ---
+    // Everything the tick walks, packed together; with -hugepages it sits
+    // on a few 2 MB pages instead of hundreds of 4 KB ones
+    u64 arena_size = SERVER_ARENA_BASE_SIZE +
+                     (u64)map_data.collision.brush_count * SERVER_ARENA_PER_BRUSH;
+    qk_arena_t *server_arena = qk_arena_create_ex(
+        arena_size, huge_pages ? QK_ARENA_HUGETLB : 0);
+    if (!server_arena) {
+        fprintf(stderr, "FATAL: Failed to reserve server arena\n");
+        return 1;
+    }
+    if (huge_pages && !qk_arena_has_huge_pages(server_arena)) {
+        fprintf(stderr, "Warning: Huge pages unavailable, using 4 KB pages\n");
+    }
+
     // --- Init physics ---
     qk_phys_world_t *phys_world = NULL;
     if (map_data.collision.brush_count > 0)
+        phys_world = qk_physics_world_create_in(&map_data.collision, server_arena);
+    if (!phys_world && map_data.collision.brush_count > 0)
         phys_world = qk_physics_world_create(&map_data.collision);
     if (!phys_world)
         phys_world = qk_physics_world_create_test_room();
     printf("Physics world: OK (%u brushes)\n", map_data.collision.brush_count);
 
     // --- Init gameplay ---
-    qk_game_config_t gc = {0};
+    qk_game_config_t gc = { .arena = server_arena };
     res = qk_game_init(&gc);
     if (res != QK_SUCCESS) {
         fprintf(stderr, "FATAL: Failed to init gameplay (%d)\n", res);
@@ -203,6 +294,7 @@ int main(int argc, char *argv[]) {
         .server_port = port,
         .max_clients = max_clients,
         .tick_rate = (f64)QK_TICK_RATE,
+        .arena = server_arena,
     };
 
     res = qk_net_server_init(&nsc);
@@ -212,18 +304,56 @@ int main(int argc, char *argv[]) {
     }
     qk_net_server_set_map(path);
     printf("Server listening on port %u (max %u clients)\n", (u32)port, max_clients);
+    printf("Server arena: %.1f MB used, huge pages: %s\n",
+           (f64)qk_arena_used(server_arena) / (1024.0 * 1024.0),
+           qk_arena_has_huge_pages(server_arena) ? "yes" : "no");
 
     QK_PROF_INIT();
 
+    // --- Scheduling ---
+    // Everything the tick touches is allocated by now; prefault the rest of
+    // the server arena and the tick thread's scratch so first use doesn't
+    // fault, then lock it all in.
+    if (lock_memory) {
+        if (!qk_arena_prefault(server_arena, 0)) {
+            fprintf(stderr, "Warning: Server arena prefault failed\n");
+        }
+        if (!qk_scratch_prefault()) {
+            fprintf(stderr, "Warning: Scratch prefault failed\n");
+        }
+        if (qk_platform_lock_memory()) {
+            printf("Memory locked\n");
+        } else {
+            fprintf(stderr, "Warning: mlockall refused (needs CAP_IPC_LOCK or RLIMIT_MEMLOCK), continuing unlocked\n");
+        }
+    }
+    if (pin_core >= 0) {
+        if (qk_platform_pin_thread((u32)pin_core)) {
+            printf("Tick thread pinned to core %d\n", pin_core);
+        } else {
+            fprintf(stderr, "Warning: Could not pin tick thread to core %d\n", pin_core);
+        }
+    }
+    if (rt_priority > 0) {
+        if (qk_platform_set_realtime(rt_priority)) {
+            printf("Tick thread realtime priority %u\n", rt_priority);
+        } else {
+            fprintf(stderr, "Warning: Realtime priority refused (needs CAP_SYS_NICE or rtprio limit)\n");
+        }
+    }
+
     // --- Tick loop ---
     printf("\nServer running. Press Ctrl+C to stop.\n\n");
 
     memset(s_client_ready, 0, sizeof(s_client_ready));
+    qk_tick_budget_init(&s_budget, 0.0);
     f64 prev_time = qk_platform_time_now();
+    f64 last_housekeeping = prev_time;
     f32 accumulator = 0.0f;
 
     while (s_running) {
         QK_PROF_FRAME_BEGIN();
+        qk_scratch_advance(QK_SCRATCH_FRAME);
 
         f64 now = qk_platform_time_now();
         f32 dt = (f32)(now - prev_time);
@@ -234,14 +364,25 @@ int main(int argc, char *argv[]) {
 
         accumulator += dt;
 
+        // Over budget: thin spectator snapshots, then cap catch-up
+        qk_net_server_set_low_priority_interval(
+            qk_tick_budget_at_least(&s_budget, QK_DEGRADE_THIN) ? QK_TICK_BUDGET_THIN_INTERVAL : 1);
+        u32 ticks = qk_tick_budget_ticks_due(&s_budget, &accumulator, QK_TICK_DT);
+
         QK_PROF_ZONE_BEGIN("server_tick");
-        while (accumulator >= QK_TICK_DT) {
+        for (u32 t = 0; t < ticks; t++) {
             detect_remote_players();
             server_tick(phys_world);
             accumulator -= QK_TICK_DT;
         }
         QK_PROF_ZONE_END("server_tick");
 
+        report_tick_budget();
+        if (!qk_tick_budget_at_least(&s_budget, QK_DEGRADE_DEFER) ||
+            now - last_housekeeping >= SERVER_HOUSEKEEPING_MAX_DEFER_SEC) {
+            flush_housekeeping();
+            last_housekeeping = now;
+        }
         QK_PROF_FRAME_END();
 
         /* Sleep to avoid burning CPU. Target slightly under tick interval
@@ -253,6 +394,10 @@ int main(int argc, char *argv[]) {
     }
 
     printf("\nShutting down...\n");
+    printf("Tick ms: p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f  (%llu ticks, %llu over budget)\n",
+           qk_tick_budget_percentile(&s_budget, 0.5), qk_tick_budget_percentile(&s_budget, 0.99),
+           qk_tick_budget_percentile(&s_budget, 0.999), s_budget.worst_tick_ms,
+           (unsigned long long)s_budget.ticks, (unsigned long long)s_budget.overruns);
 
     // --- Shutdown ---
 shutdown:
@@ -260,7 +405,10 @@ shutdown:
     qk_net_server_shutdown();
     qk_game_shutdown();
     qk_physics_world_destroy(phys_world);
+    qk_arena_destroy(server_arena);
     qk_map_free(&map_data);
+    qk_job_shutdown();
+    qk_scratch_shutdown();
 
     printf("Clean shutdown.\n");
     return 0;
@@ -22,6 +22,12 @@
 #include "physics/qk_physics.h"
 #include "gameplay/qk_gameplay.h"
 #include "g_internal.h"
+#include "core/qk_job.h"
+#include "core/qk_scratch.h"
+#include "core/qk_cvar.h"
+#include "core/qk_tick_budget.h"
+#include "core/qk_scrollback.h"
+#include "core/qk_platform.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -437,6 +443,689 @@ static void test_rail_impact_data(void) {
     qk_physics_world_destroy(world);
 }
 
+// --- Test 8: job_system ---
+
+#define JOB_TEST_COUNT 100000
+
+static u32 s_job_values[JOB_TEST_COUNT];
+
+static void job_test_square(void *data, u32 begin, u32 end) {
+    u32 *values = (u32 *)data;
+    for (u32 i = begin; i < end; i++) {
+        values[i] = i * 3u;
+    }
+}
+
+typedef struct {
+    qk_atomic_i32_t     leaves_run;
+    qk_job_counter_t    leaves;
+} job_test_tree_t;
+
+static void job_test_leaf(void *data) {
+    job_test_tree_t *tree = (job_test_tree_t *)data;
+    qk_atomic_add_i32(&tree->leaves_run, 1);
+}
+
+// Submits its own children and waits on them from inside a job
+static void job_test_branch(void *data) {
+    job_test_tree_t *tree = (job_test_tree_t *)data;
+    qk_job_counter_t children = {0};
+    for (u32 i = 0; i < 16; i++) {
+        qk_job_submit(job_test_leaf, tree, &children);
+    }
+    qk_job_wait(&children);
+}
+
+static void test_job_system(void) {
+    printf("\n=== Test: job_system ===\n");
+    s_current_test = "job_system";
+
+    // Inline fallback before init
+    memset(s_job_values, 0, sizeof(s_job_values));
+    qk_job_parallel_for(JOB_TEST_COUNT, 64, job_test_square, s_job_values);
+    TEST_CHECK(s_job_values[JOB_TEST_COUNT - 1] == (JOB_TEST_COUNT - 1) * 3u,
+               "parallel_for runs inline without init");
+
+    qk_job_config_t config = { .worker_count = 4, .pin = QK_JOB_PIN_NONE };
+    TEST_CHECK(qk_job_init(&config) == QK_SUCCESS, "Job system init");
+    TEST_CHECK(qk_job_thread_index() == 0, "Main thread is worker 0");
+
+    memset(s_job_values, 0, sizeof(s_job_values));
+    qk_job_parallel_for(JOB_TEST_COUNT, 64, job_test_square, s_job_values);
+    bool all_set = true;
+    for (u32 i = 0; i < JOB_TEST_COUNT; i++) {
+        if (s_job_values[i] != i * 3u) { all_set = false; break; }
+    }
+    TEST_CHECK(all_set, "parallel_for covers every index exactly once");
+
+    // Nested submit + wait, enough jobs to exercise stealing
+    job_test_tree_t tree = {0};
+    for (u32 i = 0; i < 64; i++) {
+        qk_job_submit(job_test_branch, &tree, &tree.leaves);
+    }
+    qk_job_wait(&tree.leaves);
+    TEST_CHECK(qk_job_is_done(&tree.leaves), "Counter reaches zero after wait");
+    TEST_CHECK(qk_atomic_load_i32(&tree.leaves_run) == 64 * 16,
+               "Nested jobs all ran (64 x 16)");
+
+    qk_job_shutdown();
+    TEST_CHECK(qk_job_worker_count() == 1, "Shutdown returns to inline mode");
+}
+
+// --- Test 9: scratch_arena ---
+
+static void test_scratch_arena(void) {
+    printf("\n=== Test: scratch_arena ===\n");
+    s_current_test = "scratch_arena";
+
+    // Large reservation is cheap: only touched chunks get committed
+    qk_arena_t *arena = qk_arena_create((u64)1 << 30);
+    TEST_CHECK(arena != NULL, "1 GB arena reserves without committing");
+    if (!arena) return;
+
+    u8 *a = (u8 *)qk_arena_alloc(arena, 100);
+    TEST_CHECK(a && ((uintptr_t)a & 15) == 0 && a[0] == 0 && a[99] == 0,
+               "Fresh allocation is 16-byte aligned and zeroed");
+
+    qk_arena_marker_t mark = qk_arena_mark(arena);
+    u8 *b = (u8 *)qk_arena_alloc(arena, 200000);   // crosses commit chunks
+    if (b) memset(b, 0xAB, 200000);
+    TEST_CHECK(b != NULL && qk_arena_used(arena) > 200000, "Alloc spanning commit chunks");
+    qk_arena_pop(arena, mark);
+    TEST_CHECK(qk_arena_used(arena) == mark.offset, "Pop restores marker offset");
+    TEST_CHECK(qk_arena_high_water(arena) > 200000, "High water survives pop");
+
+    void *c = qk_arena_alloc_aligned(arena, 64, 4096);
+    TEST_CHECK(c && ((uintptr_t)c & 4095) == 0, "Aligned alloc honors 4096 alignment");
+
+    u64 used = qk_arena_used(arena);
+    TEST_CHECK(qk_arena_prefault(arena, (u64)4 << 20) && qk_arena_used(arena) == used,
+               "Prefault commits ahead without allocating");
+    qk_arena_destroy(arena);
+
+    // Double buffering: last frame's data survives one advance
+    qk_arena_t *frame = qk_scratch(QK_SCRATCH_FRAME);
+    u32 *prev = frame ? (u32 *)qk_arena_alloc(frame, 4096 * sizeof(u32)) : NULL;
+    TEST_CHECK(prev != NULL, "Frame scratch available on first use");
+    if (!prev) return;
+    for (u32 i = 0; i < 4096; i++) prev[i] = i;
+
+    qk_scratch_advance(QK_SCRATCH_FRAME);
+    qk_arena_t *next = qk_scratch(QK_SCRATCH_FRAME);
+    TEST_CHECK(next != frame && qk_arena_used(next) == 0,
+               "Advance switches to a fresh buffer");
+    TEST_CHECK(prev[4095] == 4095, "Previous frame's scratch still intact");
+
+    qk_scratch_advance(QK_SCRATCH_FRAME);
+    TEST_CHECK(qk_scratch(QK_SCRATCH_FRAME) == frame && qk_arena_used(frame) == 0,
+               "Second advance recycles the first buffer");
+
+    qk_scratch_stats_t stats;
+    qk_scratch_get_stats(&stats);
+    TEST_CHECK(stats.high_water[QK_SCRATCH_FRAME] >= 4096 * sizeof(u32),
+               "Retired buffer high water reported");
+    qk_scratch_get_stats(&stats);
+    TEST_CHECK(stats.high_water[QK_SCRATCH_FRAME] == 0, "Stats read resets peak");
+
+    qk_scratch_shutdown();
+}
+
+// --- Test 10: cvar_registry ---
+
+static u32 s_cvar_cb_calls;
+
+static void cvar_test_callback(qk_cvar_t *cvar) {
+    QK_UNUSED(cvar);
+    s_cvar_cb_calls++;
+}
+
+static void test_cvar_registry(void) {
+    printf("\n=== Test: cvar_registry ===\n");
+    s_current_test = "cvar_registry";
+
+    qk_cvar_init();
+
+    char name[QK_CVAR_NAME_LEN];
+    for (u32 i = 0; i < 400; i++) {
+        snprintf(name, sizeof(name), "test_var_%u", i);
+        qk_cvar_register_int(name, (i32)i, 0, 1000, 0, NULL);
+    }
+    qk_cvar_t *cb_var = qk_cvar_register_float("test_cb", 1.0f, 0.0f, 10.0f, 0,
+                                               cvar_test_callback);
+
+    bool all_found = true;
+    for (u32 i = 0; i < 400; i++) {
+        snprintf(name, sizeof(name), "test_var_%u", i);
+        qk_cvar_t *cv = qk_cvar_find(name);
+        if (!cv || cv->value.i != (i32)i) { all_found = false; break; }
+    }
+    TEST_CHECK(all_found, "Hashed lookup finds all 400 cvars");
+    TEST_CHECK(qk_cvar_find("test_var_400") == NULL, "Unknown name misses");
+    TEST_CHECK(qk_cvar_register_int("test_var_7", 99, 0, 1000, 0, NULL) ==
+               qk_cvar_find("test_var_7"), "Duplicate registration returns existing");
+
+    u32 seen = cb_var->generation;
+    TEST_CHECK(!qk_cvar_changed(cb_var, &seen), "No change before set");
+
+    s_cvar_cb_calls = 0;
+    qk_cvar_set_float(cb_var, 2.0f);
+    qk_cvar_set_float(cb_var, 3.0f);
+    TEST_CHECK(s_cvar_cb_calls == 0, "Callback deferred out of setter");
+    TEST_CHECK(qk_cvar_changed(cb_var, &seen), "Generation reports change");
+    TEST_CHECK(!qk_cvar_changed(cb_var, &seen), "Change consumed after check");
+
+    qk_cvar_dispatch_callbacks();
+    TEST_CHECK(s_cvar_cb_calls == 1, "Two sets dispatch one callback");
+
+    u32 global = qk_cvar_global_generation();
+    qk_cvar_set_float(cb_var, 3.0f);
+    qk_cvar_dispatch_callbacks();
+    TEST_CHECK(s_cvar_cb_calls == 1 && qk_cvar_global_generation() == global,
+               "Setting the same value is not a change");
+
+    qk_cvar_reset(cb_var);
+    qk_cvar_dispatch_callbacks();
+    TEST_CHECK(cb_var->value.f == 1.0f && s_cvar_cb_calls == 2,
+               "Reset changes value and queues callback");
+
+    qk_cvar_shutdown();
+}
+
+// --- Test 11: subtick_fire ---
+
+static void test_subtick_fire(void) {
+    printf("\n=== Test: subtick_fire ===\n");
+    s_current_test = "subtick_fire";
+
+    TEST_CHECK(qk_subtick_encode(0.0f) == 1 && qk_subtick_encode(1.0f) == 255,
+               "Sub-tick encoding spans 1..255");
+    f32 frac = qk_subtick_fraction(qk_subtick_encode(0.37f));
+    TEST_CHECK(frac > 0.365f && frac < 0.375f, "Sub-tick fraction round-trips");
+
+    qk_phys_world_t *world = qk_physics_world_create_test_room();
+    qk_game_config_t gc = {0};
+    qk_game_init(&gc);
+
+    setup_player(0, "Attacker", QK_TEAM_ALPHA, (vec3_t){0, 0, 24},
+                 QK_WEAPON_RAIL);
+    setup_player(1, "Target", QK_TEAM_BETA, (vec3_t){200, 0, 24},
+                 QK_WEAPON_ROCKET);
+
+    qk_game_state_t *gs = qk_game_get_state();
+    gs->ca.state = CA_STATE_PLAYING;
+    gs->ca.state_timer_ms = 120000;
+
+    // Clicked while facing the target (+X), then turned away within the tick
+    qk_usercmd_t cmd = {0};
+    cmd.yaw = 90.0f;
+    cmd.buttons = QK_BUTTON_ATTACK;
+    cmd.attack_subtick = qk_subtick_encode(0.5f);
+    cmd.attack_yaw = 0.0f;
+    cmd.attack_pitch = 0.0f;
+
+    qk_game_player_command(0, &cmd);
+    qk_game_tick(world, QK_TICK_DT);
+
+    qk_player_state_t *target = qk_game_get_player_state_mut(1);
+    const qk_player_state_t *attacker = qk_game_get_player_state(0);
+    TEST_CHECK(target->health + target->armor < QK_CA_SPAWN_HEALTH + QK_CA_SPAWN_ARMOR,
+               "Shot uses the view angles at the click");
+    TEST_CHECK(attacker->yaw == 90.0f, "Tick view angles restored after the shot");
+    TEST_CHECK(attacker->weapon_time > 0, "Sub-tick shot starts the cooldown");
+
+    // Same command without a press edge fires along the tick angles and misses
+    target->health = QK_CA_SPAWN_HEALTH;
+    target->armor = QK_CA_SPAWN_ARMOR;
+    qk_game_get_player_state_mut(0)->weapon_time = 0;
+    cmd.attack_subtick = QK_SUBTICK_NONE;
+
+    qk_game_player_command(0, &cmd);
+    qk_game_tick(world, QK_TICK_DT);
+
+    TEST_CHECK(target->health + target->armor == QK_CA_SPAWN_HEALTH + QK_CA_SPAWN_ARMOR,
+               "Tick-aligned shot fires along the tick angles");
+
+    qk_game_shutdown();
+    qk_physics_world_destroy(world);
+}
+
+// --- Test 12: tick_budget ---
+
+static void test_tick_budget(void) {
+    printf("\n=== Test: tick_budget ===\n");
+    s_current_test = "tick_budget";
+
+    // Virtual clock server loop: ticks cost 3 ms, 15 ms during the spike
+    static const f64 NORMAL_COST = 0.003;
+    static const f64 SPIKE_COST  = 0.015;
+    static const u64 SPIKE_BEGIN = 256;
+    static const u64 SPIKE_END   = 1024;
+
+    qk_tick_budget_t tb;
+    qk_tick_budget_init(&tb, 0.0);
+
+    f64 clock = 0.0;
+    f64 prev_frame = 0.0;
+    f32 accumulator = 0.0f;
+    u32 max_ticks_frame = 0;
+    u32 max_ticks_capped = 0;
+    f32 max_backlog = 0.0f;
+    bool reached_cap = false;
+    bool phases_add_up = true;
+    u64 recovered_at = 0;
+
+    for (u32 frame = 0; frame < 20000 && !recovered_at; frame++) {
+        f32 dt = (f32)(clock - prev_frame);
+        prev_frame = clock;
+        if (dt > 0.1f) dt = 0.1f;
+        accumulator += dt;
+
+        bool capped = qk_tick_budget_at_least(&tb, QK_DEGRADE_CAP);
+        u32 ticks = qk_tick_budget_ticks_due(&tb, &accumulator, QK_TICK_DT);
+        if (ticks > max_ticks_frame) max_ticks_frame = ticks;
+        if (capped && ticks > max_ticks_capped) max_ticks_capped = ticks;
+
+        for (u32 t = 0; t < ticks; t++) {
+            bool spike = tb.ticks >= SPIKE_BEGIN && tb.ticks < SPIKE_END;
+            f64 cost = spike ? SPIKE_COST : NORMAL_COST;
+
+            qk_tick_budget_begin_tick(&tb, clock);
+            for (u32 p = 0; p < QK_TICK_PHASE_COUNT; p++) {
+                clock += cost / QK_TICK_PHASE_COUNT;
+                qk_tick_budget_mark(&tb, (qk_tick_phase_t)p, clock);
+            }
+            qk_tick_budget_end_tick(&tb, clock);
+            accumulator -= QK_TICK_DT;
+
+            f64 sum = 0.0;
+            for (u32 p = 0; p < QK_TICK_PHASE_COUNT; p++) sum += tb.phase_ms[p];
+            if (fabs(sum - tb.tick_ms) > 0.001) phases_add_up = false;
+
+            if (tb.level == QK_DEGRADE_CAP) reached_cap = true;
+            if (tb.ticks > SPIKE_END && reached_cap && tb.level == QK_DEGRADE_NONE &&
+                !recovered_at) {
+                recovered_at = tb.ticks;
+            }
+        }
+        if (accumulator > max_backlog) max_backlog = accumulator;
+
+        // Sleep until the next tick is due
+        if (accumulator < QK_TICK_DT) clock += QK_TICK_DT - accumulator;
+    }
+
+    u64 recovery = recovered_at ? recovered_at - SPIKE_END : 0;
+    printf("    [DEBUG] overruns=%llu dropped=%llu worst=%.1fms recovery=%llu ticks\n",
+           (unsigned long long)tb.overruns, (unsigned long long)tb.ticks_dropped,
+           tb.worst_tick_ms, (unsigned long long)recovery);
+
+    TEST_CHECK(phases_add_up, "Phase times add up to the tick time");
+    TEST_CHECK(reached_cap, "Sustained overload escalates to capped catch-up");
+    TEST_CHECK(max_ticks_frame <= QK_TICK_BUDGET_CATCHUP_MAX, "Catch-up never exceeds the limit");
+    TEST_CHECK(max_ticks_capped <= QK_TICK_BUDGET_CATCHUP_CAPPED, "Capped frames run at most the cap");
+    TEST_CHECK(tb.ticks_dropped > 0 && tb.overruns > 0, "Backlog dropped, overruns counted");
+    TEST_CHECK(max_backlog < (f32)(QK_TICK_BUDGET_CATCHUP_MAX + 1) * QK_TICK_DT,
+               "Accumulator backlog stays bounded");
+    TEST_CHECK(recovered_at && recovery <= 3 * QK_TICK_BUDGET_LOWER_HOLD + 64,
+               "Back to no degradation within a bounded number of ticks");
+    f64 p25 = qk_tick_budget_percentile(&tb, 0.25);
+    f64 p999 = qk_tick_budget_percentile(&tb, 0.999);
+    TEST_CHECK(p25 >= 2.75 && p25 <= 3.25 && p999 >= 14.75 && p999 <= 15.25,
+               "Histogram percentiles find the normal and spike tick costs");
+
+    // Up one level at a time, then down one at a time
+    qk_degrade_event_t ev;
+    u32 events = 0;
+    bool stepwise = true;
+    while (qk_tick_budget_pop_event(&tb, &ev)) {
+        qk_degrade_level_t expect_from = events < 3 ? (qk_degrade_level_t)events
+                                                    : (qk_degrade_level_t)(6 - events);
+        i32 step = (i32)ev.to - (i32)ev.from;
+        if (ev.from != expect_from || step != (events < 3 ? 1 : -1)) stepwise = false;
+        events++;
+    }
+    TEST_CHECK(events == 6 && stepwise, "Six single-step degradation events exported");
+}
+
+// --- Test 13: trace_hugepages ---
+
+static u32 s_bench_rng;
+
+static f32 bench_rand(f32 lo, f32 hi) {
+    s_bench_rng = s_bench_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (f32)(s_bench_rng >> 8) / (f32)(1u << 24);
+}
+
+// Scattered boxes with a corner cut, planes malloc'd per brush like the map loaders
+static qk_collision_model_t *bench_make_model(u32 brush_count) {
+    qk_collision_model_t *cm = (qk_collision_model_t *)malloc(sizeof(qk_collision_model_t));
+    cm->brushes = (qk_brush_t *)calloc(brush_count, sizeof(qk_brush_t));
+    cm->brush_count = brush_count;
+
+    s_bench_rng = 12345;
+    for (u32 i = 0; i < brush_count; i++) {
+        f32 x = bench_rand(-4096.0f, 4096.0f), y = bench_rand(-4096.0f, 4096.0f);
+        f32 z = bench_rand(0.0f, 1024.0f), h = bench_rand(16.0f, 96.0f);
+
+        qk_brush_t *b = &cm->brushes[i];
+        b->plane_count = 7;
+        b->planes = (qk_plane_t *)malloc(7 * sizeof(qk_plane_t));
+        b->planes[0] = (qk_plane_t){ { 1, 0, 0 },  x + h };
+        b->planes[1] = (qk_plane_t){ {-1, 0, 0 }, -(x - h) };
+        b->planes[2] = (qk_plane_t){ { 0, 1, 0 },  y + h };
+        b->planes[3] = (qk_plane_t){ { 0,-1, 0 }, -(y - h) };
+        b->planes[4] = (qk_plane_t){ { 0, 0, 1 },  z + h };
+        b->planes[5] = (qk_plane_t){ { 0, 0,-1 }, -(z - h) };
+        b->planes[6] = (qk_plane_t){ { 0.70710678f, 0.70710678f, 0 },
+                                     0.70710678f * (x + y + h) };
+    }
+    return cm;
+}
+
+static void bench_free_model(qk_collision_model_t *cm) {
+    for (u32 i = 0; i < cm->brush_count; i++) free(cm->brushes[i].planes);
+    free(cm->brushes);
+    free(cm);
+}
+
+// Traces per second over a fixed random set; the checksum must match across layouts
+static f64 bench_traces(const qk_phys_world_t *world, u32 count, f64 *out_checksum) {
+    vec3_t mins = { -15, -15, -24 }, maxs = { 15, 15, 32 };
+    f64 checksum = 0.0;
+
+    s_bench_rng = 777;
+    f64 start = qk_platform_time_now();
+    for (u32 i = 0; i < count; i++) {
+        vec3_t a = { bench_rand(-4096, 4096), bench_rand(-4096, 4096), bench_rand(0, 1024) };
+        vec3_t b = { a.x + bench_rand(-512, 512), a.y + bench_rand(-512, 512),
+                     a.z + bench_rand(-256, 256) };
+        qk_trace_result_t r = qk_physics_trace(world, a, b, mins, maxs);
+        checksum += r.fraction + r.end_pos.x * 1e-3;
+    }
+    f64 elapsed = qk_platform_time_now() - start;
+
+    *out_checksum = checksum;
+    return elapsed > 0.0 ? (f64)count / elapsed : 0.0;
+}
+
+static void test_trace_hugepages(void) {
+    printf("\n=== Test: trace_hugepages ===\n");
+    s_current_test = "trace_hugepages";
+
+    static const u32 BRUSHES = 4096;
+    static const u32 TRACES  = 4096;
+
+    // Same model three ways: heap as loaded, packed in 4 KB pages, packed in 2 MB pages
+    qk_collision_model_t *cm_heap = bench_make_model(BRUSHES);
+    qk_collision_model_t *cm_small = bench_make_model(BRUSHES);
+    qk_collision_model_t *cm_huge = bench_make_model(BRUSHES);
+    qk_arena_t *small = qk_arena_create((u64)16 << 20);
+    qk_arena_t *huge = qk_arena_create_ex((u64)16 << 20, QK_ARENA_HUGE_PAGES);
+
+    qk_phys_world_t *w_heap = qk_physics_world_create(cm_heap);
+    qk_phys_world_t *w_small = qk_physics_world_create_in(cm_small, small);
+    qk_phys_world_t *w_huge = qk_physics_world_create_in(cm_huge, huge);
+    TEST_CHECK(w_heap && w_small && w_huge, "Worlds created on heap and in arenas");
+    if (!w_heap || !w_small || !w_huge) return;
+
+    // Packed copies are independent of the source model
+    bench_free_model(cm_small);
+    bench_free_model(cm_huge);
+
+    f64 sum_heap, sum_small, sum_huge;
+    bench_traces(w_heap, TRACES / 4, &sum_heap);    // warm caches and page tables
+    f64 tps_heap = bench_traces(w_heap, TRACES, &sum_heap);
+    f64 tps_small = bench_traces(w_small, TRACES, &sum_small);
+    f64 tps_huge = bench_traces(w_huge, TRACES, &sum_huge);
+
+    printf("    [DEBUG] traces/s heap=%.0f packed=%.0f packed_huge=%.0f (huge pages %s)\n",
+           tps_heap, tps_small, tps_huge, qk_arena_has_huge_pages(huge) ? "granted" : "refused");
+    TEST_CHECK(sum_small == sum_heap && sum_huge == sum_heap,
+               "Packed worlds trace identically to the heap world");
+
+    qk_physics_world_destroy(w_heap);
+    qk_physics_world_destroy(w_small);    // no-op: arena owns it
+    qk_physics_world_destroy(w_huge);
+    bench_free_model(cm_heap);
+    qk_arena_destroy(small);
+    qk_arena_destroy(huge);
+}
+
+// --- Test 14: ca_events ---
+
+static void test_ca_events(void) {
+    printf("\n=== Test: ca_events ===\n");
+    s_current_test = "ca_events";
+
+    qk_phys_world_t *world = qk_physics_world_create_test_room();
+    qk_game_config_t gc = {0};
+    gc.countdown_time_ms = 100;
+    gc.round_time_limit_ms = 10000;
+    qk_game_init(&gc);
+
+    setup_player(0, "Alpha1", QK_TEAM_ALPHA, (vec3_t){-100, 0, 24}, QK_WEAPON_RAIL);
+    setup_player(1, "Alpha2", QK_TEAM_ALPHA, (vec3_t){-100, 50, 24}, QK_WEAPON_RAIL);
+    setup_player(2, "Beta1", QK_TEAM_BETA, (vec3_t){100, 0, 24}, QK_WEAPON_RAIL);
+
+    qk_game_state_t *gs = qk_game_get_state();
+    g_ca_start_countdown(gs);
+    for (int i = 0; i < 20; i++) {
+        qk_game_tick(world, QK_TICK_DT);
+    }
+
+    const qk_ca_state_t *ca = qk_game_get_ca_state();
+    printf("    [DEBUG] state=%u alive=%u/%u timer=%u ms\n", (u32)ca->state,
+           (u32)ca->alive_alpha, (u32)ca->alive_beta, ca->state_timer_ms);
+    TEST_CHECK(ca->state == CA_STATE_PLAYING, "Round started after countdown");
+    TEST_CHECK(ca->alive_alpha == 2 && ca->alive_beta == 1, "Alive counts set at spawn");
+    TEST_CHECK(ca->state_timer_ms > 9800 && ca->state_timer_ms <= 10000,
+               "Remaining time derived from the round deadline");
+
+    // First spawn of a team is the one farthest from the enemy spawns
+    const qk_player_state_t *first = qk_game_get_player_state(0);
+    TEST_CHECK(fabsf(first->origin.x - 200.0f) < 1.0f, "Alpha's first spawn is its safest");
+
+    // A kill updates the count at once; elimination ends the round next tick
+    u8 beta_id = gs->entities.entities[gs->player_entity[2]].id;
+    g_combat_kill(gs, 0, beta_id, QK_WEAPON_RAIL);
+    TEST_CHECK(ca->alive_beta == 0, "Kill decrements the alive count");
+
+    qk_game_tick(world, QK_TICK_DT);
+    ca = qk_game_get_ca_state();
+    TEST_CHECK(ca->state == CA_STATE_ROUND_END && ca->score_alpha == 1,
+               "Elimination ends the round for alpha");
+
+    // Leaving while alive counts as gone
+    qk_game_player_disconnect(1);
+    TEST_CHECK(ca->alive_alpha == 1, "Disconnect of a live player decrements the count");
+
+    qk_game_shutdown();
+    qk_physics_world_destroy(world);
+}
+
+// --- Test 15: console_scrollback ---
+
+#define SCROLLBACK_TEST_PRODUCERS   4
+#define SCROLLBACK_TEST_LINES       2000    // per producer; overruns the queue
+
+static qk_scrollback_t  s_scrollback;
+static qk_print_queue_t s_print_queue;
+static qk_atomic_i32_t  s_print_refused;
+
+static bool scrollback_line_is(const qk_scrollback_t *sb, u32 back, const char *expect, u32 len) {
+    char text[QK_SCROLLBACK_LINE_LEN];
+    const qk_scrollback_line_t *line = qk_scrollback_line(sb, back);
+    return qk_scrollback_text(sb, line, text) == len && memcmp(text, expect, len) == 0;
+}
+
+static void scrollback_test_producer(void *data) {
+    u32 producer = (u32)(uintptr_t)data;
+    for (u32 i = 0; i < SCROLLBACK_TEST_LINES; i++) {
+        char line[32];
+        int len = snprintf(line, sizeof(line), "p%u:%u", producer, i);
+        // Retry a refused line until the drain makes room
+        while (!qk_print_queue_push(&s_print_queue, line, (u32)len, (producer << 16) | i)) {
+            qk_atomic_add_i32(&s_print_refused, 1);
+            qk_platform_sleep(0);
+        }
+    }
+}
+
+static void test_console_scrollback(void) {
+    printf("\n=== Test: console_scrollback ===\n");
+    s_current_test = "console_scrollback";
+
+    // Text ring fills first: 255-byte lines, 257 of them fit in 64 KB
+    memset(&s_scrollback, 0, sizeof(s_scrollback));
+    char long_line[QK_SCROLLBACK_LINE_LEN];
+    for (u32 i = 0; i < 300; i++) {
+        memset(long_line, 'A' + (int)(i % 26), sizeof(long_line));
+        qk_scrollback_push(&s_scrollback, long_line, QK_SCROLLBACK_LINE_LEN - 1, i);
+    }
+    u32 held = qk_scrollback_count(&s_scrollback);
+    printf("    [DEBUG] text-bound: held=%u oldest=%u\n",
+           held, qk_scrollback_line(&s_scrollback, held - 1)->color);
+    TEST_CHECK(held == QK_SCROLLBACK_TEXT_BYTES / (QK_SCROLLBACK_LINE_LEN - 1),
+               "Byte ring full: oldest lines evicted");
+    TEST_CHECK(qk_scrollback_line(&s_scrollback, 0)->color == 299 &&
+               qk_scrollback_line(&s_scrollback, held - 1)->color == 300 - held,
+               "Newest and oldest held lines in order");
+    bool intact = true;
+    bool wrapped = false;
+    for (u32 back = 0; back < held; back++) {
+        const qk_scrollback_line_t *line = qk_scrollback_line(&s_scrollback, back);
+        u32 at = line->offset & (QK_SCROLLBACK_TEXT_BYTES - 1);
+        if (at + line->len > QK_SCROLLBACK_TEXT_BYTES) wrapped = true;
+        memset(long_line, 'A' + (int)(line->color % 26), sizeof(long_line));
+        if (!scrollback_line_is(&s_scrollback, back, long_line, QK_SCROLLBACK_LINE_LEN - 1)) {
+            intact = false;
+        }
+    }
+    TEST_CHECK(wrapped && intact, "Lines across the ring's end read back intact");
+
+    // Line index fills first: short lines, 2048 held
+    memset(&s_scrollback, 0, sizeof(s_scrollback));
+    for (u32 i = 0; i < 3000; i++) {
+        char line[16];
+        int len = snprintf(line, sizeof(line), "n=%u", i);
+        qk_scrollback_push(&s_scrollback, line, (u32)len, i);
+    }
+    held = qk_scrollback_count(&s_scrollback);
+    printf("    [DEBUG] index-bound: held=%u\n", held);
+    TEST_CHECK(held == QK_SCROLLBACK_LINES, "Line index full: oldest lines evicted");
+    TEST_CHECK(scrollback_line_is(&s_scrollback, 0, "n=2999", 6) &&
+               scrollback_line_is(&s_scrollback, held - 1, "n=952", 5),
+               "Index wraps with text and order intact");
+
+    char oversize[400];
+    memset(oversize, 'x', sizeof(oversize));
+    qk_scrollback_push(&s_scrollback, oversize, sizeof(oversize), 0);
+    TEST_CHECK(qk_scrollback_line(&s_scrollback, 0)->len == QK_SCROLLBACK_LINE_LEN - 1,
+               "Long line cut to the line length");
+
+    // Single producer: a full queue refuses and counts, drain reports it
+    memset(&s_scrollback, 0, sizeof(s_scrollback));
+    memset(&s_print_queue, 0, sizeof(s_print_queue));
+    u32 accepted = 0;
+    for (u32 i = 0; i < QK_PRINT_QUEUE_SIZE + 5; i++) {
+        if (qk_print_queue_push(&s_print_queue, "q", 1, i)) accepted++;
+    }
+    u32 dropped = qk_print_queue_drain(&s_print_queue, &s_scrollback);
+    TEST_CHECK(accepted == QK_PRINT_QUEUE_SIZE && dropped == 5, "Full queue drops and counts");
+    TEST_CHECK(qk_scrollback_count(&s_scrollback) == QK_PRINT_QUEUE_SIZE &&
+               qk_scrollback_line(&s_scrollback, 0)->color == QK_PRINT_QUEUE_SIZE - 1,
+               "Queued lines drained in push order");
+    TEST_CHECK(qk_print_queue_drain(&s_print_queue, &s_scrollback) == 0,
+               "Drop count resets after a drain");
+
+    // Producers on job workers while this thread drains: each producer's
+    // lines arrive in its own order, and every refusal is counted
+    memset(&s_scrollback, 0, sizeof(s_scrollback));
+    memset(&s_print_queue, 0, sizeof(s_print_queue));
+    qk_atomic_store_i32(&s_print_refused, 0);
+    qk_job_config_t config = { .worker_count = SCROLLBACK_TEST_PRODUCERS + 1 };
+    qk_job_init(&config);
+
+    qk_job_counter_t producers = {0};
+    for (u32 p = 0; p < SCROLLBACK_TEST_PRODUCERS; p++) {
+        qk_job_submit(scrollback_test_producer, (void *)(uintptr_t)p, &producers);
+    }
+
+    u32 next[SCROLLBACK_TEST_PRODUCERS] = {0};
+    u32 delivered = 0;
+    bool ordered = true;
+    bool done = false;
+    dropped = 0;
+    while (!done) {
+        done = qk_job_is_done(&producers);   // drain once more after the last push
+        u32 before = s_scrollback.line_head;
+        dropped += qk_print_queue_drain(&s_print_queue, &s_scrollback);
+        for (u32 n = s_scrollback.line_head - before; n > 0; n--) {
+            u32 color = qk_scrollback_line(&s_scrollback, n - 1)->color;
+            u32 p = color >> 16, i = color & 0xFFFF;
+            if (p >= SCROLLBACK_TEST_PRODUCERS || i < next[p]) ordered = false;
+            else next[p] = i + 1;
+            delivered++;
+        }
+        if (!done) qk_platform_sleep(0);
+    }
+    qk_job_wait(&producers);
+    qk_job_shutdown();
+
+    u32 refused = (u32)qk_atomic_load_i32(&s_print_refused);
+    printf("    [DEBUG] mpsc: delivered=%u dropped=%u refused=%u\n", delivered, dropped, refused);
+    TEST_CHECK(ordered, "Each producer's lines arrive in order");
+    TEST_CHECK(delivered == SCROLLBACK_TEST_PRODUCERS * SCROLLBACK_TEST_LINES,
+               "Every line delivered once");
+    TEST_CHECK(dropped == refused, "Dropped count matches refused pushes");
+}
+
+// --- Test 16: event_pack ---
+
+static void test_event_pack(void) {
+    printf("\n=== Test: event_pack ===\n");
+    s_current_test = "event_pack";
+
+    qk_game_config_t gc = {0};
+    qk_game_init(&gc);
+    qk_game_state_t *gs = qk_game_get_state();
+    static n_game_event_t packed[QK_GAME_MAX_TICK_EVENTS];
+    game_event_t hit = { .type = GEVT_HIT };
+
+    // A full tick packs whole into a buffer of the public size
+    g_event_begin_tick(&gs->events);
+    for (u32 i = 0; i < QK_GAME_MAX_TICK_EVENTS; i++) {
+        hit.data.hit.damage = (i16)i;
+        g_event_push(&gs->events, &hit);
+    }
+    u32 count = qk_game_pack_events(packed, QK_GAME_MAX_TICK_EVENTS);
+    TEST_CHECK(count == QK_GAME_MAX_TICK_EVENTS && qk_game_get_events_lost() == 0,
+               "Full tick fits the public buffer size");
+    TEST_CHECK(packed[0].data.hit.damage == 0 &&
+               packed[QK_GAME_MAX_TICK_EVENTS - 1].data.hit.damage == QK_GAME_MAX_TICK_EVENTS - 1,
+               "Packed oldest first");
+
+    // Past the ring: the oldest are overwritten and counted
+    g_event_begin_tick(&gs->events);
+    for (u32 i = 0; i < QK_GAME_MAX_TICK_EVENTS + 10; i++) {
+        g_event_push(&gs->events, &hit);
+    }
+    count = qk_game_pack_events(packed, QK_GAME_MAX_TICK_EVENTS);
+    printf("    [DEBUG] overflow tick: packed=%u lost=%u\n", count, qk_game_get_events_lost());
+    TEST_CHECK(count == QK_GAME_MAX_TICK_EVENTS && qk_game_get_events_lost() == 10,
+               "Overwritten events counted as lost");
+
+    // A short buffer leaves the rest out and counts them
+    g_event_begin_tick(&gs->events);
+    for (u32 i = 0; i < 10; i++) {
+        g_event_push(&gs->events, &hit);
+    }
+    count = qk_game_pack_events(packed, 4);
+    TEST_CHECK(count == 4 && qk_game_get_events_lost() == 16,
+               "Events past the buffer counted as lost");
+
+    qk_game_shutdown();
+}
+
 // --- Test Registry ---
 
 typedef struct {
@@ -452,6 +1141,15 @@ static const test_entry_t s_tests[] = {
     { "ca_lifecycle",     test_ca_lifecycle },
     { "physics_trace",    test_physics_trace },
     { "rail_impact_data", test_rail_impact_data },
+    { "job_system",       test_job_system },
+    { "scratch_arena",    test_scratch_arena },
+    { "cvar_registry",    test_cvar_registry },
+    { "subtick_fire",     test_subtick_fire },
+    { "tick_budget",      test_tick_budget },
+    { "trace_hugepages",  test_trace_hugepages },
+    { "ca_events",        test_ca_events },
+    { "console_scrollback", test_console_scrollback },
+    { "event_pack",       test_event_pack },
 };
 
 #define NUM_TESTS (sizeof(s_tests) / sizeof(s_tests[0]))
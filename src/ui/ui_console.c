@@ -3,10 +3,17 @@
  *
  * Drop-down console with command execution, cvar manipulation,
  * tab-completion, history, scrollback, and slide animation.
+ *
+ * Scrollback and the cross-thread print queue live in core/qk_scrollback;
+ * the main thread drains the queue each frame. The visible lines' glyph
+ * quads are cached and pushed in one batch, so an open console flooded
+ * with output costs the same as a static one plus one rebuild per frame.
  */
 
 #include "ui/qk_console.h"
 #include "core/qk_cvar.h"
+#include "core/qk_hash.h"
+#include "core/qk_scrollback.h"
 #include "renderer/qk_renderer.h"
 
 #include <SDL3/SDL.h>
@@ -18,10 +25,14 @@
 // --- Constants ---
 
 #define CON_INPUT_LEN        256
-#define CON_SCROLLBACK_LINES 1024
-#define CON_LINE_LEN         256
+#define CON_LINE_LEN         QK_SCROLLBACK_LINE_LEN
+// Scrollback rows in half of a 2160-pixel screen at 16 px per line; every
+// one of them full-length still fits the quad cache
+#define CON_MAX_VISIBLE_LINES 68
+#define CON_QUAD_CACHE_SIZE  (CON_MAX_VISIBLE_LINES * (CON_LINE_LEN - 1))
 #define CON_HISTORY_SIZE     64
 #define CON_MAX_COMMANDS     128
+#define CON_CMD_HASH_SIZE    256    // power of two, >= 2 * CON_MAX_COMMANDS
 #define CON_MAX_TOKENS       32
 
 static const f32 CON_FONT_SIZE    = 14.0f;
@@ -35,13 +46,6 @@ static const u32 CON_ERROR_COLOR  = 0xFF4444FF;  // red for errors
 static const u32 CON_CVAR_COLOR   = 0xFFCC44FF;  // yellow for cvar info
 static const char CON_PROMPT_CHAR = ']';
 
-// --- Scrollback line ---
-
-typedef struct {
-    char text[CON_LINE_LEN];
-    u32  color;
-} con_line_t;
-
 // --- Registered command ---
 
 typedef struct {
@@ -63,11 +67,18 @@ static struct {
     u32         cursor;
 
     // Scrollback
-    con_line_t  lines[CON_SCROLLBACK_LINES];
-    u32         line_head;          // next write position (ring)
-    u32         line_count;         // total lines written (up to max)
+    qk_scrollback_t scrollback;
     i32         scroll_offset;      // lines scrolled up from bottom
 
+    // Glyph quads of the visible scrollback, rebuilt when it moves
+    qk_ui_quad_t quad_cache[CON_QUAD_CACHE_SIZE];
+    u32         quad_count;
+    u32         quad_lines_cut;     // visible lines left out of a full cache
+    u32         cache_line_head;
+    i32         cache_scroll;
+    f32         cache_bottom_y;
+    bool        cache_valid;
+
     // History
     char        history[CON_HISTORY_SIZE][CON_INPUT_LEN];
     u32         history_head;
@@ -83,6 +94,7 @@ static struct {
     // Commands
     con_cmd_t   commands[CON_MAX_COMMANDS];
     u32         command_count;
+    u8          command_index[CON_CMD_HASH_SIZE];  // commands index + 1, 0 = empty
 
     // Tilde suppression
     bool        suppress_next_text;
@@ -93,6 +105,12 @@ static struct {
     bool        initialized;
 } s_con;
 
+// Lines printed off the main thread. Kept out of s_con so init does not
+// wipe lines queued before it; the zeroed static is the empty queue.
+static qk_print_queue_t s_print_queue;
+
+static QK_THREAD_LOCAL bool s_con_main_thread;
+
 // --- Forward declarations ---
 
 static void con_execute(const char *text);
@@ -115,9 +133,9 @@ static void cmd_help(i32 argc, const char **argv) {
 static void cmd_clear(i32 argc, const char **argv) {
     QK_UNUSED(argc);
     QK_UNUSED(argv);
-    s_con.line_count = 0;
-    s_con.line_head = 0;
+    qk_scrollback_clear(&s_con.scrollback);
     s_con.scroll_offset = 0;
+    s_con.cache_valid = false;
 }
 
 static void cmd_quit(i32 argc, const char **argv) {
@@ -178,6 +196,7 @@ static void cmd_echo(i32 argc, const char **argv) {
 
 void qk_console_init(void) {
     memset(&s_con, 0, sizeof(s_con));
+    s_con_main_thread = true;
     s_con.history_pos = -1;
     s_con.tab_index = -1;
 
@@ -212,17 +231,39 @@ void qk_console_toggle(void) {
 
 // --- Output ---
 
-static void con_push_line(const char *text, u32 color) {
-    con_line_t *line = &s_con.lines[s_con.line_head % CON_SCROLLBACK_LINES];
-    snprintf(line->text, CON_LINE_LEN, "%s", text);
-    line->color = color;
-    s_con.line_head++;
-    if (s_con.line_count < CON_SCROLLBACK_LINES) s_con.line_count++;
+static void con_push_line_len(const char *text, u32 len, u32 color) {
+    qk_scrollback_push(&s_con.scrollback, text, len, color);
 
     // Auto-scroll to bottom when new text arrives
     s_con.scroll_offset = 0;
 }
 
+static void con_drain_queue(void) {
+    u32 line_head = s_con.scrollback.line_head;
+    u32 dropped = qk_print_queue_drain(&s_print_queue, &s_con.scrollback);
+    if (s_con.scrollback.line_head != line_head) s_con.scroll_offset = 0;
+    if (dropped > 0) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "(%u lines dropped, print queue full)", dropped);
+        con_push_line_len(buf, (u32)strlen(buf), CON_ERROR_COLOR);
+    }
+}
+
+// Main thread: straight into the scrollback, after anything queued before
+// it. Other threads: through the queue.
+static void con_emit(const char *text, u32 len, u32 color) {
+    if (s_con_main_thread) {
+        con_drain_queue();
+        con_push_line_len(text, len, color);
+    } else {
+        qk_print_queue_push(&s_print_queue, text, len, color);    // counts its drops
+    }
+}
+
+static void con_push_line(const char *text, u32 color) {
+    con_emit(text, (u32)strlen(text), color);
+}
+
 void qk_console_print(const char *text) {
     if (!text) return;
 
@@ -230,12 +271,7 @@ void qk_console_print(const char *text) {
     const char *start = text;
     for (const char *p = text; ; p++) {
         if (*p == '\n' || *p == '\0') {
-            char buf[CON_LINE_LEN];
-            u32 len = (u32)(p - start);
-            if (len >= CON_LINE_LEN) len = CON_LINE_LEN - 1;
-            memcpy(buf, start, len);
-            buf[len] = '\0';
-            con_push_line(buf, CON_TEXT_COLOR);
+            con_emit(start, (u32)(p - start), CON_TEXT_COLOR);
             if (*p == '\0') break;
             start = p + 1;
         }
@@ -253,15 +289,37 @@ void qk_console_printf(const char *fmt, ...) {
 
 // --- Command registration ---
 
+_Static_assert((CON_CMD_HASH_SIZE & (CON_CMD_HASH_SIZE - 1)) == 0 &&
+               CON_CMD_HASH_SIZE >= 2 * CON_MAX_COMMANDS && CON_MAX_COMMANDS < 256,
+               "console command hash table sizing");
+
+// Open-addressed lookup: slot holding name, or the empty slot where it would go
+static u8 *con_cmd_slot(const char *name) {
+    u32 mask = CON_CMD_HASH_SIZE - 1;
+    u32 h = qk_hash_str(name) & mask;
+    for (;;) {
+        u8 *slot = &s_con.command_index[h];
+        if (*slot == 0 || strcmp(s_con.commands[*slot - 1].name, name) == 0) return slot;
+        h = (h + 1) & mask;
+    }
+}
+
 void qk_console_register_cmd(const char *name, qk_console_cmd_func_t func,
                                const char *desc) {
     if (s_con.command_count >= CON_MAX_COMMANDS) return;
 
-    con_cmd_t *cmd = &s_con.commands[s_con.command_count++];
-    cmd->in_use = true;
+    con_cmd_t *cmd = &s_con.commands[s_con.command_count];
     snprintf(cmd->name, sizeof(cmd->name), "%s", name);
+
+    // First registration of a name wins, as with the old linear scan
+    u8 *slot = con_cmd_slot(cmd->name);
+    if (*slot) return;
+
+    s_con.command_count++;
+    cmd->in_use = true;
     snprintf(cmd->desc, sizeof(cmd->desc), "%s", desc ? desc : "");
     cmd->func = func;
+    *slot = (u8)s_con.command_count;
 }
 
 // --- Tokenizer (Q3 style: space-delimited, quoted strings) ---
@@ -323,12 +381,10 @@ static void con_execute(const char *text) {
     if (argc == 0) return;
 
     // 1. Try registered commands first
-    for (u32 i = 0; i < s_con.command_count; i++) {
-        if (!s_con.commands[i].in_use) continue;
-        if (strcmp(s_con.commands[i].name, tokens[0]) == 0) {
-            s_con.commands[i].func(argc, tokens);
-            return;
-        }
+    u8 cmd_slot = *con_cmd_slot(tokens[0]);
+    if (cmd_slot) {
+        s_con.commands[cmd_slot - 1].func(argc, tokens);
+        return;
     }
 
     // 2. Try cvar lookup
@@ -538,8 +594,8 @@ void qk_console_key_event(u32 scancode, bool pressed) {
 
     case SDL_SCANCODE_PAGEUP:
         s_con.scroll_offset += 5;
-        if (s_con.scroll_offset > (i32)s_con.line_count) {
-            s_con.scroll_offset = (i32)s_con.line_count;
+        if (s_con.scroll_offset > (i32)qk_scrollback_count(&s_con.scrollback)) {
+            s_con.scroll_offset = (i32)qk_scrollback_count(&s_con.scrollback);
         }
         break;
 
@@ -594,9 +650,42 @@ void qk_console_text_event(const char *text) {
 
 // --- Rendering ---
 
+// Glyph quads for the scrollback from bottom_y upward, newest line first
+static void con_build_quads(f32 bottom_y, f32 line_height, f32 padding) {
+    s_con.quad_count = 0;
+    s_con.quad_lines_cut = 0;
+
+    u32 held = qk_scrollback_count(&s_con.scrollback);
+    f32 y = bottom_y;
+    for (u32 back = (u32)s_con.scroll_offset; back < held && y >= 0.0f; back++) {
+        const qk_scrollback_line_t *line = qk_scrollback_line(&s_con.scrollback, back);
+        // Whole lines only: past a screen taller than the cache was sized
+        // for, the oldest visible lines are left out and counted
+        if (s_con.quad_lines_cut > 0 || line->len > CON_QUAD_CACHE_SIZE - s_con.quad_count) {
+            s_con.quad_lines_cut++;
+            y -= line_height;
+            continue;
+        }
+        char text[CON_LINE_LEN];
+        u32 len = qk_scrollback_text(&s_con.scrollback, line, text);
+        s_con.quad_count += qk_ui_build_text_quads(padding, y, text, len, CON_FONT_SIZE, line->color,
+                                                   &s_con.quad_cache[s_con.quad_count],
+                                                   CON_QUAD_CACHE_SIZE - s_con.quad_count);
+        y -= line_height;
+    }
+
+    s_con.cache_line_head = s_con.scrollback.line_head;
+    s_con.cache_scroll = s_con.scroll_offset;
+    s_con.cache_bottom_y = bottom_y;
+    s_con.cache_valid = true;
+}
+
 void qk_console_draw(f32 screen_w, f32 screen_h, f32 dt) {
     if (!s_con.initialized) return;
 
+    // Even while closed, so other threads never find the queue full
+    con_drain_queue();
+
     // Animate slide
     f32 target = s_con.open ? 1.0f : 0.0f;
     if (s_con.slide_frac < target) {
@@ -650,38 +739,19 @@ void qk_console_draw(f32 screen_w, f32 screen_h, f32 dt) {
     f32 sep_y = input_y - 4.0f;
     qk_ui_draw_rect(0, sep_y, screen_w, 1.0f, CON_BORDER_COLOR);
 
-    // Draw scrollback lines (bottom-up)
-    f32 y = sep_y - line_height;
-    u32 visible_lines = 0;
-
-    if (s_con.line_count > 0) {
-        // Start from the newest visible line, adjusted by scroll offset
-        i32 start_idx = (i32)s_con.line_head - 1 - s_con.scroll_offset;
-
-        for (i32 i = start_idx; i >= 0 && y >= 0; i--, visible_lines++) {
-            u32 ring_idx = (u32)i % CON_SCROLLBACK_LINES;
-            con_line_t *line = &s_con.lines[ring_idx];
-            if (line->text[0]) {
-                qk_ui_draw_text(padding, y, line->text, CON_FONT_SIZE, line->color);
-            }
-            y -= line_height;
-        }
-
-        // If we started with high line_head, also render wrapped entries
-        if (s_con.line_count >= CON_SCROLLBACK_LINES && start_idx < 0) {
-            // wrapped case: line_head has wrapped around the ring buffer
-            for (i32 i = (i32)CON_SCROLLBACK_LINES + start_idx; i >= (i32)s_con.line_head && y >= 0; i--, visible_lines++) {
-                u32 ring_idx = (u32)i % CON_SCROLLBACK_LINES;
-                con_line_t *line = &s_con.lines[ring_idx];
-                if (line->text[0]) {
-                    qk_ui_draw_text(padding, y, line->text, CON_FONT_SIZE, line->color);
-                }
-                y -= line_height;
-            }
-        }
+    // Scrollback lines (bottom-up), rebuilt only when a line scrolls or
+    // the console slides
+    f32 bottom_y = sep_y - line_height;
+    if (!s_con.cache_valid || s_con.cache_line_head != s_con.scrollback.line_head ||
+        s_con.cache_scroll != s_con.scroll_offset || s_con.cache_bottom_y != bottom_y) {
+        con_build_quads(bottom_y, line_height, padding);
+    }
+    qk_renderer_push_ui_quads(s_con.quad_cache, s_con.quad_count);
+    if (s_con.quad_lines_cut > 0) {
+        char cut_buf[48];
+        snprintf(cut_buf, sizeof(cut_buf), "(%u lines not drawn)", s_con.quad_lines_cut);
+        qk_ui_draw_text(padding, padding, cut_buf, CON_FONT_SIZE, CON_ERROR_COLOR);
     }
-
-    QK_UNUSED(visible_lines);
 
     // Scroll indicator
     if (s_con.scroll_offset > 0) {
@@ -5,13 +5,17 @@
  * These bridge the UI module and the renderer by converting high-level
  * draw calls into qk_ui_quad_t pushes.
  *
- * Includes a procedurally-generated 8x8 bitmap font atlas covering
- * ASCII printable range (32-126). The atlas is uploaded on first use.
+ * Includes a procedurally-generated 8x8 bitmap font covering ASCII
+ * printable range (32-126). On first use it is turned into a signed
+ * distance field atlas, so text stays sharp when scaled, and uploaded.
  */
 
 #include "renderer/qk_renderer.h"
+#include "core/qk_hash.h"
+#include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 // --- Bitmap Font Atlas ---
 
@@ -19,19 +23,33 @@
  * 8x8 pixel monospace font, covering ASCII 32..126 (95 glyphs).
  * Each glyph is 8 bytes, each byte is one row (MSB = leftmost pixel).
  *
- * Atlas layout: 16 columns x 6 rows = 96 cells (128x48 pixels)
+ * Atlas layout: 16 columns x 6 rows = 96 cells
  * Glyph index = ascii - 32, cell_x = index % 16, cell_y = index / 16
  */
 #define FONT_GLYPH_W       8
 #define FONT_GLYPH_H       8
 #define FONT_ATLAS_COLS     16
 #define FONT_ATLAS_ROWS     6
-#define FONT_ATLAS_W        (FONT_GLYPH_W * FONT_ATLAS_COLS)   // 128
-#define FONT_ATLAS_H        (FONT_GLYPH_H * FONT_ATLAS_ROWS)   // 48
 #define FONT_FIRST_CHAR     32
 #define FONT_LAST_CHAR      126
 #define FONT_GLYPH_COUNT    (FONT_LAST_CHAR - FONT_FIRST_CHAR + 1) // 95
 
+/*
+ * SDF atlas: each glyph pixel becomes FONT_SDF_SCALE^2 atlas pixels whose
+ * alpha is the signed distance to the glyph outline (0.5 = edge, > 0.5
+ * inside), spread over +-FONT_SDF_SPREAD glyph pixels. Cells are padded
+ * so linear filtering never reads the neighbouring glyph.
+ */
+#define FONT_SDF_SCALE      4
+#define FONT_SDF_PAD        4
+#define FONT_SDF_CELL_W     (FONT_GLYPH_W * FONT_SDF_SCALE + 2 * FONT_SDF_PAD) // 40
+#define FONT_SDF_CELL_H     (FONT_GLYPH_H * FONT_SDF_SCALE + 2 * FONT_SDF_PAD) // 40
+#define FONT_ATLAS_W        (FONT_SDF_CELL_W * FONT_ATLAS_COLS)    // 640
+#define FONT_ATLAS_H        (FONT_SDF_CELL_H * FONT_ATLAS_ROWS)    // 240
+
+static const f32 FONT_SDF_SPREAD = 1.5f;
+static const i32 FONT_SDF_SEARCH = 2;       // glyph pixels; covers the spread
+
 // 8x8 pixel data for each glyph (8 bytes per glyph, MSB=left)
 static const u8 s_font_glyphs[FONT_GLYPH_COUNT][8] = {
     /* 32 ' ' */ { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
@@ -134,37 +152,63 @@ static const u8 s_font_glyphs[FONT_GLYPH_COUNT][8] = {
 static u32 s_font_texture_id = 0;
 static bool s_font_initialized = false;
 
+static bool font_pixel(u32 glyph, i32 x, i32 y) {
+    if (x < 0 || y < 0 || x >= FONT_GLYPH_W || y >= FONT_GLYPH_H) return false;
+    return (s_font_glyphs[glyph][y] & (0x80 >> x)) != 0;
+}
+
+// Distance field value at (px, py) in glyph pixels: the nearest pixel of
+// the other state, measured to its square, brute force over a small window
+static u8 font_sdf_sample(u32 glyph, f32 px, f32 py) {
+    i32 cx = (i32)floorf(px);
+    i32 cy = (i32)floorf(py);
+    bool inside = font_pixel(glyph, cx, cy);
+
+    f32 best_sq = FONT_SDF_SPREAD * FONT_SDF_SPREAD;
+    for (i32 sy = cy - FONT_SDF_SEARCH; sy <= cy + FONT_SDF_SEARCH; sy++) {
+        for (i32 sx = cx - FONT_SDF_SEARCH; sx <= cx + FONT_SDF_SEARCH; sx++) {
+            if (font_pixel(glyph, sx, sy) == inside) continue;
+            f32 dx = fmaxf(fmaxf((f32)sx - px, px - (f32)(sx + 1)), 0.0f);
+            f32 dy = fmaxf(fmaxf((f32)sy - py, py - (f32)(sy + 1)), 0.0f);
+            f32 d_sq = dx * dx + dy * dy;
+            if (d_sq < best_sq) best_sq = d_sq;
+        }
+    }
+
+    f32 dist = sqrtf(best_sq);
+    f32 alpha = 0.5f + (inside ? dist : -dist) / (2.0f * FONT_SDF_SPREAD);
+    return (u8)(alpha * 255.0f + 0.5f);
+}
+
 static void ui_font_init(void) {
     if (s_font_initialized) return;
+    s_font_initialized = true;
+
+    // White RGB, distance in alpha
+    u8 *pixels = (u8 *)malloc((size_t)FONT_ATLAS_W * FONT_ATLAS_H * 4);
+    if (!pixels) {
+        fprintf(stderr, "Warning: font atlas allocation failed, text disabled\n");
+        return;
+    }
+    memset(pixels, 255, (size_t)FONT_ATLAS_W * FONT_ATLAS_H * 4);
 
-    // Rasterize the glyph data into an RGBA pixel buffer
-    u8 pixels[FONT_ATLAS_W * FONT_ATLAS_H * 4];
-    memset(pixels, 0, sizeof(pixels));
-
-    for (u32 g = 0; g < FONT_GLYPH_COUNT; g++) {
-        u32 col = g % FONT_ATLAS_COLS;
-        u32 row = g / FONT_ATLAS_COLS;
-        u32 base_x = col * FONT_GLYPH_W;
-        u32 base_y = row * FONT_GLYPH_H;
-
-        for (u32 y = 0; y < FONT_GLYPH_H; y++) {
-            u8 bits = s_font_glyphs[g][y];
-            for (u32 x = 0; x < FONT_GLYPH_W; x++) {
-                if (bits & (0x80 >> x)) {
-                    u32 px = base_x + x;
-                    u32 py = base_y + y;
-                    u32 idx = (py * FONT_ATLAS_W + px) * 4;
-                    pixels[idx + 0] = 255;  // R
-                    pixels[idx + 1] = 255;  // G
-                    pixels[idx + 2] = 255;  // B
-                    pixels[idx + 3] = 255;  // A
-                }
+    // The unused 96th cell stays empty (alpha 0)
+    for (u32 cell = 0; cell < FONT_ATLAS_COLS * FONT_ATLAS_ROWS; cell++) {
+        u32 base_x = (cell % FONT_ATLAS_COLS) * FONT_SDF_CELL_W;
+        u32 base_y = (cell / FONT_ATLAS_COLS) * FONT_SDF_CELL_H;
+
+        for (u32 y = 0; y < FONT_SDF_CELL_H; y++) {
+            f32 py = ((f32)y - (f32)FONT_SDF_PAD + 0.5f) / (f32)FONT_SDF_SCALE;
+            for (u32 x = 0; x < FONT_SDF_CELL_W; x++) {
+                f32 px = ((f32)x - (f32)FONT_SDF_PAD + 0.5f) / (f32)FONT_SDF_SCALE;
+                u32 idx = ((base_y + y) * FONT_ATLAS_W + base_x + x) * 4;
+                pixels[idx + 3] = cell < FONT_GLYPH_COUNT ? font_sdf_sample(cell, px, py) : 0;
             }
         }
     }
 
-    s_font_texture_id = qk_renderer_upload_texture(pixels, FONT_ATLAS_W, FONT_ATLAS_H, 4, true);
-    s_font_initialized = true;
+    s_font_texture_id = qk_renderer_upload_sdf_texture(pixels, FONT_ATLAS_W, FONT_ATLAS_H);
+    free(pixels);
 }
 
 // --- Solid Rectangle ---
@@ -179,10 +223,13 @@ void qk_ui_draw_rect(f32 x, f32 y, f32 w, f32 h, u32 color_rgba) {
 }
 
 // --- Text ---
-void qk_ui_draw_text(f32 x, f32 y, const char *text, f32 size, u32 color_rgba) {
-    if (!text || !text[0]) return;
 
+#define UI_TEXT_BATCH 64
+
+u32 qk_ui_build_text_quads(f32 x, f32 y, const char *text, u32 len, f32 size,
+                           u32 color_rgba, qk_ui_quad_t *out, u32 max_quads) {
     ui_font_init();
+    if (s_font_texture_id == 0) return 0;
 
     f32 scale = size / (f32)FONT_GLYPH_H;
     f32 glyph_w = (f32)FONT_GLYPH_W * scale;
@@ -191,16 +238,14 @@ void qk_ui_draw_text(f32 x, f32 y, const char *text, f32 size, u32 color_rgba) {
 
     f32 inv_atlas_w = 1.0f / (f32)FONT_ATLAS_W;
     f32 inv_atlas_h = 1.0f / (f32)FONT_ATLAS_H;
+    f32 glyph_du = (f32)(FONT_GLYPH_W * FONT_SDF_SCALE) * inv_atlas_w;
+    f32 glyph_dv = (f32)(FONT_GLYPH_H * FONT_SDF_SCALE) * inv_atlas_h;
 
-    for (const char *p = text; *p; p++) {
-        u8 ch = (u8)*p;
-
-        if (ch == ' ') {
-            cx += glyph_w;
-            continue;
-        }
+    u32 count = 0;
+    for (u32 i = 0; i < len && count < max_quads; i++) {
+        u8 ch = (u8)text[i];
 
-        if (ch < FONT_FIRST_CHAR || ch > FONT_LAST_CHAR) {
+        if (ch <= ' ' || ch > FONT_LAST_CHAR) {
             cx += glyph_w;
             continue;
         }
@@ -209,21 +254,95 @@ void qk_ui_draw_text(f32 x, f32 y, const char *text, f32 size, u32 color_rgba) {
         u32 col = idx % FONT_ATLAS_COLS;
         u32 row = idx / FONT_ATLAS_COLS;
 
-        f32 u0 = (f32)(col * FONT_GLYPH_W) * inv_atlas_w;
-        f32 v0 = (f32)(row * FONT_GLYPH_H) * inv_atlas_h;
-        f32 u1 = u0 + (f32)FONT_GLYPH_W * inv_atlas_w;
-        f32 v1 = v0 + (f32)FONT_GLYPH_H * inv_atlas_h;
+        f32 u0 = (f32)(col * FONT_SDF_CELL_W + FONT_SDF_PAD) * inv_atlas_w;
+        f32 v0 = (f32)(row * FONT_SDF_CELL_H + FONT_SDF_PAD) * inv_atlas_h;
 
-        qk_ui_quad_t quad = {
+        out[count++] = (qk_ui_quad_t){
             .x = cx, .y = y, .w = glyph_w, .h = glyph_h,
-            .u0 = u0, .v0 = v0, .u1 = u1, .v1 = v1,
+            .u0 = u0, .v0 = v0,
+            .u1 = u0 + glyph_du,
+            .v1 = v0 + glyph_dv,
             .color = color_rgba,
             .texture_id = s_font_texture_id,
         };
-        qk_renderer_push_ui_quad(&quad);
 
         cx += glyph_w;
     }
+    return count;
+}
+
+// --- Text Layout Cache ---
+
+/*
+ * HUD and menu strings repeat every frame. Their quads are laid out once
+ * at the origin, keyed by (text hash, size), and each draw only offsets
+ * and recolors them. Direct-mapped: a collision lays the new string out
+ * over the old one. Longer strings skip the cache.
+ */
+#define UI_LAYOUT_SLOTS         128
+#define UI_LAYOUT_MAX_CHARS     48
+
+_Static_assert(UI_LAYOUT_MAX_CHARS <= UI_TEXT_BATCH, "a cached layout is pushed as one batch");
+
+typedef struct {
+    u32             hash;
+    f32             size;
+    u32             len;        // 0 = empty slot
+    u32             quad_count;
+    char            text[UI_LAYOUT_MAX_CHARS];
+    qk_ui_quad_t    quads[UI_LAYOUT_MAX_CHARS];
+} ui_layout_t;
+
+static ui_layout_t s_layout_cache[UI_LAYOUT_SLOTS];
+
+static const ui_layout_t *ui_layout_get(const char *text, u32 len, f32 size) {
+    u32 size_bits;
+    memcpy(&size_bits, &size, sizeof(size_bits));
+    u32 hash = (qk_hash_bytes(text, len) ^ size_bits) * QK_FNV1A_PRIME;
+
+    ui_layout_t *layout = &s_layout_cache[hash & (UI_LAYOUT_SLOTS - 1)];
+    if (layout->len == len && layout->hash == hash && layout->size == size &&
+        memcmp(layout->text, text, len) == 0) {
+        return layout;
+    }
+
+    layout->hash = hash;
+    layout->size = size;
+    layout->len = len;
+    memcpy(layout->text, text, len);
+    layout->quad_count = qk_ui_build_text_quads(0.0f, 0.0f, text, len, size, 0,
+                                                layout->quads, UI_LAYOUT_MAX_CHARS);
+    return layout;
+}
+
+// --- Text Drawing ---
+
+void qk_ui_draw_text(f32 x, f32 y, const char *text, f32 size, u32 color_rgba) {
+    if (!text || !text[0]) return;
+
+    u32 len = (u32)strlen(text);
+    qk_ui_quad_t quads[UI_TEXT_BATCH];
+
+    if (len <= UI_LAYOUT_MAX_CHARS) {
+        const ui_layout_t *layout = ui_layout_get(text, len, size);
+        for (u32 i = 0; i < layout->quad_count; i++) {
+            quads[i] = layout->quads[i];
+            quads[i].x += x;
+            quads[i].y += y;
+            quads[i].color = color_rgba;
+        }
+        qk_renderer_push_ui_quads(quads, layout->quad_count);
+        return;
+    }
+
+    // Build and push in batches instead of one quad at a time
+    f32 glyph_w = (f32)FONT_GLYPH_W * (size / (f32)FONT_GLYPH_H);
+    for (u32 at = 0; at < len; at += UI_TEXT_BATCH) {
+        u32 n = len - at < UI_TEXT_BATCH ? len - at : UI_TEXT_BATCH;
+        u32 count = qk_ui_build_text_quads(x + (f32)at * glyph_w, y, text + at, n,
+                                           size, color_rgba, quads, UI_TEXT_BATCH);
+        qk_renderer_push_ui_quads(quads, count);
+    }
 }
 
 // --- Number ---
@@ -7,14 +7,24 @@
  *   3. Client sends input -> server receives via qk_net_server_get_input
  *   4. Server sets entities -> client receives snapshots
  *   5. Client interpolates -> entities visible in interp state
- *   6. Clock sync converges
+ *   6. Clock samples ride on snapshots (RTT from echoed input timestamps)
+ *   7. Spectator relay: server -> relay -> viewer over localhost UDP
+ *   8. Game events resent with snapshots until acked, delivered once
+ *   9. Direct local path: the same without serialization
+ *  10. Connectionless server info query, cached and rate limited
+ *  11. Outgoing message queue: priority order, MTU carry-over, drops
+ *  12. Query limit: sources that hash to one slot share its bucket
+ *  13. Relay on a listen server: its slot is map-ready but not a player
  */
 
 #include "quicken.h"
 #include "qk_types.h"
 #include "netcode/qk_netcode.h"
 #include "netcode/n_types.h"
+#include "netcode/n_internal.h"     /* message queue, below the public API */
+#include "core/qk_platform.h"
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -131,6 +141,39 @@ static void test_input_roundtrip(void) {
         TEST_CHECK(out_cmd.buttons == QK_BUTTON_JUMP, "buttons == JUMP");
     }
 
+    /* Press edges. Two inputs put the client a tick ahead, so the server
+       reads this one on its own tick instead of repeating the last one. */
+    qk_usercmd_t edge_cmd = cmd;
+    edge_cmd.buttons = QK_BUTTON_ATTACK | QK_BUTTON_JUMP;
+    edge_cmd.jump_subtick = qk_subtick_encode(0.25f);
+    edge_cmd.attack_subtick = qk_subtick_encode(0.75f);
+    edge_cmd.attack_yaw = 45.0f;
+    edge_cmd.attack_pitch = 10.0f;
+
+    qk_net_client_send_input(&edge_cmd);
+    qk_net_client_send_input(&edge_cmd);
+    qk_net_server_tick();
+
+    got_input = qk_net_server_get_input(cid, &out_cmd);
+    TEST_CHECK(got_input, "Server got input with press edges");
+
+    if (got_input) {
+        TEST_CHECK(out_cmd.jump_subtick == edge_cmd.jump_subtick, "jump sub-tick preserved");
+        TEST_CHECK(out_cmd.attack_subtick == edge_cmd.attack_subtick, "attack sub-tick preserved");
+
+        f32 ayaw_err = out_cmd.attack_yaw - 45.0f;
+        if (ayaw_err < 0) ayaw_err = -ayaw_err;
+        TEST_CHECK(ayaw_err < 0.1f, "attack_yaw ~= 45.0");
+    }
+
+    /* Next tick has no new input: held buttons repeat, press edges do not */
+    qk_net_server_tick();
+    got_input = qk_net_server_get_input(cid, &out_cmd);
+    TEST_CHECK(got_input && out_cmd.buttons == edge_cmd.buttons &&
+               out_cmd.attack_subtick == QK_SUBTICK_NONE &&
+               out_cmd.jump_subtick == QK_SUBTICK_NONE,
+               "Repeated input drops press edges");
+
     qk_net_client_shutdown();
     qk_net_server_shutdown();
 }
@@ -529,6 +572,755 @@ static void test_early_frame_interpolation(void) {
     qk_net_server_shutdown();
 }
 
+/* ---------- Test 8: Input buffer steering ---------- */
+
+static void run_steering_ticks(u8 cid, u32 ticks) {
+    qk_usercmd_t cmd = {0};
+    for (u32 i = 0; i < ticks; i++) {
+        qk_net_client_send_input(&cmd);
+        qk_net_server_tick();
+        qk_usercmd_t srv_cmd;
+        qk_net_server_get_input(cid, &srv_cmd);
+        qk_net_client_tick();
+    }
+}
+
+static void test_input_buffer_steering(void) {
+    printf("\n=== Test: Input Buffer Steering ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    u8 cid = qk_net_client_get_id();
+    TEST_CHECK(qk_net_client_get_time_scale() == 1.0f, "Time scale starts at 1.0");
+
+    /* Each input arrives for the tick the server just finished: starved */
+    run_steering_ticks(cid, 64);
+    printf("    [DEBUG] depth=%.2f scale=%.4f\n",
+           qk_net_client_get_input_depth(), qk_net_client_get_time_scale());
+    TEST_CHECK(qk_net_client_get_input_depth() < 0.0f, "Starved buffer reported");
+    TEST_CHECK(qk_net_client_get_time_scale() > 1.0f, "Starved buffer speeds the client up");
+
+    /* A burst puts the client several ticks ahead: excess latency */
+    qk_usercmd_t cmd = {0};
+    for (int i = 0; i < 8; i++) qk_net_client_send_input(&cmd);
+    run_steering_ticks(cid, 200);
+    f32 scale = qk_net_client_get_time_scale();
+    printf("    [DEBUG] depth=%.2f scale=%.4f\n", qk_net_client_get_input_depth(), scale);
+    TEST_CHECK(qk_net_client_get_input_depth() > 1.0f, "Deep buffer reported");
+    TEST_CHECK(scale < 1.0f && scale >= 0.95f, "Deep buffer slows the client, within 5%");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+static void test_underrun_extrapolation(void) {
+    printf("\n=== Test: Underrun Extrapolation ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    /* Grounded player at x=100 moving +x at 256 u/s */
+    n_entity_state_t ent = {0};
+    ent.pos_x = (i16)(100.0f / 0.5f);
+    ent.vel_x = 256;
+    ent.entity_type = 1;
+    ent.flags = QK_ENT_FLAG_ON_GROUND;
+    qk_net_server_set_entity(0, &ent);
+
+    for (int i = 0; i < 4; i++) {
+        qk_net_server_tick();
+        qk_net_client_tick();
+    }
+    u32 newest = qk_net_server_get_tick();
+    const qk_interp_state_t *interp = qk_net_client_get_interp_state();
+
+    /* 8 ticks past the newest snapshot: 256 * 8/128 = 16 units ahead */
+    qk_net_client_interpolate((f64)(newest + 8) / 128.0);
+    f32 x = interp->entities[0].pos_x;
+    printf("    [DEBUG] +8 ticks x=%.2f extrap=%.4f\n", x,
+           qk_net_client_get_interp_diag()->extrap_sec);
+    TEST_CHECK(fabsf(x - 116.0f) < 0.1f, "Entity dead-reckoned along its velocity");
+
+    /* A full second late: held at the 0.25 s limit */
+    qk_net_client_interpolate((f64)(newest + 128) / 128.0);
+    x = interp->entities[0].pos_x;
+    printf("    [DEBUG] +128 ticks x=%.2f\n", x);
+    TEST_CHECK(fabsf(x - 164.0f) < 0.1f, "Extrapolation capped at the limit");
+
+    /* Snapshots resume with the entity still at x=100: no instant jump back */
+    for (int i = 0; i < 8; i++) {
+        qk_net_server_tick();
+        qk_net_client_tick();
+    }
+    qk_net_client_interpolate((f64)qk_net_server_get_tick() / 128.0);
+    x = interp->entities[0].pos_x;
+    printf("    [DEBUG] resumed x=%.2f\n", x);
+    TEST_CHECK(x > 150.0f, "Correction blends from the shown position");
+
+    for (int i = 0; i < 64; i++) {
+        qk_net_server_tick();
+        qk_net_client_tick();
+        qk_net_client_interpolate((f64)qk_net_server_get_tick() / 128.0);
+    }
+    x = interp->entities[0].pos_x;
+    printf("    [DEBUG] settled x=%.2f\n", x);
+    TEST_CHECK(fabsf(x - 100.0f) < 0.5f, "Blend decays back onto interpolation");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+/* Two snapshots at the same x, one tick apart, velocities vx_a -> vx_b.
+ * Two entities give 6 lanes, so the SSE path runs. Returns entity 0's
+ * interpolated x at the midpoint. */
+static f32 hermite_midpoint_x(i16 vx_a, i16 vx_b) {
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_net_server_init(&srv_cfg);
+    qk_net_client_config_t cl_cfg = {0};
+    qk_net_client_init(&cl_cfg);
+    qk_net_client_connect_local();
+
+    n_entity_state_t ent = {0};
+    ent.entity_type = 1;
+    ent.vel_x = vx_a;
+    qk_net_server_set_entity(0, &ent);
+    qk_net_server_set_entity(1, &ent);
+    qk_net_server_tick();
+    qk_net_client_tick();
+    u32 tick_a = qk_net_server_get_tick();
+
+    ent.vel_x = vx_b;
+    qk_net_server_set_entity(0, &ent);
+    qk_net_server_set_entity(1, &ent);
+    qk_net_server_tick();
+    qk_net_client_tick();
+
+    qk_net_client_interpolate(((f64)tick_a + 0.5) / 128.0);
+    f32 x = qk_net_client_get_interp_state()->entities[0].pos_x;
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+    return x;
+}
+
+static void test_hermite_interpolation(void) {
+    printf("\n=== Test: Hermite Interpolation ===\n");
+
+    /* Turnaround: velocities explain the (zero) chord, so the path bulges
+     * out by span * |v| / 4 = 1024 / 128 / 4 = 2 units at t = 0.5 */
+    f32 x = hermite_midpoint_x(1024, -1024);
+    printf("    [DEBUG] turnaround x=%.3f\n", x);
+    TEST_CHECK(fabsf(x - 2.0f) < 0.01f, "Hermite follows the velocity tangents");
+
+    /* Same velocity both ends but no displacement: tangents miss the chord
+     * by 16 units (a wall stop), so the lane falls back to linear */
+    x = hermite_midpoint_x(2048, 2048);
+    printf("    [DEBUG] inconsistent x=%.3f\n", x);
+    TEST_CHECK(fabsf(x) < 0.01f, "Inconsistent tangents fall back to linear");
+}
+
+static void test_snapshot_clock(void) {
+    printf("\n=== Test: Snapshot Clock Samples ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    /* No ping-pong messages: every snapshot echoes the newest input time */
+    run_steering_ticks(qk_net_client_get_id(), 32);
+    i32 rtt = qk_net_client_get_rtt();
+    i32 min_rtt_us = qk_net_client_get_min_rtt_us();
+    bool converged = qk_net_client_is_clock_converged();
+    printf("    [DEBUG] rtt=%d ms min_rtt=%d us converged=%d\n", rtt, min_rtt_us, converged);
+    TEST_CHECK(converged, "Clock converged from snapshot samples");
+    TEST_CHECK(min_rtt_us >= 0, "Snapshots echoed the client's input time");
+    TEST_CHECK(rtt >= 0 && rtt <= 2, "Loopback RTT from snapshot echoes is near zero");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+static void test_relay_broadcast(void) {
+    printf("\n=== Test: Spectator Relay ===\n");
+
+    const u16 server_port = 27991;
+    const u16 relay_port = 27992;
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.server_port = server_port;
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init (UDP)");
+    qk_net_server_set_map("assets/maps/relay_test.map");
+
+    qk_net_relay_config_t relay_cfg = {0};
+    relay_cfg.listen_port = relay_port;
+    res = qk_net_relay_init(&relay_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Relay init");
+    res = qk_net_relay_connect("127.0.0.1", server_port);
+    TEST_CHECK(res == QK_SUCCESS, "Relay connects upstream");
+
+    n_entity_state_t ent = {0};
+    ent.pos_x = (i16)(100.0f / 0.5f);
+    ent.entity_type = 2;
+    qk_net_server_set_entity(5, &ent);
+
+    qk_net_client_config_t cl_cfg = {0};
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Viewer init");
+
+    /* Server, relay and viewer share one loop; ~1 ms per iteration */
+    bool viewer_started = false;
+    bool map_sent = false;
+    qk_usercmd_t cmd = {0};
+    for (int i = 0; i < 1500 && !qk_net_client_is_map_ready(); i++) {
+        qk_net_server_tick();
+        qk_net_relay_tick();
+        if (!viewer_started && qk_net_relay_get_upstream_state() == QK_CONN_CONNECTED) {
+            qk_net_client_connect_remote("127.0.0.1", relay_port);
+            viewer_started = true;
+        }
+        qk_net_client_tick();
+        if (!map_sent && qk_net_client_get_server_map()) {
+            qk_net_client_notify_map_loaded(qk_net_client_get_server_map());
+            map_sent = true;
+        }
+        qk_platform_sleep(1);
+    }
+    TEST_CHECK(qk_net_client_is_map_ready(), "Viewer completes the handshake with the relay");
+
+    for (int i = 0; i < 64; i++) {
+        qk_net_server_tick();
+        qk_net_relay_tick();
+        qk_net_client_send_input(&cmd);
+        qk_net_client_tick();
+        qk_platform_sleep(1);
+    }
+
+    TEST_CHECK(qk_net_server_client_count() == 1, "Server sees only the relay");
+    TEST_CHECK(qk_net_server_is_client_relay(0), "Server slot is flagged as relay");
+    qk_usercmd_t srv_cmd;
+    TEST_CHECK(!qk_net_server_get_input(0, &srv_cmd), "Relay keepalives are not player input");
+
+    qk_net_relay_stats_t stats;
+    qk_net_relay_get_stats(&stats);
+    printf("    [DEBUG] viewers=%u tick=%u/%u encodes=%llu shared=%llu\n",
+           stats.viewer_count, stats.broadcast_tick, stats.upstream_tick,
+           (unsigned long long)stats.encodes, (unsigned long long)stats.encodes_shared);
+    TEST_CHECK(stats.viewer_count == 1, "Relay has one viewer");
+
+    qk_net_client_interpolate((f64)stats.broadcast_tick / 128.0);
+    const qk_interp_state_t *interp = qk_net_client_get_interp_state();
+    const qk_interp_entity_t *ie = &interp->entities[5];
+    printf("    [DEBUG] viewer entity 5: active=%d x=%.2f\n", ie->active, ie->pos_x);
+    TEST_CHECK(ie->active && fabsf(ie->pos_x - 100.0f) < 0.5f,
+               "Viewer sees the server's entity through the relay");
+
+    qk_net_client_shutdown();
+    qk_net_relay_shutdown();
+    qk_net_server_shutdown();
+}
+
+static void test_game_events(void) {
+    printf("\n=== Test: Game Event Stream ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    n_game_event_t sent[3] = {
+        { .type = N_GEVT_HIT, .data.hit = { .target = 1, .attacker = 0, .damage = 100 } },
+        { .type = N_GEVT_KILL, .data.kill = { .attacker = 0, .victim = 1, .weapon = QK_WEAPON_ROCKET } },
+        { .type = N_GEVT_EXPLOSION,
+          .data.explosion = { .pos = { 400, -128, 64 }, .dir = { 127, 0, 0 }, .radius = 120 } },
+    };
+    qk_net_server_push_events(sent, 3);
+    qk_net_server_tick();
+    qk_net_client_tick();
+
+    n_game_event_t got[256];
+    u32 count = qk_net_client_poll_events(got, 256);
+    TEST_CHECK(count == 3, "Three events arrive with the snapshot");
+    if (count == 3) {
+        TEST_CHECK(got[0].tick == qk_net_server_get_tick(), "Event stamped with its snapshot tick");
+        TEST_CHECK(got[0].type == N_GEVT_HIT && got[0].data.hit.damage == 100 &&
+                   got[0].data.hit.target == 1, "Hit fields survive the wire");
+        TEST_CHECK(got[1].type == N_GEVT_KILL && got[1].data.kill.victim == 1 &&
+                   got[1].data.kill.weapon == QK_WEAPON_ROCKET, "Kill fields survive the wire");
+        TEST_CHECK(got[2].type == N_GEVT_EXPLOSION && got[2].data.explosion.pos[1] == -128 &&
+                   got[2].data.explosion.radius == 120, "Explosion fields survive the wire");
+    }
+
+    /* Unacked: the next two snapshots both carry it; delivered once */
+    qk_net_server_push_events(sent, 1);
+    qk_net_server_tick();
+    qk_net_server_tick();
+    qk_net_client_tick();
+    count = qk_net_client_poll_events(got, 256);
+    TEST_CHECK(count == 1, "Redundant copies are delivered once");
+
+    /* Acked: nothing more is resent */
+    qk_net_server_tick();
+    qk_net_client_tick();
+    TEST_CHECK(qk_net_client_poll_events(got, 256) == 0, "Acked events are not resent");
+
+    /* A burst larger than one message drains over the following ticks */
+    for (int t = 0; t < 4; t++) {
+        for (int i = 0; i < 60; i++) {
+            n_game_event_t hit = { .type = N_GEVT_HIT,
+                                   .data.hit = { .target = 2, .damage = (i16)(t * 60 + i) } };
+            qk_net_server_push_events(&hit, 1);
+        }
+        qk_net_server_tick();
+    }
+    u32 total = 0;
+    bool in_order = true;
+    for (int t = 0; t < 8; t++) {
+        qk_net_client_tick();
+        qk_net_server_tick();
+        count = qk_net_client_poll_events(got, 256);
+        for (u32 i = 0; i < count; i++) {
+            if (got[i].data.hit.damage != (i16)(total + i)) in_order = false;
+        }
+        total += count;
+    }
+    printf("    [DEBUG] burst delivered=%u\n", total);
+    TEST_CHECK(total == 240, "Burst of 240 events fully delivered");
+    TEST_CHECK(in_order, "Burst delivered in order without duplicates");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+/* ---------- Test: Snapshot thinning ---------- */
+
+static void test_snapshot_thinning(void) {
+    printf("\n=== Test: Snapshot Thinning ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    cl_cfg.interp_delay = 0.0;
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    u8 cid = qk_net_client_get_id();
+    n_entity_state_t ent = { .entity_type = 1, .health = 100 };
+    qk_net_server_set_entity(0, &ent);
+    run_steering_ticks(cid, 16);
+
+    /* Every 4th tick only: deltas must use baselines the client actually got */
+    qk_net_server_set_client_low_priority(cid, true);
+    qk_net_server_set_low_priority_interval(4);
+    qk_usercmd_t cmd = {0};
+    for (int i = 0; i < 128; i++) {
+        ent.pos_x = (i16)(i * 4);
+        qk_net_server_set_entity(0, &ent);
+        qk_net_client_send_input(&cmd);
+        qk_net_server_tick();
+        qk_usercmd_t srv_cmd;
+        qk_net_server_get_input(cid, &srv_cmd);
+        qk_net_client_tick();
+    }
+
+    u32 tick = qk_net_server_get_tick();
+    qk_net_client_interpolate((f64)tick / 128.0);
+    const qk_interp_diag_t *diag = qk_net_client_get_interp_diag();
+    printf("    [DEBUG] server_tick=%u snap_a=%u snap_b=%u\n",
+           tick, diag->snap_a_tick, diag->snap_b_tick);
+    TEST_CHECK(diag->snap_b_tick % 4 == 0 && tick - diag->snap_b_tick < 4,
+               "Thinned client keeps up with every 4th snapshot");
+    TEST_CHECK(diag->snap_b_tick - diag->snap_a_tick == 4, "Snapshots arrive 4 ticks apart");
+
+    /* Back to full rate */
+    qk_net_server_set_low_priority_interval(1);
+    run_steering_ticks(cid, 3);
+    qk_net_client_interpolate((f64)qk_net_server_get_tick() / 128.0);
+    diag = qk_net_client_get_interp_diag();
+    TEST_CHECK(diag->snap_b_tick == qk_net_server_get_tick(), "Full rate resumes");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+/* ---------- Test: Direct local path ---------- */
+
+static void test_direct_local(void) {
+    printf("\n=== Test: Direct Local Path ===\n");
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init");
+
+    qk_net_client_config_t cl_cfg = {0};
+    cl_cfg.local_direct = true;
+    res = qk_net_client_init(&cl_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Client init");
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Connect local");
+
+    u8 cid = qk_net_client_get_id();
+
+    /* Inputs go straight into the server's queue */
+    qk_usercmd_t cmd = {0};
+    cmd.forward_move = 1.0f;
+    cmd.yaw = 90.0f;
+    cmd.buttons = QK_BUTTON_JUMP;
+    qk_net_client_send_input(&cmd);
+    qk_net_server_tick();
+    qk_usercmd_t out_cmd = {0};
+    bool got_input = qk_net_server_get_input(cid, &out_cmd);
+    TEST_CHECK(got_input && out_cmd.buttons == QK_BUTTON_JUMP &&
+               fabsf(out_cmd.yaw - 90.0f) < 0.1f, "Server got direct input");
+
+    /* Every tick's snapshot lands on the client's next tick, full precision */
+    n_entity_state_t ent = { .entity_type = 1, .health = 100 };
+    for (int i = 0; i < 32; i++) {
+        ent.pos_x = (i16)(i * 8);
+        qk_net_server_set_entity(0, &ent);
+        qk_net_client_send_input(&cmd);
+        qk_net_server_tick();
+        qk_net_server_get_input(cid, &out_cmd);
+        qk_net_client_tick();
+    }
+
+    u32 tick = qk_net_server_get_tick();
+    qk_net_client_interpolate((f64)tick / 128.0);
+    const qk_interp_diag_t *diag = qk_net_client_get_interp_diag();
+    const qk_interp_state_t *interp = qk_net_client_get_interp_state();
+    printf("    [DEBUG] server_tick=%u snap_a=%u snap_b=%u cmd_ack=%u pos_x=%.2f\n",
+           tick, diag->snap_a_tick, diag->snap_b_tick,
+           qk_net_client_get_server_cmd_ack(), interp->entities[0].pos_x);
+    TEST_CHECK(diag->snap_b_tick == tick && diag->snap_b_tick - diag->snap_a_tick == 1,
+               "Client holds every tick's snapshot");
+    TEST_CHECK(interp->entities[0].active && interp->entities[0].health == 100,
+               "Entity state copied");
+    TEST_CHECK(qk_net_client_get_server_cmd_ack() >= tick - 1, "Command ack carried");
+
+    /* Events: a burst bigger than one events message arrives at once */
+    for (int i = 0; i < 240; i++) {
+        n_game_event_t hit = { .type = N_GEVT_HIT, .data.hit = { .target = 2, .damage = (i16)i } };
+        qk_net_server_push_events(&hit, 1);
+    }
+    qk_net_server_tick();
+    qk_net_client_tick();
+
+    n_game_event_t got[256];
+    u32 count = qk_net_client_poll_events(got, 256);
+    bool in_order = true;
+    for (u32 i = 0; i < count; i++) {
+        if (got[i].data.hit.damage != (i16)i || got[i].tick != qk_net_server_get_tick()) {
+            in_order = false;
+        }
+    }
+    printf("    [DEBUG] burst delivered=%u\n", count);
+    TEST_CHECK(count == 240 && in_order, "Event burst delivered in one tick, in order");
+
+    qk_net_server_tick();
+    qk_net_client_tick();
+    TEST_CHECK(qk_net_client_poll_events(got, 256) == 0, "Events delivered once");
+
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+/* ---------- Test: Outgoing message queue ---------- */
+
+/* Parses a packed packet back into message types and lengths; returns the
+ * number of messages before the NOP terminator */
+static u32 read_packed_messages(const u8 *pkt, u32 size, n_msg_header_t *out, u32 max,
+                                const u8 **out_payloads) {
+    n_bitreader_t reader;
+    n_bitreader_init(&reader, pkt + N_PACKET_HEADER_SIZE, size - N_PACKET_HEADER_SIZE);
+    u32 count = 0;
+    n_msg_header_t hdr;
+    while (count < max && n_msg_header_read(&reader, &hdr) && hdr.type != N_MSG_NOP) {
+        out[count] = hdr;
+        /* Byte aligned: headers are 16 bits and payloads whole bytes */
+        out_payloads[count] = pkt + N_PACKET_HEADER_SIZE + (reader.bit_pos / 8);
+        for (u32 b = 0; b < hdr.length; b++) n_read_u8(&reader);
+        count++;
+    }
+    return count;
+}
+
+static bool payload_is(const u8 *payload, u16 len, u8 fill) {
+    for (u16 i = 0; i < len; i++) {
+        if (payload[i] != fill) return false;
+    }
+    return true;
+}
+
+static void test_msg_queue(void) {
+    printf("\n=== Test: Outgoing Message Queue ===\n");
+
+    static n_msg_queue_t queue;
+    static u8 payload[N_TRANSPORT_MTU];
+    static u8 pkt[N_TRANSPORT_MTU];
+    n_packet_header_t hdr = {0};
+    n_msg_header_t msgs[N_MSG_QUEUE_MAX];
+    const u8 *payloads[N_MSG_QUEUE_MAX];
+    u32 packed = 0;
+    memset(&queue, 0, sizeof(queue));
+
+    /* CONTROL goes first even when queued after STATE */
+    memset(payload, 0xA1, 16);
+    n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, 16);
+    memset(payload, 0xC1, 4);
+    n_msg_queue_push(&queue, N_MSG_MAP_CONFIRMED, N_MSG_PRIORITY_CONTROL, payload, 4);
+    u32 size = n_msg_queue_pack(&queue, &hdr, pkt, N_TRANSPORT_MTU, &packed);
+    u32 n = read_packed_messages(pkt, size, msgs, N_MSG_QUEUE_MAX, payloads);
+    printf("    [DEBUG] size=%u packed=%u parsed=%u\n", size, packed, n);
+    TEST_CHECK(packed == 2 && n == 2, "Both messages packed");
+    TEST_CHECK(n == 2 && msgs[0].type == N_MSG_MAP_CONFIRMED && msgs[1].type == N_MSG_SNAPSHOT,
+               "CONTROL packed before STATE");
+    TEST_CHECK(n == 2 && payload_is(payloads[0], 4, 0xC1) && payload_is(payloads[1], 16, 0xA1),
+               "Payloads intact");
+    TEST_CHECK(n_msg_queue_empty(&queue) && queue.bytes_used == 0, "Queue drained");
+
+    /* The middle message misses the MTU: the later one still fits around it,
+     * and the leftover moves to the front of the byte buffer */
+    memset(payload, 0x11, 600);
+    n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, 600);
+    memset(payload, 0x22, 900);
+    n_msg_queue_push(&queue, N_MSG_EVENTS, N_MSG_PRIORITY_STATE, payload, 900);
+    memset(payload, 0x33, 500);
+    n_msg_queue_push(&queue, N_MSG_INPUT, N_MSG_PRIORITY_STATE, payload, 500);
+    size = n_msg_queue_pack(&queue, &hdr, pkt, N_TRANSPORT_MTU, &packed);
+    n = read_packed_messages(pkt, size, msgs, N_MSG_QUEUE_MAX, payloads);
+    printf("    [DEBUG] size=%u packed=%u left=%u bytes=%u\n",
+           size, packed, queue.count, queue.bytes_used);
+    TEST_CHECK(size <= N_TRANSPORT_MTU, "Packet within the MTU");
+    TEST_CHECK(n == 2 && msgs[0].type == N_MSG_SNAPSHOT && msgs[1].type == N_MSG_INPUT,
+               "Messages that fit are packed in push order");
+    TEST_CHECK(queue.count == 1 && queue.bytes_used == 900 && queue.msgs[0].offset == 0 &&
+               queue.msgs[0].type == N_MSG_EVENTS, "Leftover compacted to the front");
+    TEST_CHECK(payload_is(queue.data, 900, 0x22), "Leftover payload moved intact");
+
+    size = n_msg_queue_pack(&queue, &hdr, pkt, N_TRANSPORT_MTU, &packed);
+    n = read_packed_messages(pkt, size, msgs, N_MSG_QUEUE_MAX, payloads);
+    TEST_CHECK(n == 1 && msgs[0].type == N_MSG_EVENTS && msgs[0].length == 900 &&
+               payload_is(payloads[0], 900, 0x22), "Leftover sent in the next packet");
+    TEST_CHECK(n_msg_queue_empty(&queue) && queue.dropped == 0, "Nothing dropped so far");
+
+    /* Larger than any packet: dropped and counted, never truncated */
+    u16 oversize = (u16)(N_TRANSPORT_MTU - N_PACKET_HEADER_SIZE - 1);
+    memset(payload, 0x44, oversize);
+    n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, oversize);
+    size = n_msg_queue_pack(&queue, &hdr, pkt, N_TRANSPORT_MTU, &packed);
+    printf("    [DEBUG] oversize: size=%u packed=%u dropped=%u\n", size, packed, queue.dropped);
+    TEST_CHECK(size == 0 && packed == 0, "Oversize message not sent");
+    TEST_CHECK(queue.dropped == 1 && n_msg_queue_empty(&queue), "Oversize message dropped and counted");
+
+    /* Full queue: pushes past N_MSG_QUEUE_MAX are refused and counted */
+    u32 accepted = 0;
+    for (u32 i = 0; i < N_MSG_QUEUE_MAX + 2; i++) {
+        if (n_msg_queue_push(&queue, N_MSG_INPUT, N_MSG_PRIORITY_STATE, payload, 8)) accepted++;
+    }
+    TEST_CHECK(accepted == N_MSG_QUEUE_MAX && queue.dropped == 3, "Full queue refuses and counts");
+    n_msg_queue_reset(&queue);
+
+    /* Byte buffer full: refused even with message slots free */
+    n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, 1300);
+    n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, 1300);
+    bool pushed = n_msg_queue_push(&queue, N_MSG_SNAPSHOT, N_MSG_PRIORITY_STATE, payload, 1300);
+    TEST_CHECK(!pushed && queue.count == 2 && queue.dropped == 4, "Full byte buffer refuses and counts");
+}
+
+/* ---------- Test: Server info query ---------- */
+
+static u32 poll_query_replies(qk_net_server_info_t *out_info) {
+    u32 replies = 0;
+    for (int i = 0; i < 50; i++) {
+        qk_net_server_tick();
+        while (qk_net_query_poll(out_info)) replies++;
+        qk_platform_sleep(1);
+    }
+    return replies;
+}
+
+static void test_server_query(void) {
+    printf("\n=== Test: Server Info Query ===\n");
+
+    const u16 server_port = 27993;
+
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.server_port = server_port;
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init (UDP)");
+    qk_net_server_set_map("campgrounds");
+    qk_net_server_tick();
+
+    res = qk_net_query_open("127.0.0.1", server_port);
+    TEST_CHECK(res == QK_SUCCESS, "Query socket open");
+
+    qk_net_server_info_t info = {0};
+    qk_net_query_send();
+    u32 replies = poll_query_replies(&info);
+    printf("    [DEBUG] replies=%u map=%s players=%u/%u rate=%u ping=%uus\n",
+           replies, info.map_name, (u32)info.players, (u32)info.max_clients,
+           (u32)info.tick_rate, info.ping_us);
+    TEST_CHECK(replies == 1, "One reply per query");
+    TEST_CHECK(strcmp(info.map_name, "campgrounds") == 0 && info.max_clients == 4 &&
+               info.tick_rate == 128, "Reply carries map, slots and tick rate");
+    TEST_CHECK(info.players == 0 && qk_net_server_client_count() == 0,
+               "Query takes no client slot");
+
+    /* A joined player shows up in the next reply */
+    qk_net_client_config_t cl_cfg = {0};
+    qk_net_client_init(&cl_cfg);
+    qk_net_client_connect_local();
+    qk_net_server_tick();
+    qk_net_query_send();
+    replies = poll_query_replies(&info);
+    TEST_CHECK(replies == 1 && info.players == 1, "Cached reply rebuilt after a join");
+
+    /* A flood from one source is cut to the per-source burst */
+    for (int i = 0; i < 16; i++) qk_net_query_send();
+    replies = poll_query_replies(&info);
+    printf("    [DEBUG] flood: 16 sent, %u answered\n", replies);
+    TEST_CHECK(replies >= 4 && replies <= 8, "Flood limited per source");
+
+    qk_net_query_close();
+    qk_net_client_shutdown();
+    qk_net_server_shutdown();
+}
+
+/* ---------- Test: Query limit collision ---------- */
+
+static void test_query_limit_collision(void) {
+    printf("\n=== Test: Query Limit Collision ===\n");
+
+    static n_info_limit_t limits[N_INFO_LIMIT_SLOTS];
+    memset(limits, 0, sizeof(limits));
+
+    /* 127.0.0.1 and 127.0.0.61 land in the same slot */
+    const u32 ip_a = 0x7F000001u;
+    const u32 ip_b = 0x7F00003Du;
+    f64 now = 10.0;
+
+    u32 allowed_a = 0;
+    for (int i = 0; i < 16; i++) {
+        if (n_server_info_query_allowed(limits, ip_a, now)) allowed_a++;
+    }
+    /* Alternating sources must not reset each other's bucket to a full burst */
+    u32 allowed_b = 0;
+    for (int i = 0; i < 16; i++) {
+        if (n_server_info_query_allowed(limits, (i & 1) ? ip_a : ip_b, now)) allowed_b++;
+    }
+    printf("    [DEBUG] a=%u then alternating=%u\n", allowed_a, allowed_b);
+    TEST_CHECK(allowed_a == (u32)N_INFO_QUERY_BURST, "First source gets its burst");
+    TEST_CHECK(allowed_b == 0, "Colliding source shares the drained bucket");
+
+    /* Once idle for a full refill, the other source takes the slot over */
+    now += N_INFO_QUERY_BURST / N_INFO_QUERY_RATE;
+    TEST_CHECK(n_server_info_query_allowed(limits, ip_b, now), "Idle slot handed to the other source");
+    TEST_CHECK(n_server_info_query_allowed(limits, 0x7F000002u, now), "Other slots keep their own budget");
+}
+
+/* ---------- Test: Relay on a listen server ---------- */
+
+static void test_relay_listen_server(void) {
+    printf("\n=== Test: Relay on a Listen Server ===\n");
+
+    const u16 server_port = 27994;
+
+    /* Listen-style: UDP server plus an in-process client on loopback */
+    qk_net_server_config_t srv_cfg = {0};
+    srv_cfg.server_port = server_port;
+    srv_cfg.max_clients = 4;
+    qk_result_t res = qk_net_server_init(&srv_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Server init (UDP)");
+    qk_net_server_set_map("assets/maps/relay_test.map");
+
+    qk_net_client_config_t cl_cfg = {0};
+    qk_net_client_init(&cl_cfg);
+    res = qk_net_client_connect_local();
+    TEST_CHECK(res == QK_SUCCESS, "Local client connects");
+
+    qk_net_relay_config_t relay_cfg = {0};
+    relay_cfg.listen_port = (u16)(server_port + 1);
+    res = qk_net_relay_init(&relay_cfg);
+    TEST_CHECK(res == QK_SUCCESS, "Relay init");
+    qk_net_relay_connect("127.0.0.1", server_port);
+
+    bool map_sent = false;
+    i32 relay_slot = -1;
+    for (int i = 0; i < 1500; i++) {
+        qk_net_server_tick();
+        qk_net_relay_tick();
+        qk_net_client_tick();
+        if (!map_sent && qk_net_client_get_server_map()) {
+            qk_net_client_notify_map_loaded(qk_net_client_get_server_map());
+            map_sent = true;
+        }
+        for (u8 slot = 0; slot < 4; slot++) {
+            if (qk_net_server_is_client_relay(slot) && qk_net_server_is_client_map_ready(slot)) {
+                relay_slot = slot;
+            }
+        }
+        if (relay_slot >= 0 && qk_net_client_is_map_ready()) break;
+        qk_platform_sleep(1);
+    }
+    TEST_CHECK(relay_slot >= 0, "Relay slot reaches map-ready");
+    TEST_CHECK(qk_net_client_is_map_ready(), "Local client reaches map-ready");
+
+    /* The check both server loops use to create players */
+    u32 players = 0;
+    for (u8 slot = 0; slot < 4; slot++) {
+        if (qk_net_server_is_client_player(slot)) players++;
+    }
+    printf("    [DEBUG] relay_slot=%d players=%u clients=%u\n",
+           relay_slot, players, qk_net_server_client_count());
+    TEST_CHECK(relay_slot >= 0 && !qk_net_server_is_client_player((u8)relay_slot),
+               "Relay slot gets no player");
+    TEST_CHECK(players == 1 && qk_net_server_is_client_player(qk_net_client_get_id()),
+               "Only the local client is a player");
+
+    qk_net_client_shutdown();
+    qk_net_relay_shutdown();
+    qk_net_server_shutdown();
+}
+
 /* ---------- Main ---------- */
 
 int main(int argc, char **argv) {
@@ -545,6 +1337,18 @@ int main(int argc, char **argv) {
     test_disconnect_reconnect();
     test_full_game_loop();
     test_early_frame_interpolation();
+    test_input_buffer_steering();
+    test_underrun_extrapolation();
+    test_hermite_interpolation();
+    test_snapshot_clock();
+    test_relay_broadcast();
+    test_game_events();
+    test_snapshot_thinning();
+    test_direct_local();
+    test_server_query();
+    test_msg_queue();
+    test_query_limit_collision();
+    test_relay_listen_server();
 
     printf("\n==============================\n");
     printf("Results: %d passed, %d failed\n", s_tests_passed, s_tests_failed);